@@ -278,6 +278,11 @@ namespace orc {
     // Only include the BLOOM_FILTER_UTF8 streams that consistently use UTF8.
     // See ORC-101
     UTF8 = 1,
+    // Like UTF8, but the filters are split into 256-bit blocks and each value
+    // sets 8 bits in a single block, so that a lookup touches one cache line.
+    // Other readers would take them for UTF8 filters, so they are only
+    // written to files of version UNSTABLE-PRE-2.0; other files get UTF8.
+    SPLIT_BLOCK = 2,
     FUTURE = INT32_MAX
   };
 
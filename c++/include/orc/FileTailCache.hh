@@ -0,0 +1,79 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_FILETAILCACHE_HH
+#define ORC_FILETAILCACHE_HH
+
+#include "orc/orc-config.hh"
+
+#include <cstdint>
+#include <memory>
+#include <string>
+
+namespace orc {
+
+  /**
+   * The parsed postscript, footer and, once a reader has loaded them, the
+   * stripe statistics of a file. Its content is only known to the reader.
+   */
+  class CachedFileTail {
+   public:
+    virtual ~CachedFileTail();
+
+    /**
+     * Get the approximate memory used by the tail in bytes. It may grow
+     * while the tail is cached, e.g. as statistics are decoded, so it must
+     * be thread-safe.
+     */
+    virtual uint64_t getMemoryUsage() const = 0;
+  };
+
+  /**
+   * A cache of file tails shared by the readers of many files, so that
+   * opening a file again neither reads nor parses its tail.
+   *
+   * Keys are built by the reader from the file name, the file length and
+   * the token passed to ReaderOptions::setFileTailCache(). Implementations
+   * must be thread-safe.
+   */
+  class FileTailCache {
+   public:
+    virtual ~FileTailCache();
+
+    /**
+     * Look up the tail of a file.
+     * @return nullptr if the tail isn't cached
+     */
+    virtual std::shared_ptr<const CachedFileTail> get(const std::string& key) = 0;
+
+    /**
+     * Add the tail of a file, replacing any tail with the same key.
+     */
+    virtual void put(const std::string& key, std::shared_ptr<const CachedFileTail> tail) = 0;
+  };
+
+  /**
+   * Create a cache that evicts the least recently used tails once their
+   * memory usage exceeds maxMemory bytes. The tails are measured again
+   * whenever one is looked up or added.
+   */
+  std::shared_ptr<FileTailCache> createFileTailCache(uint64_t maxMemory);
+
+}  // namespace orc
+
+#endif
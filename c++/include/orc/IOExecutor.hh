@@ -0,0 +1,87 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_IOEXECUTOR_HH
+#define ORC_IOEXECUTOR_HH
+
+#include "orc/orc-config.hh"
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+
+namespace orc {
+
+  struct ReaderMetrics;
+
+  struct IOExecutorOptions {
+    // The number of worker threads
+    uint32_t numThreads = 8;
+
+    // The maximum number of tasks waiting for a worker; submit() blocks
+    // while the queue is full
+    uint64_t maxQueueSize = 1024;
+  };
+
+  /**
+   * A bounded pool of threads that runs blocking I/O tasks.
+   *
+   * Tasks are queued per client and clients are served round-robin, so a
+   * reader that prefetches many ranges at once can't starve other readers
+   * sharing the same executor.
+   */
+  class IOExecutor {
+   public:
+    virtual ~IOExecutor();
+
+    /**
+     * Queue a task for execution.
+     * @param client identifies the submitter for fair scheduling, typically
+     *        the InputStream issuing the read
+     * @param task the task to run
+     * @param metrics if not null, the time the task waits in the queue is
+     *        added to its IOQueueWaitLatencyUs
+     * @return a future that is set when the task completes and holds any
+     *         exception thrown by the task
+     */
+    virtual std::future<void> submit(const void* client, std::function<void()> task,
+                                     ReaderMetrics* metrics = nullptr) = 0;
+  };
+
+  /**
+   * Create an executor with its own threads.
+   */
+  std::unique_ptr<IOExecutor> createIOExecutor(const IOExecutorOptions& options);
+
+  /**
+   * Set the options of the process-wide executor. It must be called before
+   * the first call to getDefaultIOExecutor(); otherwise std::logic_error is
+   * thrown.
+   */
+  void setDefaultIOExecutorOptions(const IOExecutorOptions& options);
+
+  /**
+   * Get the process-wide executor used by asynchronous reads unless an
+   * InputStream provides its own.
+   */
+  IOExecutor* getDefaultIOExecutor();
+
+}  // namespace orc
+
+#endif
@@ -22,6 +22,7 @@
 #include <future>
 #include <string>
 
+#include "orc/IOExecutor.hh"
 #include "orc/Reader.hh"
 #include "orc/Writer.hh"
 #include "orc/orc-config.hh"
@@ -64,12 +65,30 @@ namespace orc {
      * @param buf the buffer to read into
      * @param length the number of bytes to read.
      * @param offset the position in the stream to read from.
+     * @param metrics the metrics of the reader issuing the read, may be null
      * @return a future that will be set when the read is complete.
+     *
+     * The default implementation runs read() on the process-wide IOExecutor
+     * and records its latency in metrics like a synchronous read.
      */
-    virtual std::future<void> readAsync(void* buf, uint64_t length, uint64_t offset) {
-      return std::async(std::launch::async,
-                        [this, buf, length, offset] { this->read(buf, length, offset); });
-    }
+    virtual std::future<void> readAsync(void* buf, uint64_t length, uint64_t offset,
+                                        ReaderMetrics* metrics = nullptr);
+
+    /**
+     * Get the contents of the stream if they are addressable in memory, for
+     * example because the file is memory-mapped. The memory must stay valid
+     * and unchanged for the lifetime of the stream. The reader then uses it
+     * in place instead of copying it into its own buffers.
+     * @return the start of the stream or nullptr if it isn't mapped
+     */
+    virtual const char* getMappedData() const;
+
+    /**
+     * Hint that the given range of a mapped stream will be read soon.
+     * @param offset the position in the stream
+     * @param length the number of bytes
+     */
+    virtual void adviseWillNeed(uint64_t offset, uint64_t length);
 
     /**
      * Get the name of the stream for error messages.
@@ -120,6 +139,36 @@ namespace orc {
     }
   };
 
+  /**
+   * How a local file stream services InputStream::readAsync().
+   */
+  enum class LocalFileAsyncMode {
+    // Run blocking reads on LocalFileOptions::executor.
+    DEFAULT = 0,
+    // Submit reads to a per-stream io_uring instance. Falls back to
+    // DEFAULT when io_uring is not supported by the build or the kernel.
+    IO_URING = 1
+  };
+
+  struct LocalFileOptions {
+    LocalFileAsyncMode asyncMode = LocalFileAsyncMode::IO_URING;
+
+    // The number of submission queue entries of the io_uring instance, which
+    // also bounds the number of reads in flight
+    uint32_t queueDepth = 64;
+
+    // The executor that runs blocking reads; nullptr means the process-wide
+    // one returned by getDefaultIOExecutor()
+    IOExecutor* executor = nullptr;
+
+    // Map the file into memory so that the reader uses its bytes in place.
+    // Prefetching then only advises the kernel to page in the ranges of the
+    // selected columns. String values of uncompressed files point into the
+    // mapping, so row batches must not outlive the stream. Falls back to
+    // reads if the file can't be mapped.
+    bool memoryMap = false;
+  };
+
   /**
    * Create a stream to a local file or HDFS file if path begins with "hdfs://"
    * @param path the name of the file in the local file system or HDFS
@@ -135,6 +184,16 @@ namespace orc {
   std::unique_ptr<InputStream> readLocalFile(const std::string& path,
                                              ReaderMetrics* metrics = nullptr);
 
+  /**
+   * Create a stream to a local file whose asynchronous reads are serviced
+   * as configured by the given options.
+   * @param path the name of the file in the local file system
+   * @param metrics the metrics of the reader
+   * @param options the options of asynchronous reads
+   */
+  std::unique_ptr<InputStream> readLocalFile(const std::string& path, ReaderMetrics* metrics,
+                                             const LocalFileOptions& options);
+
   /**
    * Create a reader to read the ORC file.
    * @param stream the stream to read
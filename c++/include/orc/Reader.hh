@@ -21,6 +21,7 @@
 
 #include "orc/BloomFilter.hh"
 #include "orc/Common.hh"
+#include "orc/FileTailCache.hh"
 #include "orc/Statistics.hh"
 #include "orc/Type.hh"
 #include "orc/Vector.hh"
@@ -28,6 +29,7 @@
 #include "orc/sargs/SearchArgument.hh"
 
 #include <atomic>
+#include <functional>
 #include <map>
 #include <memory>
 #include <set>
@@ -73,6 +75,14 @@ namespace orc {
     std::atomic<uint64_t> EvaluatedRowGroupCount{0};
     std::atomic<uint64_t> ReadRangeCacheHits{0};
     std::atomic<uint64_t> ReadRangeCacheMisses{0};
+    // IOQueueWaitLatencyUs contains the time reads spent waiting for
+    // an IOExecutor thread.
+    std::atomic<uint64_t> IOQueueWaitCount{0};
+    std::atomic<uint64_t> IOQueueWaitLatencyUs{0};
+    std::atomic<uint64_t> FileTailCacheHits{0};
+    std::atomic<uint64_t> FileTailCacheMisses{0};
+    std::atomic<uint64_t> IndexCacheHits{0};
+    std::atomic<uint64_t> IndexCacheMisses{0};
   };
   ReaderMetrics* getDefaultReaderMetrics();
 
@@ -141,6 +151,27 @@ namespace orc {
      */
     ReaderOptions& setTailLocation(uint64_t offset);
 
+    /**
+     * Set a cache to look the file tail up in before reading it, and to add
+     * it to after reading it. It is ignored if a serialized file tail is set.
+     *
+     * @param cache the cache, which may be shared by many readers
+     * @param token identifies the version of the file, e.g. its modification
+     *        time, in addition to its name and length
+     */
+    ReaderOptions& setFileTailCache(std::shared_ptr<FileTailCache> cache,
+                                    const std::string& token = "");
+
+    /**
+     * Set the memory available to cache the parsed row indexes and bloom
+     * filters of stripes. The cache is shared by all row readers of the
+     * reader, so repeated lookups against the same stripes neither read nor
+     * parse the index streams again.
+     *
+     * Defaults to 0, which disables the cache.
+     */
+    ReaderOptions& setIndexCacheMemory(uint64_t maxMemory);
+
     /**
      * Get the stream to write warnings or errors to.
      */
@@ -157,6 +188,22 @@ namespace orc {
      */
     uint64_t getTailLocation() const;
 
+    /**
+     * Get the file tail cache.
+     * @return if not set, return nullptr.
+     */
+    std::shared_ptr<FileTailCache> getFileTailCache() const;
+
+    /**
+     * Get the token identifying the version of the file in the file tail cache.
+     */
+    const std::string& getFileTailCacheToken() const;
+
+    /**
+     * Get the memory available to the index cache.
+     */
+    uint64_t getIndexCacheMemory() const;
+
     /**
      * Get the memory allocator.
      */
@@ -410,6 +457,20 @@ namespace orc {
      */
     uint64_t getSmallStripeLookAheadLimit() const;
 
+    /**
+     * Set the number of bytes of upcoming stripes to keep in flight when async
+     * prefetch is enabled. The selected columns of as many stripes as fit in
+     * the window are requested ahead of the reader and released once it moves
+     * past them. When set, it replaces the small stripe look ahead.
+     * Defaults to 0, which only prefetches the current stripe.
+     */
+    RowReaderOptions& setPrefetchWindowSize(uint64_t bytes);
+
+    /**
+     * Get the number of bytes of upcoming stripes to keep in flight.
+     */
+    uint64_t getPrefetchWindowSize() const;
+
     /**
      * Set the maximum dictionary size threshold for evaluation.
      *
@@ -424,9 +485,73 @@ namespace orc {
      * Get the dictionary filtering size threshold.
      */
     uint32_t getDictionaryFilteringSizeThreshold() const;
+
+    /**
+     * Set the number of threads that decode the top-level columns of a
+     * batch concurrently. Each column is always decoded by the same thread.
+     * It pays off for wide schemas; the memory pool must be thread safe.
+     *
+     * Defaults to 1, which decodes on the calling thread.
+     */
+    RowReaderOptions& setDecodeThreads(uint32_t numThreads);
+
+    /**
+     * Get the number of threads that decode the top-level columns.
+     */
+    uint32_t getDecodeThreads() const;
+
+    /**
+     * A filter on the rows of a batch. It is called with the batch once the
+     * filter columns are read, while the other columns are not read yet, and
+     * clears selected[i] for every row i to drop. selected has
+     * batch.numElements entries, which are all set on entry.
+     */
+    typedef std::function<void(const ColumnVectorBatch& batch, char* selected)> RowFilter;
+
+    /**
+     * Filter rows before the other columns are read. The filter columns of
+     * each batch are read first and the remaining columns are only read for
+     * the rows selected by the filter; the other rows are skipped.
+     *
+     * Batches returned by the RowReader only hold the selected rows, so their
+     * rows are not contiguous; getRowNumber() still returns the number of the
+     * first row read for the batch.
+     * @param columns the names of the top-level fields the filter reads;
+     *        they must be selected
+     * @param filter the filter
+     * @return this
+     */
+    RowReaderOptions& setRowFilter(const std::list<std::string>& columns, RowFilter filter);
+
+    /**
+     * Get the row filter.
+     */
+    const RowFilter& getRowFilter() const;
+
+    /**
+     * Get the names of the fields the row filter reads.
+     */
+    const std::list<std::string>& getRowFilterColumns() const;
+
+    /**
+     * Evaluate the search argument on the rows of each batch and drop the
+     * rows for which it is not true, in addition to skipping row groups.
+     * The top-level fields the predicate leaves name are read first, as
+     * with setRowFilter(), and combined with the row filter if both are
+     * set. Leaves on nested or unselected columns don't drop any rows.
+     * Default: false
+     * @return this
+     */
+    RowReaderOptions& setFilterRowsBySearchArgument(bool filter);
+
+    /**
+     * Get whether the search argument is evaluated on rows.
+     */
+    bool getFilterRowsBySearchArgument() const;
   };
 
   class RowReader;
+  class ParallelScan;
 
   /**
    * The interface for reading ORC file meta-data and constructing RowReaders.
@@ -622,6 +747,18 @@ namespace orc {
      */
     virtual std::unique_ptr<RowReader> createRowReader(const RowReaderOptions& options) const = 0;
 
+    /**
+     * Create a scan that reads the stripes selected by the options on
+     * several threads at once. The threads share the parsed file tail, the
+     * search argument and the read cache of this reader.
+     * @param options RowReader Options
+     * @param numThreads the number of threads to read with; 0 uses the
+     *        number of hardware threads
+     * @return a ParallelScan to read the rows
+     */
+    virtual std::unique_ptr<ParallelScan> createParallelScan(const RowReaderOptions& options,
+                                                             uint32_t numThreads) const = 0;
+
     /**
      * Get the name of the input stream.
      */
@@ -765,6 +902,37 @@ namespace orc {
      */
     virtual void seekToRow(uint64_t rowNumber) = 0;
   };
+
+  /**
+   * The interface for reading the rows of an ORC file on several threads.
+   * Neighboring stripes are handed out to the same thread, and a thread that
+   * runs out of stripes takes over the remaining ones of another thread.
+   */
+  class ParallelScan {
+   public:
+    /**
+     * Receives a batch and the row number of its first row. The batch is
+     * only valid until the consumer returns.
+     */
+    typedef std::function<void(ColumnVectorBatch& batch, uint64_t rowNumber)> Consumer;
+
+    virtual ~ParallelScan();
+
+    /**
+     * Get the selected type of the rows in the file.
+     */
+    virtual const Type& getSelectedType() const = 0;
+
+    /**
+     * Read all selected rows. The consumer is called concurrently from the
+     * reading threads; the batches of a stripe are passed in order by the
+     * same thread. It returns once all stripes are read and rethrows the
+     * first exception thrown by a thread or the consumer.
+     * @param batchSize the number of rows of each batch
+     * @param consumer the callback for each batch
+     */
+    virtual void run(uint64_t batchSize, const Consumer& consumer) = 0;
+  };
 }  // namespace orc
 
 #endif
@@ -39,6 +39,20 @@ namespace orc {
 
   enum RleVersion { RleVersion_1 = 0, RleVersion_2 = 1 };
 
+  /**
+   * How the streams of a column are compressed when it differs from the rest
+   * of the file. ORC records a single codec per file, so a column can only
+   * choose another level of that codec or store its streams uncompressed.
+   */
+  struct ColumnCompression {
+    // store the streams as uncompressed chunks, which every reader supports
+    bool uncompressed = false;
+    // the level of the file's codec, or 0 for the level of the compression
+    // strategy: 1 to 9 for ZLIB, 1 to 22 (or negative for faster levels) for
+    // ZSTD and the acceleration for LZ4. SNAPPY has no levels.
+    int level = 0;
+  };
+
   class Timezone;
 
   /**
@@ -220,6 +234,15 @@ namespace orc {
      */
     double getBloomFilterFPP() const;
 
+    /**
+     * Set version of BloomFilter, either UTF8 or SPLIT_BLOCK.
+     * SPLIT_BLOCK only applies to files of version UNSTABLE-PRE-2.0, as other
+     * readers can't tell its filters apart from UTF8 ones; other files get
+     * UTF8 filters.
+     * Default is UTF8
+     */
+    WriterOptions& setBloomFilterVersion(BloomFilterVersion version);
+
     /**
      * Get version of BloomFilter
      */
@@ -303,6 +326,62 @@ namespace orc {
      * @return if not set, return default value which is false.
      */
     bool getAlignBlockBoundToRowGroup() const;
+
+    /**
+     * Set the number of threads that compress full compression blocks while
+     * the calling thread keeps encoding. The blocks of a stream are written
+     * in order once compressed, so the file is the same as with a single
+     * thread. A stream waits for its pending blocks when a row index entry
+     * is recorded, so wide schemas and large row index strides benefit most.
+     *
+     * Defaults to 1, which compresses on the calling thread.
+     */
+    WriterOptions& setCompressionThreads(uint32_t numThreads);
+
+    /**
+     * Get the number of threads that compress blocks.
+     */
+    uint32_t getCompressionThreads() const;
+
+    /**
+     * Set the number of full stripes that a background thread may still be
+     * writing while the caller keeps adding rows. Each of them keeps its own
+     * set of column writers and buffers, so memory grows with the number.
+     * Stripes are written to the output stream by the background thread and
+     * the memory pool is used from both threads, so it must be thread safe.
+     *
+     * Defaults to 0, which writes every stripe on the calling thread.
+     */
+    WriterOptions& setMaxPendingStripes(uint32_t numStripes);
+
+    /**
+     * Get the number of full stripes that may be written in the background.
+     */
+    uint32_t getMaxPendingStripes() const;
+
+    /**
+     * Set how the streams of a column are compressed instead of using the
+     * compression strategy, e.g. to store incompressible ids uncompressed and
+     * spend a higher level on repetitive strings. It has no effect when the
+     * compression kind is NONE.
+     * @param column the column id
+     * @param compression the compression of all streams of the column
+     */
+    WriterOptions& setColumnCompression(uint64_t column, const ColumnCompression& compression);
+
+    /**
+     * Set how one kind of stream of a column is compressed. It takes
+     * precedence over the compression set for the whole column.
+     */
+    WriterOptions& setColumnCompression(uint64_t column, StreamKind kind,
+                                        const ColumnCompression& compression);
+
+    /**
+     * Get how a stream of a column is compressed.
+     * @return the default ColumnCompression if nothing was set for the stream
+     * or its column
+     */
+    ColumnCompression getColumnCompression(uint64_t column, StreamKind kind) const;
   };
 
   class Writer {
@@ -17,6 +17,8 @@
  */
 
 #include "BloomFilter.hh"
+#include "BloomFilterKernels.hh"
+#include "Dispatch.hh"
 #include "Murmur3.hh"
 
 namespace orc {
@@ -103,6 +105,69 @@ namespace orc {
     return static_cast<int32_t>(-n * std::log(fpp) / (std::log(2.0) * std::log(2.0)));
   }
 
+  // The expected fpp of a split-block filter whose blocks hold
+  // entriesPerBlock entries on average. The entries of a block follow a
+  // Poisson distribution, and a block holding i entries reports a false
+  // positive if each of its words has the probed bit set.
+  double splitBlockFpp(double entriesPerBlock) {
+    const double bitsPerWord = static_cast<double>(SPLIT_BLOCK_BITS / SPLIT_BLOCK_WORDS);
+    double spread = 12 * std::sqrt(entriesPerBlock) + 20;
+    uint64_t first = static_cast<uint64_t>(std::max(0.0, entriesPerBlock - spread));
+    uint64_t last = static_cast<uint64_t>(entriesPerBlock + spread);
+    double fpp = 0;
+    for (uint64_t i = first; i <= last; ++i) {
+      double entries = static_cast<double>(i);
+      double probability = std::exp(-entriesPerBlock + entries * std::log(entriesPerBlock) -
+                                    std::lgamma(entries + 1));
+      double wordFpp = 1.0 - std::pow(1.0 - 1.0 / bitsPerWord, entries);
+      fpp += probability * std::pow(wordFpp, SPLIT_BLOCK_WORDS);
+    }
+    return fpp;
+  }
+
+  // A split-block filter needs more bits than a classic one for the same
+  // fpp, as the blocks don't fill up evenly. The formula of the Parquet
+  // split-block bloom filter ignores that, so it is only the starting point
+  // of a search for the fewest blocks that reach the fpp.
+  uint64_t optimalNumOfSplitBlockBits(uint64_t expectedEntries, double fpp) {
+    double n = static_cast<double>(expectedEntries);
+    double bits = -static_cast<double>(SPLIT_BLOCK_WORDS) * n /
+                  std::log(1.0 - std::pow(fpp, 1.0 / SPLIT_BLOCK_WORDS));
+    uint64_t low = std::max<uint64_t>(static_cast<uint64_t>(bits / SPLIT_BLOCK_BITS), 1);
+    uint64_t high = low;
+    while (splitBlockFpp(n / static_cast<double>(high)) > fpp) {
+      low = high + 1;
+      high *= 2;
+    }
+    while (low < high) {
+      uint64_t middle = low + (high - low) / 2;
+      if (splitBlockFpp(n / static_cast<double>(middle)) > fpp) {
+        low = middle + 1;
+      } else {
+        high = middle;
+      }
+    }
+    return high * SPLIT_BLOCK_BITS;
+  }
+
+  struct SplitBlockTestDynamicFunction {
+    using FunctionType = decltype(&SplitBlockDefault::testBlock);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      std::vector<std::pair<DispatchLevel, FunctionType>> impls = {
+          {DispatchLevel::NONE, SplitBlockDefault::testBlock}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      impls.emplace_back(DispatchLevel::AVX2, SplitBlockAVX2::testBlock);
+#endif
+      return impls;
+    }
+  };
+
+  static SplitBlockTestDynamicFunction::FunctionType getSplitBlockTest() {
+    static DynamicDispatch<SplitBlockTestDynamicFunction> dispatch;
+    return dispatch.get();
+  }
+
   // We use the trick mentioned in "Less Hashing, Same Performance:
   // Building a Better Bloom Filter" by Kirsch et.al. From abstract
   // 'only two hash functions are necessary to effectively implement
@@ -121,14 +186,20 @@ namespace orc {
   /**
    * Implementation of BloomFilter
    */
-  BloomFilterImpl::BloomFilterImpl(uint64_t expectedEntries, double fpp) {
+  BloomFilterImpl::BloomFilterImpl(uint64_t expectedEntries, double fpp, BloomFilterVersion version)
+      : splitBlock_(version == BloomFilterVersion::SPLIT_BLOCK) {
     checkArgument(expectedEntries > 0, "expectedEntries should be > 0");
     checkArgument(fpp > 0.0 && fpp < 1.0, "False positive probability should be > 0.0 & < 1.0");
 
-    uint64_t nb = static_cast<uint64_t>(optimalNumOfBits(expectedEntries, fpp));
-    // make 'mNumBits' multiple of 64
-    numBits_ = nb + (BITS_OF_LONG - (nb % BITS_OF_LONG));
-    numHashFunctions_ = optimalNumOfHashFunctions(expectedEntries, numBits_);
+    if (splitBlock_) {
+      numBits_ = optimalNumOfSplitBlockBits(expectedEntries, fpp);
+      numHashFunctions_ = static_cast<int32_t>(SPLIT_BLOCK_WORDS);
+    } else {
+      uint64_t nb = static_cast<uint64_t>(optimalNumOfBits(expectedEntries, fpp));
+      // make 'mNumBits' multiple of 64
+      numBits_ = nb + (BITS_OF_LONG - (nb % BITS_OF_LONG));
+      numHashFunctions_ = optimalNumOfHashFunctions(expectedEntries, numBits_);
+    }
     bitSet_.reset(new BitSet(numBits_));
   }
 
@@ -150,6 +221,23 @@ namespace orc {
     return testHash(getLongHash(data));
   }
 
+  bool BloomFilterImpl::testAnyHash(const int64_t* hashes, size_t numHashes) const {
+    for (size_t i = 0; i != numHashes; ++i) {
+      if (testHash(hashes[i])) {
+        return true;
+      }
+    }
+    return false;
+  }
+
+  int64_t BloomFilterImpl::hashBytes(const char* data, int64_t length) {
+    return static_cast<int64_t>(getBytesHash(data, length));
+  }
+
+  int64_t BloomFilterImpl::hashLong(int64_t data) {
+    return getLongHash(data);
+  }
+
   uint64_t BloomFilterImpl::sizeInBytes() const {
     return getBitSize() >> SHIFT_3_BITS;
   }
@@ -162,6 +250,17 @@ namespace orc {
     return numHashFunctions_;
   }
 
+  BloomFilterVersion BloomFilterImpl::getVersion() const {
+    return splitBlock_ ? BloomFilterVersion::SPLIT_BLOCK : BloomFilterVersion::UTF8;
+  }
+
+  uint64_t BloomFilterImpl::getBlockOffset(int64_t hash64) const {
+    // the upper 32 bits scaled to the number of blocks
+    uint64_t numBlocks = numBits_ / SPLIT_BLOCK_BITS;
+    uint64_t block = ((static_cast<uint64_t>(hash64) >> 32) * numBlocks) >> 32;
+    return block * (SPLIT_BLOCK_BITS / BITS_OF_LONG);
+  }
+
   DIAGNOSTIC_PUSH
 
 #if defined(__clang__)
@@ -174,12 +273,19 @@ namespace orc {
 
   // caller should make sure input proto::BloomFilter is valid since
   // no check will be performed in the following constructor
-  BloomFilterImpl::BloomFilterImpl(const proto::BloomFilter& bloomFilter) {
+  BloomFilterImpl::BloomFilterImpl(const proto::BloomFilter& bloomFilter,
+                                   BloomFilterVersion version)
+      : splitBlock_(version == BloomFilterVersion::SPLIT_BLOCK) {
     numHashFunctions_ = static_cast<int32_t>(bloomFilter.num_hash_functions());
 
     const std::string& bitsetStr = bloomFilter.utf8bitset();
     numBits_ = bitsetStr.size() << SHIFT_3_BITS;
     checkArgument(numBits_ % BITS_OF_LONG == 0, "numBits should be multiple of 64!");
+    if (splitBlock_) {
+      checkArgument(numBits_ > 0 && numBits_ % SPLIT_BLOCK_BITS == 0,
+                    "numBits should be a positive multiple of 256!");
+      numHashFunctions_ = static_cast<int32_t>(SPLIT_BLOCK_WORDS);
+    }
 
     const uint64_t* bitset = reinterpret_cast<const uint64_t*>(bitsetStr.data());
     if (isLittleEndian()) {
@@ -207,9 +313,22 @@ namespace orc {
     return testLong(reinterpret_cast<int64_t&>(data));
   }
 
+  int64_t BloomFilterImpl::hashDouble(double data) {
+    return hashLong(reinterpret_cast<int64_t&>(data));
+  }
+
   DIAGNOSTIC_POP
   NO_SANITIZE_ATTR
   void BloomFilterImpl::addHash(int64_t hash64) {
+    if (splitBlock_) {
+      uint64_t firstBit = getBlockOffset(hash64) * BITS_OF_LONG;
+      uint32_t key = static_cast<uint32_t>(hash64);
+      for (uint32_t w = 0; w < SPLIT_BLOCK_WORDS; ++w) {
+        bitSet_->set(firstBit + w * 32 + splitBlockBit(key, w));
+      }
+      return;
+    }
+
     int32_t hash1 = static_cast<int32_t>(hash64 & 0xffffffff);
     // In Java codes, we use "hash64 >>> 32" which is an unsigned shift op.
     // So we cast hash64 to uint64_t here for an unsigned right shift.
@@ -228,6 +347,11 @@ namespace orc {
 
   NO_SANITIZE_ATTR
   bool BloomFilterImpl::testHash(int64_t hash64) const {
+    if (splitBlock_) {
+      return getSplitBlockTest()(bitSet_->getData() + getBlockOffset(hash64),
+                                 static_cast<uint32_t>(hash64));
+    }
+
     int32_t hash1 = static_cast<int32_t>(hash64 & 0xffffffff);
     // In Java codes, we use "hash64 >>> 32" which is an unsigned shift op.
     // So we cast hash64 to uint64_t here for an unsigned right shift.
@@ -247,12 +371,83 @@ namespace orc {
     return true;
   }
 
+  BloomFilterProbes::BloomFilterProbes(const std::vector<int64_t>& hashes)
+      : hashes_(hashes), numBits_(0), numHashFunctions_(0), splitBlock_(false) {}
+
+  NO_SANITIZE_ATTR
+  void BloomFilterProbes::computePositions(const BloomFilterImpl& filter) {
+    const uint64_t numBits = filter.numBits_;
+    const int32_t numHashFunctions = filter.numHashFunctions_;
+    numBits_ = numBits;
+    numHashFunctions_ = numHashFunctions;
+    splitBlock_ = filter.splitBlock_;
+    positions_.clear();
+    if (splitBlock_) {
+      positions_.reserve(hashes_.size());
+      for (int64_t hash64 : hashes_) {
+        positions_.push_back(filter.getBlockOffset(hash64));
+      }
+      return;
+    }
+    positions_.reserve(hashes_.size() * static_cast<size_t>(numHashFunctions));
+    // the same positions as BloomFilterImpl::testHash()
+    for (int64_t hash64 : hashes_) {
+      int32_t hash1 = static_cast<int32_t>(hash64 & 0xffffffff);
+      int32_t hash2 = static_cast<int32_t>(static_cast<uint64_t>(hash64) >> 32);
+      for (int32_t i = 1; i <= numHashFunctions; ++i) {
+        int32_t combinedHash = hash1 + i * hash2;
+        if (combinedHash < 0) {
+          combinedHash = ~combinedHash;
+        }
+        positions_.push_back(static_cast<uint64_t>(combinedHash) % numBits);
+      }
+    }
+  }
+
+  bool BloomFilterProbes::testAny(const BloomFilterImpl& filter) {
+    if (filter.numBits_ != numBits_ || filter.numHashFunctions_ != numHashFunctions_ ||
+        filter.splitBlock_ != splitBlock_) {
+      computePositions(filter);
+    }
+    const uint64_t* bits = filter.bitSet_->getData();
+    if (splitBlock_) {
+      // each hash costs a single block test
+      auto testBlock = getSplitBlockTest();
+      for (size_t i = 0; i != hashes_.size(); ++i) {
+        if (testBlock(bits + positions_[i], static_cast<uint32_t>(hashes_[i]))) {
+          return true;
+        }
+      }
+      return false;
+    }
+    const size_t numProbes = static_cast<size_t>(numHashFunctions_);
+    const uint64_t* positions = positions_.data();
+    for (size_t i = 0; i != hashes_.size(); ++i, positions += numProbes) {
+      // most hashes are rejected by their first probe, so only the ones
+      // passing it test the rest, without branching so that the loads overlap
+      uint64_t found = numProbes == 0 ||
+                       ((bits[positions[0] >> SHIFT_6_BITS] >> (positions[0] % BITS_OF_LONG)) & 1);
+      if (found) {
+        for (size_t j = 1; j < numProbes; ++j) {
+          found &= bits[positions[j] >> SHIFT_6_BITS] >> (positions[j] % BITS_OF_LONG);
+        }
+        if (found) {
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
   void BloomFilterImpl::merge(const BloomFilterImpl& other) {
-    if (numBits_ != other.numBits_ || numHashFunctions_ != other.numHashFunctions_) {
+    if (numBits_ != other.numBits_ || numHashFunctions_ != other.numHashFunctions_ ||
+        splitBlock_ != other.splitBlock_) {
       std::stringstream ss;
       ss << "BloomFilters are not compatible for merging: "
          << "this: numBits:" << numBits_ << ",numHashFunctions:" << numHashFunctions_
-         << ", that: numBits:" << other.numBits_ << ",numHashFunctions:" << other.numHashFunctions_;
+         << ",splitBlock:" << splitBlock_ << ", that: numBits:" << other.numBits_
+         << ",numHashFunctions:" << other.numHashFunctions_
+         << ",splitBlock:" << other.splitBlock_;
       throw std::logic_error(ss.str());
     }
 
@@ -289,7 +484,7 @@ namespace orc {
 
   bool BloomFilterImpl::operator==(const BloomFilterImpl& other) const {
     return numBits_ == other.numBits_ && numHashFunctions_ == other.numHashFunctions_ &&
-           *bitSet_ == *other.bitSet_;
+           splitBlock_ == other.splitBlock_ && *bitSet_ == *other.bitSet_;
   }
 
   BloomFilter::~BloomFilter() {
@@ -305,7 +500,9 @@ namespace orc {
     }
 
     // make sure we don't use unknown encodings or original timestamp encodings
-    if (!encoding.has_bloom_encoding() || encoding.bloom_encoding() != 1) {
+    if (!encoding.has_bloom_encoding() ||
+        (encoding.bloom_encoding() != BloomFilterVersion::UTF8 &&
+         encoding.bloom_encoding() != BloomFilterVersion::SPLIT_BLOCK)) {
       return nullptr;
     }
 
@@ -314,7 +511,14 @@ namespace orc {
       return nullptr;
     }
 
-    return std::make_unique<BloomFilterImpl>(bloomFilter);
+    auto version = static_cast<BloomFilterVersion>(encoding.bloom_encoding());
+    if (version == BloomFilterVersion::SPLIT_BLOCK &&
+        (bloomFilter.utf8bitset().empty() ||
+         bloomFilter.utf8bitset().size() % (SPLIT_BLOCK_BITS >> SHIFT_3_BITS) != 0)) {
+      return nullptr;
+    }
+
+    return std::make_unique<BloomFilterImpl>(bloomFilter, version);
   }
 
 }  // namespace orc
@@ -20,6 +20,7 @@
 #define ORC_BLOOMFILTER_IMPL_HH
 
 #include "orc/BloomFilter.hh"
+#include "orc/Common.hh"
 #include "wrap/orc-proto-wrapper.hh"
 
 #include <cmath>
@@ -118,6 +119,10 @@ namespace orc {
    * Note that this class is here for backwards compatibility, because it uses
    * the JVM default character set for strings. All new users should
    * BloomFilterUtf8, which always uses UTF8 for the encoding.
+   *
+   * With BloomFilterVersion::SPLIT_BLOCK, the bits of each element are all
+   * set in one 256-bit block instead of across the whole bit set; see
+   * BloomFilterKernels.hh.
    */
   class BloomFilterImpl : public BloomFilter {
    public:
@@ -126,15 +131,18 @@ namespace orc {
      *
      * @param expectedEntries - number of entries it will hold
      * @param fpp - false positive probability
+     * @param version - UTF8 or SPLIT_BLOCK
      */
-    BloomFilterImpl(uint64_t expectedEntries, double fpp = DEFAULT_FPP);
+    BloomFilterImpl(uint64_t expectedEntries, double fpp = DEFAULT_FPP,
+                    BloomFilterVersion version = BloomFilterVersion::UTF8);
 
     /**
      * Creates a BloomFilter by deserializing the proto-buf version
      *
      * caller should make sure input proto::BloomFilter is valid
      */
-    BloomFilterImpl(const proto::BloomFilter& bloomFilter);
+    BloomFilterImpl(const proto::BloomFilter& bloomFilter,
+                    BloomFilterVersion version = BloomFilterVersion::UTF8);
 
     /**
      * Adds a new element to the BloomFilter
@@ -150,9 +158,24 @@ namespace orc {
     bool testLong(int64_t data) const override;
     bool testDouble(double data) const override;
 
+    /**
+     * Test if any element with the given hash exists in BloomFilter
+     * @param hashes the hashes computed by the hash*() functions below
+     */
+    bool testAnyHash(const int64_t* hashes, size_t numHashes) const;
+
+    /**
+     * Compute the hash of an element once, so that it can be tested
+     * against many filters.
+     */
+    static int64_t hashBytes(const char* data, int64_t length);
+    static int64_t hashLong(int64_t data);
+    static int64_t hashDouble(double data);
+
     uint64_t sizeInBytes() const;
     uint64_t getBitSize() const;
     int32_t getNumHashFunctions() const;
+    BloomFilterVersion getVersion() const;
 
     void merge(const BloomFilterImpl& other);
 
@@ -161,6 +184,7 @@ namespace orc {
     bool operator==(const BloomFilterImpl& other) const;
 
    private:
+    friend class BloomFilterProbes;
     friend struct BloomFilterUTF8Utils;
     friend class TestBloomFilter_testBloomFilterBasicOperations_Test;
 
@@ -172,13 +196,47 @@ namespace orc {
 
     void serialize(proto::BloomFilter& bloomFilter) const;
 
+    // index of the first long of the block selected by hash64
+    uint64_t getBlockOffset(int64_t hash64) const;
+
    private:
     static constexpr double DEFAULT_FPP = 0.05;
     uint64_t numBits_;
     int32_t numHashFunctions_;
+    bool splitBlock_;
     std::unique_ptr<BitSet> bitSet_;
   };
 
+  /**
+   * Tests a fixed set of hashes against many bloom filters, typically the
+   * ones of all row groups of a column. The bit positions probed for each
+   * hash depend only on the filter size, number of hash functions and
+   * layout, so they are computed once and reused while those stay the same.
+   */
+  class BloomFilterProbes {
+   public:
+    /**
+     * @param hashes the hashes to test, which must outlive this object
+     */
+    explicit BloomFilterProbes(const std::vector<int64_t>& hashes);
+
+    /**
+     * Test if any of the hashes exists in the filter
+     */
+    bool testAny(const BloomFilterImpl& filter);
+
+   private:
+    void computePositions(const BloomFilterImpl& filter);
+
+    const std::vector<int64_t>& hashes_;
+    uint64_t numBits_;
+    int32_t numHashFunctions_;
+    bool splitBlock_;
+    // numHashFunctions_ bit positions for each hash, or the offset of its
+    // block for split-block filters
+    std::vector<uint64_t> positions_;
+  };
+
   struct BloomFilterUTF8Utils {
     // serialize BloomFilter in protobuf
     static void serialize(const BloomFilterImpl& in, proto::BloomFilter& out) {
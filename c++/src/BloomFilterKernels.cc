@@ -0,0 +1,34 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BloomFilterKernels.hh"
+
+namespace orc {
+
+  bool SplitBlockDefault::testBlock(const uint64_t* block, uint32_t key) {
+    // the 32-bit word w is the (w % 2)-th half of the long w / 2
+    for (uint32_t w = 0; w < SPLIT_BLOCK_WORDS; ++w) {
+      uint32_t bit = (w & 1) * 32 + splitBlockBit(key, w);
+      if (((block[w >> 1] >> bit) & 1) == 0) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+}  // namespace orc
@@ -0,0 +1,56 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_BLOOMFILTERKERNELS_HH
+#define ORC_BLOOMFILTERKERNELS_HH
+
+#include <cstdint>
+
+namespace orc {
+
+  /**
+   * A split-block bloom filter maps each hash to one 256-bit block and sets
+   * one bit in each of the 8 32-bit words of that block, so a lookup reads a
+   * single cache line. The upper 32 bits of the hash select the block and
+   * the lower 32 bits, multiplied by a salt per word, select the bits.
+   */
+  constexpr uint32_t SPLIT_BLOCK_WORDS = 8;
+  constexpr uint64_t SPLIT_BLOCK_BITS = 256;
+  constexpr uint32_t SPLIT_BLOCK_SALT[SPLIT_BLOCK_WORDS] = {0x47b6137bU, 0x44974d91U, 0x8824ad5bU,
+                                                            0xa2b7289dU, 0x705495c7U, 0x2df1424bU,
+                                                            0x9efc4947U, 0x5c6bfb31U};
+
+  // The bit of the 32-bit word selected by key in a block
+  inline uint32_t splitBlockBit(uint32_t key, uint32_t word) {
+    return (key * SPLIT_BLOCK_SALT[word]) >> 27;
+  }
+
+  class SplitBlockDefault {
+   public:
+    // Check whether all bits of key are set in the block of 4 longs
+    static bool testBlock(const uint64_t* block, uint32_t key);
+  };
+
+  class SplitBlockAVX2 {
+   public:
+    static bool testBlock(const uint64_t* block, uint32_t key);
+  };
+
+}  // namespace orc
+
+#endif
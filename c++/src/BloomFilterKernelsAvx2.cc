@@ -0,0 +1,51 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "BloomFilterKernels.hh"
+#include "Dispatch.hh"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+namespace orc {
+
+  namespace {
+    ORC_TARGET_AVX2 bool testBlockAvx2(const uint64_t* block, uint32_t key) {
+      // x86 is little endian, so the 4 longs are the 8 words in order
+      const __m256i salts = _mm256_setr_epi32(
+          static_cast<int>(SPLIT_BLOCK_SALT[0]), static_cast<int>(SPLIT_BLOCK_SALT[1]),
+          static_cast<int>(SPLIT_BLOCK_SALT[2]), static_cast<int>(SPLIT_BLOCK_SALT[3]),
+          static_cast<int>(SPLIT_BLOCK_SALT[4]), static_cast<int>(SPLIT_BLOCK_SALT[5]),
+          static_cast<int>(SPLIT_BLOCK_SALT[6]), static_cast<int>(SPLIT_BLOCK_SALT[7]));
+      __m256i keys = _mm256_set1_epi32(static_cast<int>(key));
+      __m256i bits = _mm256_srli_epi32(_mm256_mullo_epi32(keys, salts), 27);
+      __m256i mask = _mm256_sllv_epi32(_mm256_set1_epi32(1), bits);
+      __m256i words = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(block));
+      // set if no bit of mask is missing from words
+      return _mm256_testc_si256(words, mask) != 0;
+    }
+  }  // namespace
+
+  bool SplitBlockAVX2::testBlock(const uint64_t* block, uint32_t key) {
+    return testBlockAvx2(block, key);
+  }
+
+}  // namespace orc
@@ -0,0 +1,173 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "BpackingAvx2.hh"
+#include "Dispatch.hh"
+#include "RLEv2.hh"
+
+#include <algorithm>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+namespace orc {
+
+  namespace {
+    /**
+     * A group of 8 values of bitWidth bits takes bitWidth bytes. Its lower and
+     * upper 4 values are both covered by a 16-byte load. For every value the
+     * shuffle gathers the bytes holding it into a big-endian 64-bit lane, then
+     * shifting the lane right by the bits after the value leaves the value in
+     * the low bits.
+     */
+    template <uint32_t bitWidth>
+    struct UnpackTables {
+      uint8_t shuffle[2][32];
+      uint64_t shift[2][4];
+
+      constexpr UnpackTables() : shuffle(), shift() {
+        for (uint32_t half = 0; half < 2; ++half) {
+          uint32_t halfBit = half * 4 * bitWidth;
+          uint32_t loadBit = halfBit / 8 * 8;
+          for (uint32_t lane = 0; lane < 4; ++lane) {
+            uint32_t bit = halfBit + lane * bitWidth - loadBit;
+            for (uint32_t k = 0; k < 8; ++k) {
+              // the first byte is the most significant one, bytes past the
+              // load are zeroed
+              uint32_t src = bit / 8 + 7 - k;
+              shuffle[half][lane * 8 + k] = src < 16 ? static_cast<uint8_t>(src) : 0x80;
+            }
+            shift[half][lane] = 64 - bit % 8 - bitWidth;
+          }
+        }
+      }
+    };
+
+    template <uint32_t bitWidth>
+    ORC_TARGET_AVX2 void vectorUnpack(RleDecoderV2* decoder, int64_t* data, uint64_t offset,
+                                      uint64_t len) {
+      static_assert(bitWidth >= 1 && bitWidth <= 32, "unsupported bit width");
+      static constexpr UnpackTables<bitWidth> tables{};
+      // the byte of a group where the load of the upper 4 values starts
+      constexpr uint64_t upperByte = bitWidth / 2;
+      // the bytes read from the start of a group
+      constexpr uint64_t groupReadBytes = upperByte + 16;
+
+      UnpackDefault unpackDefault(decoder);
+      uint64_t curIdx = offset;
+      const uint64_t endIdx = offset + len;
+
+      // Make sure the values start on a byte boundary
+      while (decoder->getBitsLeft() > 0 && curIdx < endIdx) {
+        unpackDefault.plainUnpackLongs(data, curIdx++, 1, bitWidth);
+      }
+
+      const __m256i lowerShuffle =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tables.shuffle[0]));
+      const __m256i upperShuffle =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tables.shuffle[1]));
+      const __m256i lowerShift =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tables.shift[0]));
+      const __m256i upperShift =
+          _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tables.shift[1]));
+      const __m256i mask = _mm256_set1_epi64x(static_cast<int64_t>((1ULL << bitWidth) - 1));
+
+      while (endIdx - curIdx >= 8) {
+        // Exhaust the buffer without reading past its end
+        uint64_t bufferNum = decoder->bufLength();
+        uint64_t numGroups =
+            bufferNum < groupReadBytes ? 0 : (bufferNum - groupReadBytes) / bitWidth + 1;
+        numGroups = std::min(numGroups, (endIdx - curIdx) / 8);
+        // Avoid updating 'bufferStart' inside the loop.
+        auto* buffer = reinterpret_cast<const uint8_t*>(decoder->getBufStart());
+        for (uint64_t i = 0; i < numGroups; ++i) {
+          __m256i lower = _mm256_broadcastsi128_si256(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer)));
+          __m256i upper = _mm256_broadcastsi128_si256(
+              _mm_loadu_si128(reinterpret_cast<const __m128i*>(buffer + upperByte)));
+          lower = _mm256_shuffle_epi8(lower, lowerShuffle);
+          upper = _mm256_shuffle_epi8(upper, upperShuffle);
+          lower = _mm256_and_si256(_mm256_srlv_epi64(lower, lowerShift), mask);
+          upper = _mm256_and_si256(_mm256_srlv_epi64(upper, upperShift), mask);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + curIdx), lower);
+          _mm256_storeu_si256(reinterpret_cast<__m256i*>(data + curIdx + 4), upper);
+          buffer += bitWidth;
+          curIdx += 8;
+        }
+        decoder->setBufStart(reinterpret_cast<const char*>(buffer));
+
+        if (endIdx - curIdx >= 8) {
+          // The group crosses the end of the buffer. It ends on a byte
+          // boundary, so the next group can be vectorized again.
+          unpackDefault.plainUnpackLongs(data, curIdx, 8, bitWidth);
+          curIdx += 8;
+        }
+      }
+
+      unpackDefault.plainUnpackLongs(data, curIdx, endIdx - curIdx, bitWidth);
+    }
+  }  // namespace
+
+  void BitUnpackAVX2::readLongs(RleDecoderV2* decoder, int64_t* data, uint64_t offset,
+                                uint64_t len, uint64_t fbs) {
+    switch (fbs) {
+#define ORC_UNPACK_AVX2_CASE(width)                  \
+  case width:                                        \
+    vectorUnpack<width>(decoder, data, offset, len); \
+    break;
+      ORC_UNPACK_AVX2_CASE(1)
+      ORC_UNPACK_AVX2_CASE(2)
+      ORC_UNPACK_AVX2_CASE(3)
+      ORC_UNPACK_AVX2_CASE(4)
+      ORC_UNPACK_AVX2_CASE(5)
+      ORC_UNPACK_AVX2_CASE(6)
+      ORC_UNPACK_AVX2_CASE(7)
+      ORC_UNPACK_AVX2_CASE(8)
+      ORC_UNPACK_AVX2_CASE(9)
+      ORC_UNPACK_AVX2_CASE(10)
+      ORC_UNPACK_AVX2_CASE(11)
+      ORC_UNPACK_AVX2_CASE(12)
+      ORC_UNPACK_AVX2_CASE(13)
+      ORC_UNPACK_AVX2_CASE(14)
+      ORC_UNPACK_AVX2_CASE(15)
+      ORC_UNPACK_AVX2_CASE(16)
+      ORC_UNPACK_AVX2_CASE(17)
+      ORC_UNPACK_AVX2_CASE(18)
+      ORC_UNPACK_AVX2_CASE(19)
+      ORC_UNPACK_AVX2_CASE(20)
+      ORC_UNPACK_AVX2_CASE(21)
+      ORC_UNPACK_AVX2_CASE(22)
+      ORC_UNPACK_AVX2_CASE(23)
+      ORC_UNPACK_AVX2_CASE(24)
+      ORC_UNPACK_AVX2_CASE(26)
+      ORC_UNPACK_AVX2_CASE(28)
+      ORC_UNPACK_AVX2_CASE(30)
+      ORC_UNPACK_AVX2_CASE(32)
+#undef ORC_UNPACK_AVX2_CASE
+      default:
+        // Wider values, and widths RLEv2 never writes
+        BitUnpackDefault::readLongs(decoder, data, offset, len, fbs);
+        break;
+    }
+  }
+
+}  // namespace orc
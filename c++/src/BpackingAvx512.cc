@@ -2446,7 +2446,8 @@ namespace orc {
     UnpackDefault unpackDefault(decoder);
     uint64_t startBit = 0;
     static const auto cpu_info = CpuInfo::getInstance();
-    if (cpu_info->isSupported(CpuInfo::AVX512)) {
+    // only dispatched to when enabled, possibly by setMaxDispatchLevel()
+    if (cpu_info->isDetected(CpuInfo::AVX512)) {
       switch (fbs) {
         case 1:
           unpackAvx512.vectorUnpack1(data, offset, len);
@@ -187,7 +187,7 @@ namespace orc {
   }
 
   void ByteRleEncoderImpl::recordPosition(PositionRecorder* recorder) const {
-    uint64_t flushedSize = outputStream->getSize();
+    uint64_t flushedSize = outputStream->getExactSize();
     uint64_t unusedBufferSize = static_cast<uint64_t>(bufferLength - bufferPosition);
     if (outputStream->isCompressed()) {
       // start of the compression chunk in the stream
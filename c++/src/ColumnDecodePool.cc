@@ -0,0 +1,102 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ColumnDecodePool.hh"
+
+#include <algorithm>
+
+namespace orc {
+
+  ColumnDecodePool::ColumnDecodePool(uint32_t numThreads)
+      : numThreads_(std::max(numThreads, 1u)),
+        generation_(0),
+        numTasks_(0),
+        task_(nullptr),
+        pendingThreads_(0),
+        stopping_(false) {
+    threads_.reserve(numThreads_);
+    for (uint32_t i = 0; i < numThreads_; ++i) {
+      threads_.emplace_back([this, i] { work(i); });
+    }
+  }
+
+  ColumnDecodePool::~ColumnDecodePool() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      stopping_ = true;
+    }
+    start_.notify_all();
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  void ColumnDecodePool::run(size_t numTasks, const std::function<void(size_t)>& task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    numTasks_ = numTasks;
+    task_ = &task;
+    error_ = nullptr;
+    pendingThreads_ = numThreads_;
+    ++generation_;
+    start_.notify_all();
+    done_.wait(lock, [this] { return pendingThreads_ == 0; });
+    task_ = nullptr;
+    if (error_) {
+      std::exception_ptr error = error_;
+      error_ = nullptr;
+      std::rethrow_exception(error);
+    }
+  }
+
+  void ColumnDecodePool::work(uint32_t thread) {
+    uint64_t generation = 0;
+    while (true) {
+      size_t numTasks;
+      const std::function<void(size_t)>* task;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        start_.wait(lock, [this, generation] { return stopping_ || generation_ != generation; });
+        if (stopping_) {
+          return;
+        }
+        generation = generation_;
+        numTasks = numTasks_;
+        task = task_;
+      }
+      std::exception_ptr error;
+      try {
+        for (size_t i = thread; i < numTasks; i += numThreads_) {
+          (*task)(i);
+        }
+      } catch (...) {
+        error = std::current_exception();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (error && !error_) {
+          error_ = error;
+        }
+        if (--pendingThreads_ == 0) {
+          done_.notify_one();
+        }
+      }
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,76 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_COLUMN_DECODE_POOL_HH
+#define ORC_COLUMN_DECODE_POOL_HH
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * A fixed set of threads that decode the columns of a batch concurrently.
+   * Task i of every run is executed by thread i % getNumThreads(), so a
+   * column reader and its decompression streams always stay on the same
+   * thread.
+   */
+  class ColumnDecodePool {
+   public:
+    explicit ColumnDecodePool(uint32_t numThreads);
+    ~ColumnDecodePool();
+
+    ColumnDecodePool(const ColumnDecodePool&) = delete;
+    ColumnDecodePool& operator=(const ColumnDecodePool&) = delete;
+
+    uint32_t getNumThreads() const {
+      return numThreads_;
+    }
+
+    /**
+     * Run task(0) to task(numTasks - 1) and wait for all of them. The first
+     * exception thrown by a task is rethrown once all tasks are done.
+     */
+    void run(size_t numTasks, const std::function<void(size_t)>& task);
+
+   private:
+    void work(uint32_t thread);
+
+    const uint32_t numThreads_;
+    std::mutex mutex_;
+    std::condition_variable start_;
+    std::condition_variable done_;
+    // incremented for every run so that each thread picks it up exactly once
+    uint64_t generation_;
+    size_t numTasks_;
+    const std::function<void(size_t)>* task_;
+    size_t pendingThreads_;
+    std::exception_ptr error_;
+    bool stopping_;
+    std::vector<std::thread> threads_;
+  };
+
+}  // namespace orc
+
+#endif
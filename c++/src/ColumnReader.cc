@@ -23,10 +23,13 @@
 
 #include "Adaptor.hh"
 #include "ByteRLE.hh"
+#include "ColumnDecodePool.hh"
 #include "ConvertColumnReader.hh"
 #include "DictionaryLoader.hh"
+#include "Dispatch.hh"
 #include "RLE.hh"
 #include "SchemaEvolution.hh"
+#include "TimestampKernels.hh"
 #include "orc/Exceptions.hh"
 #include "orc/Int128.hh"
 
@@ -40,6 +43,10 @@ namespace orc {
     // PASS
   }
 
+  ColumnDecodePool* StripeStreams::getColumnDecodePool() const {
+    return nullptr;
+  }
+
   ColumnReader::ColumnReader(const Type& type, StripeStreams& stripe)
       : columnId(type.getColumnId()),
         memoryPool(stripe.getMemoryPool()),
@@ -257,6 +264,19 @@ namespace orc {
     }
   };
 
+  struct DecodeNanosDynamicFunction {
+    using FunctionType = decltype(&TimestampDecodeDefault::decodeNanos);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      std::vector<std::pair<DispatchLevel, FunctionType>> impls = {
+          {DispatchLevel::NONE, TimestampDecodeDefault::decodeNanos}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      impls.emplace_back(DispatchLevel::AVX2, TimestampDecodeAVX2::decodeNanos);
+#endif
+      return impls;
+    }
+  };
+
   class TimestampColumnReader : public ColumnReader {
    private:
     std::unique_ptr<orc::RleDecoder> secondsRle_;
@@ -265,6 +285,9 @@ namespace orc {
     const Timezone* readerTimezone_;
     const int64_t epochOffset_;
     const bool sameTimezone_;
+    // the variants of the last lookups, as consecutive rows tend to share them
+    TimezoneVariantCache writerVariants_;
+    TimezoneVariantCache readerVariants_;
 
    public:
     TimestampColumnReader(const Type& type, StripeStreams& stripe, bool isInstantType);
@@ -283,7 +306,9 @@ namespace orc {
         writerTimezone_(isInstantType ? &getTimezoneByName("GMT") : &stripe.getWriterTimezone()),
         readerTimezone_(isInstantType ? &getTimezoneByName("GMT") : &stripe.getReaderTimezone()),
         epochOffset_(writerTimezone_->getEpoch()),
-        sameTimezone_(writerTimezone_ == readerTimezone_) {
+        sameTimezone_(writerTimezone_ == readerTimezone_),
+        writerVariants_(*writerTimezone_),
+        readerVariants_(*readerTimezone_) {
     RleVersion vers = convertRleVersion(stripe.getEncoding(columnId).kind());
     std::unique_ptr<SeekableInputStream> stream =
         stripe.getStream(columnId, proto::Stream_Kind_DATA, true);
@@ -314,17 +339,20 @@ namespace orc {
     int64_t* nanoBuffer = timestampBatch.nanoseconds.data();
     nanoRle_->next(nanoBuffer, numValues, notNull);
 
+    if (notNull) {
+      // null slots keep the values of earlier batches, which mustn't be scaled again
+      for (uint64_t i = 0; i < numValues; i++) {
+        if (!notNull[i]) {
+          nanoBuffer[i] = 0;
+        }
+      }
+    }
+
     // Construct the values
+    static DynamicDispatch<DecodeNanosDynamicFunction> dispatch;
+    dispatch.get()(nanoBuffer, numValues);
     for (uint64_t i = 0; i < numValues; i++) {
       if (notNull == nullptr || notNull[i]) {
-        uint64_t zeros = nanoBuffer[i] & 0x7;
-        nanoBuffer[i] >>= 3;
-        if (zeros != 0) {
-          for (uint64_t j = 0; j <= zeros; ++j) {
-            nanoBuffer[i] *= 10;
-          }
-        }
-
         int64_t writerTime = secsBuffer[i] + epochOffset_;
         if (writerTime < 0 && nanoBuffer[i] > 999999) {
           writerTime -= 1;
@@ -333,13 +361,13 @@ namespace orc {
         if (!sameTimezone_) {
           // adjust timestamp value to same wall clock time if writer and reader
           // time zones have different rules, which is required for Apache Orc.
-          const auto& wv = writerTimezone_->getVariant(writerTime);
-          const auto& rv = readerTimezone_->getVariant(writerTime);
+          const auto& wv = writerVariants_.getVariant(writerTime);
+          const auto& rv = readerVariants_.getVariant(writerTime);
           if (!wv.hasSameTzRule(rv)) {
             // If the timezone adjustment moves the millis across a DST boundary,
             // we need to reevaluate the offsets.
             int64_t adjustedTime = writerTime + wv.gmtOffset - rv.gmtOffset;
-            const auto& adjustedReader = readerTimezone_->getVariant(adjustedTime);
+            const auto& adjustedReader = readerVariants_.getVariant(adjustedTime);
             writerTime = writerTime + wv.gmtOffset - adjustedReader.gmtOffset;
           }
         }
@@ -628,6 +656,12 @@ namespace orc {
      */
     size_t computeSize(const int64_t* lengths, const char* notNull, uint64_t numValues);
 
+    /**
+     * Point the values at consecutive bytes starting at ptr.
+     */
+    static void fillStartPointers(char** startPtr, const int64_t* lengthPtr, const char* notNull,
+                                  uint64_t numValues, const char* ptr);
+
    public:
     StringDirectColumnReader(const Type& type, StripeStreams& stipe);
     ~StringDirectColumnReader() override;
@@ -669,6 +703,10 @@ namespace orc {
       totalBytes += computeSize(buffer, nullptr, step);
       done += step;
     }
+    if (totalBytes == 0) {
+      // only nulls or empty strings were skipped
+      return numValues;
+    }
     if (totalBytes <= lastBufferLength_) {
       // subtract the needed bytes from the ones left over
       lastBufferLength_ -= totalBytes;
@@ -737,6 +775,25 @@ namespace orc {
     // figure out the total length of data we need from the blob stream
     const size_t totalLength = computeSize(lengthPtr, notNull, numValues);
 
+    if (blobStream_->hasStableBuffers()) {
+      if (lastBufferLength_ == 0 && totalLength > 0) {
+        const void* readBuffer;
+        int readLength;
+        if (!blobStream_->Next(&readBuffer, &readLength)) {
+          throw ParseError("failed to read in StringDirectColumnReader.next");
+        }
+        lastBuffer_ = static_cast<const char*>(readBuffer);
+        lastBufferLength_ = static_cast<size_t>(readLength);
+      }
+      if (lastBufferLength_ >= totalLength) {
+        // the stream's buffer outlives the batch, so point into it directly
+        fillStartPointers(startPtr, lengthPtr, notNull, numValues, lastBuffer_);
+        lastBuffer_ += totalLength;
+        lastBufferLength_ -= totalLength;
+        return;
+      }
+    }
+
     // Load data from the blob stream into our buffer until we have enough
     // to get the rest directly out of the stream's buffer.
     size_t bytesBuffered = 0;
@@ -763,8 +820,13 @@ namespace orc {
       lastBufferLength_ -= moreBytes;
     }
 
+    fillStartPointers(startPtr, lengthPtr, notNull, numValues, byteBatch.blob.data());
+  }
+
+  void StringDirectColumnReader::fillStartPointers(char** startPtr, const int64_t* lengthPtr,
+                                                   const char* notNull, uint64_t numValues,
+                                                   const char* ptr) {
     size_t filledSlots = 0;
-    ptr = byteBatch.blob.data();
     if (notNull) {
       while (filledSlots < numValues) {
         if (notNull[filledSlots]) {
@@ -792,31 +854,10 @@ namespace orc {
     lastBufferLength_ = 0;
   }
 
-  class StructColumnReader : public ColumnReader {
-   private:
-    std::vector<std::unique_ptr<ColumnReader>> children_;
-
-   public:
-    StructColumnReader(const Type& type, StripeStreams& stripe, bool useTightNumericVector = false,
-                       bool throwOnSchemaEvolutionOverflow = false);
-
-    uint64_t skip(uint64_t numValues) override;
-
-    void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
-
-    void nextEncoded(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
-
-    void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
-
-   private:
-    template <bool encoded>
-    void nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull);
-  };
-
   StructColumnReader::StructColumnReader(const Type& type, StripeStreams& stripe,
                                          bool useTightNumericVector,
                                          bool throwOnSchemaEvolutionOverflow)
-      : ColumnReader(type, stripe) {
+      : ColumnReader(type, stripe), decodePool_(nullptr) {
     // count the number of selected sub-columns
     const std::vector<bool> selectedColumns = stripe.getSelectedColumns();
     switch (static_cast<int64_t>(stripe.getEncoding(columnId).kind())) {
@@ -835,10 +876,19 @@ namespace orc {
       default:
         throw ParseError("Unknown encoding for StructColumnReader");
     }
+    if (columnId == 0 && children_.size() > 1) {
+      decodePool_ = stripe.getColumnDecodePool();
+    }
   }
 
   uint64_t StructColumnReader::skip(uint64_t numValues) {
     numValues = ColumnReader::skip(numValues);
+    if (decodePool_) {
+      decodePool_->run(children_.size(), [this, numValues](size_t i) {
+        children_[i]->skip(numValues);
+      });
+      return numValues;
+    }
     for (auto& ptr : children_) {
       ptr->skip(numValues);
     }
@@ -860,6 +910,17 @@ namespace orc {
     ColumnReader::next(rowBatch, numValues, notNull);
     uint64_t i = 0;
     notNull = rowBatch.hasNulls ? rowBatch.notNull.data() : nullptr;
+    if (decodePool_) {
+      auto& fields = dynamic_cast<StructVectorBatch&>(rowBatch).fields;
+      decodePool_->run(children_.size(), [this, &fields, numValues, notNull](size_t child) {
+        if (encoded) {
+          children_[child]->nextEncoded(*fields[child], numValues, notNull);
+        } else {
+          children_[child]->next(*fields[child], numValues, notNull);
+        }
+      });
+      return;
+    }
     for (auto iter = children_.begin(); iter != children_.end(); ++iter, ++i) {
       if (encoded) {
         (*iter)->nextEncoded(*(dynamic_cast<StructVectorBatch&>(rowBatch).fields[i]), numValues,
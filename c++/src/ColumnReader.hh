@@ -30,6 +30,7 @@
 
 namespace orc {
 
+  class ColumnDecodePool;
   class SchemaEvolution;
 
   class StripeStreams {
@@ -115,6 +116,12 @@ namespace orc {
      * @return get schema evolution utility object
      */
     virtual const SchemaEvolution* getSchemaEvolution() const = 0;
+
+    /**
+     * @return the threads that decode the top-level columns concurrently,
+     *         or nullptr to decode them on the calling thread
+     */
+    virtual ColumnDecodePool* getColumnDecodePool() const;
   };
 
   /**
@@ -169,6 +176,54 @@ namespace orc {
     virtual void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions);
   };
 
+  /**
+   * The reader of struct columns. The readers of its fields are exposed so
+   * that the fields of the top-level struct can be read one at a time.
+   */
+  class StructColumnReader : public ColumnReader {
+   private:
+    std::vector<std::unique_ptr<ColumnReader>> children_;
+    // decodes the children concurrently; only set for the top-level struct
+    ColumnDecodePool* decodePool_;
+
+   public:
+    StructColumnReader(const Type& type, StripeStreams& stripe, bool useTightNumericVector = false,
+                       bool throwOnSchemaEvolutionOverflow = false);
+
+    uint64_t skip(uint64_t numValues) override;
+
+    void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
+
+    void nextEncoded(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
+
+    void seekToRowGroup(std::unordered_map<uint64_t, PositionProvider>& positions) override;
+
+    /**
+     * Get the number of selected fields.
+     */
+    size_t getFieldCount() const {
+      return children_.size();
+    }
+
+    /**
+     * Get the reader of the field that fills StructVectorBatch::fields[field].
+     */
+    ColumnReader& getField(size_t field) {
+      return *children_[field];
+    }
+
+    /**
+     * Read the presence of the next structs without reading their fields.
+     */
+    void nextStruct(ColumnVectorBatch& rowBatch, uint64_t numValues) {
+      ColumnReader::next(rowBatch, numValues, nullptr);
+    }
+
+   private:
+    template <bool encoded>
+    void nextInternal(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull);
+  };
+
   /**
    * Create a reader for the given stripe.
    */
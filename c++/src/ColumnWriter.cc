@@ -37,31 +37,43 @@ namespace orc {
 
   class StreamsFactoryImpl : public StreamsFactory {
    public:
-    StreamsFactoryImpl(const WriterOptions& writerOptions, OutputStream* outputStream)
-        : options_(writerOptions), outStream_(outputStream) {}
+    StreamsFactoryImpl(const WriterOptions& writerOptions, OutputStream* outputStream,
+                       std::shared_ptr<CompressorPool> compressorPool, IOExecutor* executor)
+        : options_(writerOptions),
+          outStream_(outputStream),
+          compressorPool_(std::move(compressorPool)),
+          executor_(executor) {}
 
     virtual std::unique_ptr<BufferedOutputStream> createStream(
-        proto::Stream_Kind kind) const override;
+        uint64_t columnId, proto::Stream_Kind kind) const override;
 
    private:
     const WriterOptions& options_;
     OutputStream* outStream_;
+    std::shared_ptr<CompressorPool> compressorPool_;
+    IOExecutor* executor_;
   };
 
-  std::unique_ptr<BufferedOutputStream> StreamsFactoryImpl::createStream(proto::Stream_Kind) const {
-    // In the future, we can decide compression strategy and modifier
-    // based on stream kind. But for now we just use the setting from
-    // WriterOption
+  std::unique_ptr<BufferedOutputStream> StreamsFactoryImpl::createStream(
+      uint64_t columnId, proto::Stream_Kind kind) const {
+    ColumnCompression compression =
+        options_.getColumnCompression(columnId, static_cast<StreamKind>(kind));
     return createCompressor(
         options_.getCompression(), outStream_, options_.getCompressionStrategy(),
         // BufferedOutputStream initial capacity
         options_.getOutputBufferCapacity(), options_.getCompressionBlockSize(),
-        options_.getMemoryBlockSize(), *options_.getMemoryPool(), options_.getWriterMetrics());
+        options_.getMemoryBlockSize(), *options_.getMemoryPool(), options_.getWriterMetrics(),
+        compressorPool_, executor_, compression);
   }
 
-  std::unique_ptr<StreamsFactory> createStreamsFactory(const WriterOptions& options,
-                                                       OutputStream* outStream) {
-    return std::make_unique<StreamsFactoryImpl>(options, outStream);
+  std::unique_ptr<StreamsFactory> createStreamsFactory(
+      const WriterOptions& options, OutputStream* outStream,
+      std::shared_ptr<CompressorPool> compressorPool, IOExecutor* executor) {
+    if (!compressorPool) {
+      compressorPool = createCompressorPool(*options.getMemoryPool());
+    }
+    return std::make_unique<StreamsFactoryImpl>(options, outStream, std::move(compressorPool),
+                                                executor);
   }
 
   RowIndexPositionRecorder::~RowIndexPositionRecorder() {
@@ -95,7 +107,7 @@ namespace orc {
         bloomFilterStream(),
         hasNullValue(false) {
     std::unique_ptr<BufferedOutputStream> presentStream =
-        factory.createStream(proto::Stream_Kind_PRESENT);
+        factory.createStream(columnId, proto::Stream_Kind_PRESENT);
     notNullEncoder = createBooleanRleEncoder(std::move(presentStream));
 
     colIndexStatistics = createColumnStatistics(type);
@@ -106,16 +118,23 @@ namespace orc {
       rowIndex = std::make_unique<proto::RowIndex>();
       rowIndexEntry = std::make_unique<proto::RowIndexEntry>();
       rowIndexPosition = std::make_unique<RowIndexPositionRecorder>(*rowIndexEntry);
-      indexStream = factory.createStream(proto::Stream_Kind_ROW_INDEX);
+      indexStream = factory.createStream(columnId, proto::Stream_Kind_ROW_INDEX);
 
       // BloomFilters for non-UTF8 strings and non-UTC timestamps are not supported
       if (options.isColumnUseBloomFilter(columnId) &&
-          options.getBloomFilterVersion() == BloomFilterVersion::UTF8) {
+          (options.getBloomFilterVersion() == BloomFilterVersion::UTF8 ||
+           options.getBloomFilterVersion() == BloomFilterVersion::SPLIT_BLOCK)) {
         enableBloomFilter = true;
-        bloomFilter.reset(
-            new BloomFilterImpl(options.getRowIndexStride(), options.getBloomFilterFPP()));
+        // other readers take any bloom_encoding of the BLOOM_FILTER_UTF8 stream
+        // for a classic filter, so split-block filters only go to unstable files
+        BloomFilterVersion bloomFilterVersion = options.getBloomFilterVersion();
+        if (options.getFileVersion() != FileVersion::UNSTABLE_PRE_2_0()) {
+          bloomFilterVersion = BloomFilterVersion::UTF8;
+        }
+        bloomFilter.reset(new BloomFilterImpl(options.getRowIndexStride(),
+                                              options.getBloomFilterFPP(), bloomFilterVersion));
         bloomFilterIndex.reset(new proto::BloomFilterIndex());
-        bloomFilterStream = factory.createStream(proto::Stream_Kind_BLOOM_FILTER_UTF8);
+        bloomFilterStream = factory.createStream(columnId, proto::Stream_Kind_BLOOM_FILTER_UTF8);
       }
     }
   }
@@ -157,8 +176,8 @@ namespace orc {
     getProtoBufStatistics(stats, colStripeStatistics.get());
   }
 
-  void ColumnWriter::mergeStripeStatsIntoFileStats() {
-    colFileStatistics->merge(*colStripeStatistics);
+  void ColumnWriter::mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) {
+    fileStatsWriter.colFileStatistics->merge(*colStripeStatistics);
     colStripeStatistics->reset();
   }
 
@@ -260,6 +279,10 @@ namespace orc {
     // PASS
   }
 
+  void ColumnWriter::finishDictionaryCheck(const ColumnWriter*) {
+    // PASS
+  }
+
   void ColumnWriter::finishStreams() {
     notNullEncoder->finishEncode();
   }
@@ -281,7 +304,7 @@ namespace orc {
 
     virtual void getFileStatistics(std::vector<proto::ColumnStatistics>& stats) const override;
 
-    virtual void mergeStripeStatsIntoFileStats() override;
+    virtual void mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) override;
 
     virtual void mergeRowGroupStatsIntoStripeStats() override;
 
@@ -291,6 +314,8 @@ namespace orc {
 
     virtual void writeDictionary() override;
 
+    virtual void finishDictionaryCheck(const ColumnWriter* decidedWriter) override;
+
     virtual void reset() override;
 
     virtual void finishStreams() override;
@@ -382,11 +407,12 @@ namespace orc {
     }
   }
 
-  void StructColumnWriter::mergeStripeStatsIntoFileStats() {
-    ColumnWriter::mergeStripeStatsIntoFileStats();
+  void StructColumnWriter::mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) {
+    ColumnWriter::mergeStripeStatsIntoFileStats(fileStatsWriter);
 
+    auto& target = dynamic_cast<StructColumnWriter&>(fileStatsWriter);
     for (uint32_t i = 0; i < children_.size(); ++i) {
-      children_[i]->mergeStripeStatsIntoFileStats();
+      children_[i]->mergeStripeStatsIntoFileStats(*target.children_[i]);
     }
   }
 
@@ -428,6 +454,13 @@ namespace orc {
     }
   }
 
+  void StructColumnWriter::finishDictionaryCheck(const ColumnWriter* decidedWriter) {
+    auto* decided = dynamic_cast<const StructColumnWriter*>(decidedWriter);
+    for (uint32_t i = 0; i < children_.size(); ++i) {
+      children_[i]->finishDictionaryCheck(decided ? decided->children_[i].get() : nullptr);
+    }
+  }
+
   void StructColumnWriter::finishStreams() {
     ColumnWriter::finishStreams();
     for (uint32_t i = 0; i < children_.size(); ++i) {
@@ -467,7 +500,7 @@ namespace orc {
                                                       const WriterOptions& options)
       : ColumnWriter(type, factory, options), rleVersion_(options.getRleVersion()) {
     std::unique_ptr<BufferedOutputStream> dataStream =
-        factory.createStream(proto::Stream_Kind_DATA);
+        factory.createStream(columnId, proto::Stream_Kind_DATA);
     rleEncoder = createRleEncoder(std::move(dataStream), true, rleVersion_, memPool,
                                   options.getAlignedBitpacking());
 
@@ -538,7 +571,7 @@ namespace orc {
     encoding.set_kind(RleVersionMapper(rleVersion_));
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -582,7 +615,7 @@ namespace orc {
                                                 const WriterOptions& options)
       : ColumnWriter(type, factory, options) {
     std::unique_ptr<BufferedOutputStream> dataStream =
-        factory.createStream(proto::Stream_Kind_DATA);
+        factory.createStream(columnId, proto::Stream_Kind_DATA);
     byteRleEncoder_ = createByteRleEncoder(std::move(dataStream));
 
     if (enableIndex) {
@@ -655,7 +688,7 @@ namespace orc {
     encoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -701,7 +734,7 @@ namespace orc {
                                                       const WriterOptions& options)
       : ColumnWriter(type, factory, options) {
     std::unique_ptr<BufferedOutputStream> dataStream =
-        factory.createStream(proto::Stream_Kind_DATA);
+        factory.createStream(columnId, proto::Stream_Kind_DATA);
     rleEncoder_ = createBooleanRleEncoder(std::move(dataStream));
 
     if (enableIndex) {
@@ -776,7 +809,7 @@ namespace orc {
     encoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -826,7 +859,8 @@ namespace orc {
       : ColumnWriter(type, factory, options),
         isFloat_(isFloatType),
         buffer_(*options.getMemoryPool()) {
-    dataStream_.reset(new AppendOnlyBufferedStream(factory.createStream(proto::Stream_Kind_DATA)));
+    dataStream_.reset(
+        new AppendOnlyBufferedStream(factory.createStream(columnId, proto::Stream_Kind_DATA)));
     buffer_.resize(isFloat_ ? 4 : 8);
 
     if (enableIndex) {
@@ -912,7 +946,7 @@ namespace orc {
     encoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -948,6 +982,8 @@ namespace orc {
 
     virtual void writeDictionary() override;
 
+    virtual void finishDictionaryCheck(const ColumnWriter* decidedWriter) override;
+
     virtual void reset() override;
 
     virtual void finishStreams() override;
@@ -1130,7 +1166,7 @@ namespace orc {
     }
     encoding.set_dictionary_size(static_cast<uint32_t>(dictionary.size()));
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -1166,6 +1202,25 @@ namespace orc {
     return useDictionary;
   }
 
+  void StringColumnWriter::finishDictionaryCheck(const ColumnWriter* decidedWriter) {
+    if (!useDictionary || doneDictionaryCheck) {
+      return;
+    }
+    if (decidedWriter == nullptr) {
+      checkDictionaryKeyRatio();
+    } else {
+      const auto& decided = dynamic_cast<const StringColumnWriter&>(*decidedWriter);
+      if (!decided.doneDictionaryCheck) {
+        return;
+      }
+      useDictionary = decided.useDictionary;
+      doneDictionaryCheck = true;
+    }
+    if (!useDictionary) {
+      fallbackToDirectEncoding();
+    }
+  }
+
   void StringColumnWriter::createRowIndexEntry() {
     if (useDictionary && !doneDictionaryCheck) {
       if (!checkDictionaryKeyRatio()) {
@@ -1186,24 +1241,24 @@ namespace orc {
 
   void StringColumnWriter::createDirectStreams() {
     std::unique_ptr<BufferedOutputStream> directLengthStream =
-        streamsFactory.createStream(proto::Stream_Kind_LENGTH);
+        streamsFactory.createStream(columnId, proto::Stream_Kind_LENGTH);
     directLengthEncoder = createRleEncoder(std::move(directLengthStream), false, rleVersion,
                                            memPool, alignedBitPacking);
-    directDataStream.reset(
-        new AppendOnlyBufferedStream(streamsFactory.createStream(proto::Stream_Kind_DATA)));
+    directDataStream.reset(new AppendOnlyBufferedStream(
+        streamsFactory.createStream(columnId, proto::Stream_Kind_DATA)));
   }
 
   void StringColumnWriter::createDictStreams() {
     std::unique_ptr<BufferedOutputStream> dictDataStream =
-        streamsFactory.createStream(proto::Stream_Kind_DATA);
+        streamsFactory.createStream(columnId, proto::Stream_Kind_DATA);
     dictDataEncoder =
         createRleEncoder(std::move(dictDataStream), false, rleVersion, memPool, alignedBitPacking);
     std::unique_ptr<BufferedOutputStream> dictLengthStream =
-        streamsFactory.createStream(proto::Stream_Kind_LENGTH);
+        streamsFactory.createStream(columnId, proto::Stream_Kind_LENGTH);
     dictLengthEncoder = createRleEncoder(std::move(dictLengthStream), false, rleVersion, memPool,
                                          alignedBitPacking);
     dictStream.reset(new AppendOnlyBufferedStream(
-        streamsFactory.createStream(proto::Stream_Kind_DICTIONARY_DATA)));
+        streamsFactory.createStream(columnId, proto::Stream_Kind_DICTIONARY_DATA)));
   }
 
   void StringColumnWriter::deleteDictStreams() {
@@ -1517,6 +1572,8 @@ namespace orc {
     RleVersion rleVersion_;
     const Timezone* timezone_;
     const bool isUTC_;
+    // the seconds of the batch being added converted to UTC
+    DataBuffer<int64_t> utcSecs_;
   };
 
   TimestampColumnWriter::TimestampColumnWriter(const Type& type, const StreamsFactory& factory,
@@ -1524,11 +1581,12 @@ namespace orc {
       : ColumnWriter(type, factory, options),
         rleVersion_(options.getRleVersion()),
         timezone_(isInstantType ? &getTimezoneByName("GMT") : &options.getTimezone()),
-        isUTC_(isInstantType || options.getTimezoneName() == "GMT") {
+        isUTC_(isInstantType || options.getTimezoneName() == "GMT"),
+        utcSecs_(*options.getMemoryPool()) {
     std::unique_ptr<BufferedOutputStream> dataStream =
-        factory.createStream(proto::Stream_Kind_DATA);
+        factory.createStream(columnId, proto::Stream_Kind_DATA);
     std::unique_ptr<BufferedOutputStream> secondaryStream =
-        factory.createStream(proto::Stream_Kind_SECONDARY);
+        factory.createStream(columnId, proto::Stream_Kind_SECONDARY);
     secRleEncoder = createRleEncoder(std::move(dataStream), true, rleVersion_, memPool,
                                      options.getAlignedBitpacking());
     nanoRleEncoder = createRleEncoder(std::move(secondaryStream), false, rleVersion_, memPool,
@@ -1579,14 +1637,18 @@ namespace orc {
     int64_t* secs = tsBatch->data.data() + offset;
     int64_t* nanos = tsBatch->nanoseconds.data() + offset;
 
+    // TimestampVectorBatch already stores data in UTC
+    const int64_t* utcSecs = secs;
+    if (!isUTC_) {
+      utcSecs_.resize(numValues);
+      timezone_->convertToUTC(secs, utcSecs_.data(), numValues, notNull);
+      utcSecs = utcSecs_.data();
+    }
+
     uint64_t count = 0;
     for (uint64_t i = 0; i < numValues; ++i) {
       if (notNull == nullptr || notNull[i]) {
-        // TimestampVectorBatch already stores data in UTC
-        int64_t millsUTC = secs[i] * 1000 + nanos[i] / 1000000;
-        if (!isUTC_) {
-          millsUTC = timezone_->convertToUTC(secs[i]) * 1000 + nanos[i] / 1000000;
-        }
+        int64_t millsUTC = utcSecs[i] * 1000 + nanos[i] / 1000000;
         ++count;
         if (enableBloomFilter) {
           bloomFilter->addLong(millsUTC);
@@ -1639,7 +1701,7 @@ namespace orc {
     encoding.set_kind(RleVersionMapper(rleVersion_));
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -1744,9 +1806,10 @@ namespace orc {
         rleVersion(options.getRleVersion()),
         precision(type.getPrecision()),
         scale(type.getScale()) {
-    valueStream.reset(new AppendOnlyBufferedStream(factory.createStream(proto::Stream_Kind_DATA)));
+    valueStream.reset(
+        new AppendOnlyBufferedStream(factory.createStream(columnId, proto::Stream_Kind_DATA)));
     std::unique_ptr<BufferedOutputStream> scaleStream =
-        factory.createStream(proto::Stream_Kind_SECONDARY);
+        factory.createStream(columnId, proto::Stream_Kind_SECONDARY);
     scaleEncoder = createRleEncoder(std::move(scaleStream), true, rleVersion, memPool,
                                     options.getAlignedBitpacking());
 
@@ -1834,7 +1897,7 @@ namespace orc {
     encoding.set_kind(RleVersionMapper(rleVersion));
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -1881,7 +1944,7 @@ namespace orc {
         precision(type.getPrecision()),
         scale(type.getScale()) {
     std::unique_ptr<BufferedOutputStream> dataStream =
-        factory.createStream(proto::Stream_Kind_DATA);
+        factory.createStream(columnId, proto::Stream_Kind_DATA);
     valueEncoder = createRleEncoder(std::move(dataStream), true, RleVersion_2, memPool,
                                     options.getAlignedBitpacking());
 
@@ -1949,7 +2012,7 @@ namespace orc {
     encoding.set_kind(RleVersionMapper(RleVersion_2));
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
   }
@@ -2065,7 +2128,7 @@ namespace orc {
 
     virtual void getFileStatistics(std::vector<proto::ColumnStatistics>& stats) const override;
 
-    virtual void mergeStripeStatsIntoFileStats() override;
+    virtual void mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) override;
 
     virtual void mergeRowGroupStatsIntoStripeStats() override;
 
@@ -2077,6 +2140,8 @@ namespace orc {
 
     virtual void writeDictionary() override;
 
+    virtual void finishDictionaryCheck(const ColumnWriter* decidedWriter) override;
+
     virtual void reset() override;
 
     virtual void finishStreams() override;
@@ -2091,7 +2156,7 @@ namespace orc {
                                      const WriterOptions& options)
       : ColumnWriter(type, factory, options), rleVersion_(options.getRleVersion()) {
     std::unique_ptr<BufferedOutputStream> lengthStream =
-        factory.createStream(proto::Stream_Kind_LENGTH);
+        factory.createStream(columnId, proto::Stream_Kind_LENGTH);
     lengthEncoder_ = createRleEncoder(std::move(lengthStream), false, rleVersion_, memPool,
                                       options.getAlignedBitpacking());
 
@@ -2196,7 +2261,7 @@ namespace orc {
     encoding.set_kind(RleVersionMapper(rleVersion_));
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
     if (child_.get()) {
@@ -2211,10 +2276,11 @@ namespace orc {
     }
   }
 
-  void ListColumnWriter::mergeStripeStatsIntoFileStats() {
-    ColumnWriter::mergeStripeStatsIntoFileStats();
+  void ListColumnWriter::mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) {
+    ColumnWriter::mergeStripeStatsIntoFileStats(fileStatsWriter);
     if (child_.get()) {
-      child_->mergeStripeStatsIntoFileStats();
+      auto& target = dynamic_cast<ListColumnWriter&>(fileStatsWriter);
+      child_->mergeStripeStatsIntoFileStats(*target.child_);
     }
   }
 
@@ -2257,6 +2323,13 @@ namespace orc {
     }
   }
 
+  void ListColumnWriter::finishDictionaryCheck(const ColumnWriter* decidedWriter) {
+    auto* decided = dynamic_cast<const ListColumnWriter*>(decidedWriter);
+    if (child_) {
+      child_->finishDictionaryCheck(decided ? decided->child_.get() : nullptr);
+    }
+  }
+
   void ListColumnWriter::finishStreams() {
     ColumnWriter::finishStreams();
     lengthEncoder_->finishEncode();
@@ -2283,7 +2356,7 @@ namespace orc {
 
     virtual void getFileStatistics(std::vector<proto::ColumnStatistics>& stats) const override;
 
-    virtual void mergeStripeStatsIntoFileStats() override;
+    virtual void mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) override;
 
     virtual void mergeRowGroupStatsIntoStripeStats() override;
 
@@ -2295,6 +2368,8 @@ namespace orc {
 
     virtual void writeDictionary() override;
 
+    virtual void finishDictionaryCheck(const ColumnWriter* decidedWriter) override;
+
     virtual void reset() override;
 
     virtual void finishStreams() override;
@@ -2310,7 +2385,7 @@ namespace orc {
                                    const WriterOptions& options)
       : ColumnWriter(type, factory, options), rleVersion_(options.getRleVersion()) {
     std::unique_ptr<BufferedOutputStream> lengthStream =
-        factory.createStream(proto::Stream_Kind_LENGTH);
+        factory.createStream(columnId, proto::Stream_Kind_LENGTH);
     lengthEncoder_ = createRleEncoder(std::move(lengthStream), false, rleVersion_, memPool,
                                       options.getAlignedBitpacking());
 
@@ -2432,7 +2507,7 @@ namespace orc {
     encoding.set_kind(RleVersionMapper(rleVersion_));
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
     if (keyWriter_.get()) {
@@ -2453,13 +2528,14 @@ namespace orc {
     }
   }
 
-  void MapColumnWriter::mergeStripeStatsIntoFileStats() {
-    ColumnWriter::mergeStripeStatsIntoFileStats();
+  void MapColumnWriter::mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) {
+    ColumnWriter::mergeStripeStatsIntoFileStats(fileStatsWriter);
+    auto& target = dynamic_cast<MapColumnWriter&>(fileStatsWriter);
     if (keyWriter_.get()) {
-      keyWriter_->mergeStripeStatsIntoFileStats();
+      keyWriter_->mergeStripeStatsIntoFileStats(*target.keyWriter_);
     }
     if (elemWriter_.get()) {
-      elemWriter_->mergeStripeStatsIntoFileStats();
+      elemWriter_->mergeStripeStatsIntoFileStats(*target.elemWriter_);
     }
   }
 
@@ -2517,6 +2593,16 @@ namespace orc {
     }
   }
 
+  void MapColumnWriter::finishDictionaryCheck(const ColumnWriter* decidedWriter) {
+    auto* decided = dynamic_cast<const MapColumnWriter*>(decidedWriter);
+    if (keyWriter_) {
+      keyWriter_->finishDictionaryCheck(decided ? decided->keyWriter_.get() : nullptr);
+    }
+    if (elemWriter_) {
+      elemWriter_->finishDictionaryCheck(decided ? decided->elemWriter_.get() : nullptr);
+    }
+  }
+
   void MapColumnWriter::finishStreams() {
     ColumnWriter::finishStreams();
     lengthEncoder_->finishEncode();
@@ -2546,7 +2632,7 @@ namespace orc {
 
     virtual void getFileStatistics(std::vector<proto::ColumnStatistics>& stats) const override;
 
-    virtual void mergeStripeStatsIntoFileStats() override;
+    virtual void mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) override;
 
     virtual void mergeRowGroupStatsIntoStripeStats() override;
 
@@ -2558,6 +2644,8 @@ namespace orc {
 
     virtual void writeDictionary() override;
 
+    virtual void finishDictionaryCheck(const ColumnWriter* decidedWriter) override;
+
     virtual void reset() override;
 
     virtual void finishStreams() override;
@@ -2571,7 +2659,7 @@ namespace orc {
                                        const WriterOptions& options)
       : ColumnWriter(type, factory, options) {
     std::unique_ptr<BufferedOutputStream> dataStream =
-        factory.createStream(proto::Stream_Kind_DATA);
+        factory.createStream(columnId, proto::Stream_Kind_DATA);
     rleEncoder_ = createByteRleEncoder(std::move(dataStream));
 
     for (uint64_t i = 0; i != type.getSubtypeCount(); ++i) {
@@ -2672,7 +2760,7 @@ namespace orc {
     encoding.set_kind(proto::ColumnEncoding_Kind_DIRECT);
     encoding.set_dictionary_size(0);
     if (enableBloomFilter) {
-      encoding.set_bloom_encoding(BloomFilterVersion::UTF8);
+      encoding.set_bloom_encoding(bloomFilter->getVersion());
     }
     encodings.push_back(encoding);
     for (uint32_t i = 0; i < children_.size(); ++i) {
@@ -2687,10 +2775,11 @@ namespace orc {
     }
   }
 
-  void UnionColumnWriter::mergeStripeStatsIntoFileStats() {
-    ColumnWriter::mergeStripeStatsIntoFileStats();
+  void UnionColumnWriter::mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter) {
+    ColumnWriter::mergeStripeStatsIntoFileStats(fileStatsWriter);
+    auto& target = dynamic_cast<UnionColumnWriter&>(fileStatsWriter);
     for (uint32_t i = 0; i < children_.size(); ++i) {
-      children_[i]->mergeStripeStatsIntoFileStats();
+      children_[i]->mergeStripeStatsIntoFileStats(*target.children_[i]);
     }
   }
 
@@ -2733,6 +2822,13 @@ namespace orc {
     }
   }
 
+  void UnionColumnWriter::finishDictionaryCheck(const ColumnWriter* decidedWriter) {
+    auto* decided = dynamic_cast<const UnionColumnWriter*>(decidedWriter);
+    for (uint32_t i = 0; i < children_.size(); ++i) {
+      children_[i]->finishDictionaryCheck(decided ? decided->children_[i].get() : nullptr);
+    }
+  }
+
   void UnionColumnWriter::finishStreams() {
     ColumnWriter::finishStreams();
     rleEncoder_->finishEncode();
@@ -37,14 +37,22 @@ namespace orc {
 
     /**
      * Get the stream for the given column/kind in this stripe.
+     * @param columnId the id of the column the stream belongs to
      * @param kind the kind of the stream
      * @return the buffered output stream
      */
-    virtual std::unique_ptr<BufferedOutputStream> createStream(proto::Stream_Kind kind) const = 0;
+    virtual std::unique_ptr<BufferedOutputStream> createStream(uint64_t columnId,
+                                                               proto::Stream_Kind kind) const = 0;
   };
 
-  std::unique_ptr<StreamsFactory> createStreamsFactory(const WriterOptions& options,
-                                                       OutputStream* outStream);
+  /**
+   * @param compressorPool shared by the compressors of all streams; if null,
+   *        the factory creates one
+   * @param executor if not null, the streams compress their blocks on it
+   */
+  std::unique_ptr<StreamsFactory> createStreamsFactory(
+      const WriterOptions& options, OutputStream* outStream,
+      std::shared_ptr<CompressorPool> compressorPool = nullptr, IOExecutor* executor = nullptr);
 
   /**
    * record stream positions for row index
@@ -138,8 +146,11 @@ namespace orc {
 
     /**
      * Merge stripe stats into file stats and reset stripe stats.
+     * @param fileStatsWriter the writer holding the file stats, either this
+     *        one or another writer built for the same type whose stripes
+     *        alternate with the ones of this writer
      */
-    virtual void mergeStripeStatsIntoFileStats();
+    virtual void mergeStripeStatsIntoFileStats(ColumnWriter& fileStatsWriter);
 
     /**
      * Create a row index entry with the previous location and the current
@@ -179,6 +190,14 @@ namespace orc {
      */
     virtual void writeDictionary();
 
+    /**
+     * Decide between dictionary and direct encoding now instead of at the
+     * first row index entry or when the dictionary is written.
+     * @param decidedWriter a writer built for the same type whose decisions
+     *        are taken, or nullptr to decide on the values added so far
+     */
+    virtual void finishDictionaryCheck(const ColumnWriter* decidedWriter);
+
     /**
      * Finalize the encoding and compressing process. This function should be
      * called after all data required for encoding has been added. It ensures
@@ -22,12 +22,19 @@
 #include "Utils.hh"
 #include "lz4.h"
 #include "orc/Exceptions.hh"
+#include "orc/IOExecutor.hh"
 
 #include <algorithm>
 #include <array>
+#include <chrono>
+#include <deque>
+#include <future>
 #include <iomanip>
 #include <iostream>
+#include <mutex>
 #include <sstream>
+#include <stdexcept>
+#include <vector>
 
 #include "zlib.h"
 #include "zstd.h"
@@ -49,11 +56,165 @@
 
 namespace orc {
 
+  struct DeflateStreamDeleter {
+    void operator()(z_stream* strm) const {
+      (void)deflateEnd(strm);
+      delete strm;
+    }
+  };
+
+  struct ZstdCCtxDeleter {
+    void operator()(ZSTD_CCtx* cctx) const {
+      (void)ZSTD_freeCCtx(cctx);
+    }
+  };
+
+  struct Lz4StreamDeleter {
+    void operator()(LZ4_stream_t* state) const {
+      (void)LZ4_freeStream(state);
+    }
+  };
+
+  using DeflateStreamPtr = std::unique_ptr<z_stream, DeflateStreamDeleter>;
+  using ZstdCCtxPtr = std::unique_ptr<ZSTD_CCtx, ZstdCCtxDeleter>;
+  using Lz4StreamPtr = std::unique_ptr<LZ4_stream_t, Lz4StreamDeleter>;
+
+  class CompressorPool {
+   public:
+    explicit CompressorPool(MemoryPool& pool) : memoryPool_(pool) {}
+
+    // Get a buffer with at least the given capacity.
+    std::unique_ptr<DataBuffer<unsigned char>> acquireBuffer(uint64_t capacity);
+    void releaseBuffer(std::unique_ptr<DataBuffer<unsigned char>> buffer);
+
+    // Get a stream initialized for raw deflate at the given level.
+    DeflateStreamPtr acquireDeflateStream(int level);
+    void releaseDeflateStream(int level, DeflateStreamPtr strm);
+
+    ZstdCCtxPtr acquireZstdContext();
+    void releaseZstdContext(ZstdCCtxPtr cctx);
+
+    Lz4StreamPtr acquireLz4State();
+    void releaseLz4State(Lz4StreamPtr state);
+
+   private:
+    MemoryPool& memoryPool_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<DataBuffer<unsigned char>>> buffers_;
+    // deflate streams keep the level they were initialized with
+    std::vector<std::pair<int, DeflateStreamPtr>> deflateStreams_;
+    std::vector<ZstdCCtxPtr> zstdContexts_;
+    std::vector<Lz4StreamPtr> lz4States_;
+  };
+
+  std::unique_ptr<DataBuffer<unsigned char>> CompressorPool::acquireBuffer(uint64_t capacity) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = buffers_.rbegin(); it != buffers_.rend(); ++it) {
+        if ((*it)->size() >= capacity) {
+          std::unique_ptr<DataBuffer<unsigned char>> buffer = std::move(*it);
+          buffers_.erase(std::next(it).base());
+          return buffer;
+        }
+      }
+    }
+    return std::make_unique<DataBuffer<unsigned char>>(memoryPool_, capacity);
+  }
+
+  void CompressorPool::releaseBuffer(std::unique_ptr<DataBuffer<unsigned char>> buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(std::move(buffer));
+  }
+
+  DIAGNOSTIC_PUSH
+
+#if defined(__GNUC__) || defined(__clang__)
+  DIAGNOSTIC_IGNORE("-Wold-style-cast")
+#endif
+
+  DeflateStreamPtr CompressorPool::acquireDeflateStream(int level) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = deflateStreams_.rbegin(); it != deflateStreams_.rend(); ++it) {
+        if (it->first == level) {
+          DeflateStreamPtr strm = std::move(it->second);
+          deflateStreams_.erase(std::next(it).base());
+          return strm;
+        }
+      }
+    }
+    auto strm = std::make_unique<z_stream>();
+    strm->zalloc = nullptr;
+    strm->zfree = nullptr;
+    strm->opaque = nullptr;
+    strm->next_in = nullptr;
+
+    if (deflateInit2(strm.get(), level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
+      throw CompressionError("Error while calling deflateInit2() for zlib.");
+    }
+    return DeflateStreamPtr(strm.release());
+  }
+
+  DIAGNOSTIC_POP
+
+  void CompressorPool::releaseDeflateStream(int level, DeflateStreamPtr strm) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    deflateStreams_.emplace_back(level, std::move(strm));
+  }
+
+  ZstdCCtxPtr CompressorPool::acquireZstdContext() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!zstdContexts_.empty()) {
+        ZstdCCtxPtr cctx = std::move(zstdContexts_.back());
+        zstdContexts_.pop_back();
+        return cctx;
+      }
+    }
+    ZstdCCtxPtr cctx(ZSTD_createCCtx());
+    if (!cctx) {
+      throw CompressionError("Error while calling ZSTD_createCCtx() for zstd.");
+    }
+    return cctx;
+  }
+
+  void CompressorPool::releaseZstdContext(ZstdCCtxPtr cctx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    zstdContexts_.push_back(std::move(cctx));
+  }
+
+  Lz4StreamPtr CompressorPool::acquireLz4State() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!lz4States_.empty()) {
+        Lz4StreamPtr state = std::move(lz4States_.back());
+        lz4States_.pop_back();
+        return state;
+      }
+    }
+    Lz4StreamPtr state(LZ4_createStream());
+    if (!state) {
+      throw CompressionError("Error while allocating state for lz4.");
+    }
+    return state;
+  }
+
+  void CompressorPool::releaseLz4State(Lz4StreamPtr state) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    lz4States_.push_back(std::move(state));
+  }
+
+  std::shared_ptr<CompressorPool> createCompressorPool(MemoryPool& pool) {
+    return std::make_shared<CompressorPool>(pool);
+  }
+
+
   class CompressionStreamBase : public BufferedOutputStream {
    public:
     CompressionStreamBase(OutputStream* outStream, int compressionLevel, uint64_t capacity,
                           uint64_t compressionBlockSize, uint64_t memoryBlockSize, MemoryPool& pool,
-                          WriterMetrics* metrics);
+                          WriterMetrics* metrics, std::shared_ptr<CompressorPool> compressorPool,
+                          IOExecutor* executor);
 
     virtual bool Next(void** data, int* size) override = 0;
     virtual void BackUp(int count) override = 0;
@@ -66,6 +227,7 @@ namespace orc {
       return true;
     }
     virtual uint64_t getSize() const override;
+    virtual uint64_t getExactSize() override;
     virtual uint64_t getRawInputBufferSize() const override = 0;
     virtual void finishStream() override = 0;
 
@@ -81,6 +243,29 @@ namespace orc {
     // ensure enough room for compression block header
     void ensureHeader();
 
+    // compresses a block into output, which holds at least
+    // estimateMaxCompressionSize(inputSize) bytes, and returns the compressed
+    // size. It may run on an executor thread, so it must not touch the state
+    // of the stream other than the level and compressorPool.
+    virtual uint64_t compressBlock(const unsigned char* input, size_t inputSize,
+                                   unsigned char* output, size_t outputSize) = 0;
+
+    // return maximum possible compression size of the given input size
+    virtual uint64_t estimateMaxCompressionSize(uint64_t size) = 0;
+
+    // hands a block borrowed from compressorPool over to the executor
+    void submitBlock(std::unique_ptr<DataBuffer<unsigned char>> input, uint64_t inputSize);
+
+    // writes the submitted blocks that are already compressed, in order
+    void writeFinishedBlocks();
+
+    // waits for all submitted blocks and writes them
+    void writePendingBlocks();
+
+    // waits for all submitted blocks and drops them; the leaf classes call it
+    // in their destructors because the blocks call compressBlock()
+    void discardPendingBlocks();
+
     // Compress level
     int level;
 
@@ -102,25 +287,116 @@ namespace orc {
 
     // Compression block size
     uint64_t compressionBlockSize;
+
+    // Contexts and scratch buffers are borrowed from it for each block
+    std::shared_ptr<CompressorPool> compressorPool;
+
+    // Compresses full blocks if not null
+    IOExecutor* executor;
+
+   private:
+    struct PendingBlock {
+      std::unique_ptr<DataBuffer<unsigned char>> input;
+      uint64_t inputSize;
+      std::unique_ptr<DataBuffer<unsigned char>> output;
+      uint64_t compressedSize;
+      std::future<void> done;
+    };
+
+    void writeBlock(PendingBlock& block);
+
+    // blocks handed to the executor in the order they are written
+    std::deque<std::unique_ptr<PendingBlock>> pendingBlocks_;
+    // uncompressed size of the pending blocks including their headers
+    uint64_t pendingSize_;
   };
 
   CompressionStreamBase::CompressionStreamBase(OutputStream* outStream, int compressionLevel,
                                                uint64_t capacity, uint64_t compressionBlockSize,
                                                uint64_t memoryBlockSize, MemoryPool& pool,
-                                               WriterMetrics* metrics)
+                                               WriterMetrics* metrics,
+                                               std::shared_ptr<CompressorPool> compressorPool,
+                                               IOExecutor* executor)
       : BufferedOutputStream(pool, outStream, capacity, memoryBlockSize, metrics),
         level(compressionLevel),
         outputBuffer(nullptr),
         bufferSize(0),
         outputPosition(0),
         outputSize(0),
-        compressionBlockSize(compressionBlockSize) {
+        compressionBlockSize(compressionBlockSize),
+        compressorPool(std::move(compressorPool)),
+        executor(executor),
+        pendingSize_(0) {
     // init header pointer array
     header.fill(nullptr);
   }
 
   uint64_t CompressionStreamBase::getSize() const {
-    return BufferedOutputStream::getSize() - static_cast<uint64_t>(outputSize - outputPosition);
+    return BufferedOutputStream::getSize() - static_cast<uint64_t>(outputSize - outputPosition) +
+           pendingSize_;
+  }
+
+  uint64_t CompressionStreamBase::getExactSize() {
+    writePendingBlocks();
+    return getSize();
+  }
+
+  void CompressionStreamBase::submitBlock(std::unique_ptr<DataBuffer<unsigned char>> input,
+                                          uint64_t inputSize) {
+    auto block = std::make_unique<PendingBlock>();
+    block->input = std::move(input);
+    block->inputSize = inputSize;
+    block->output = compressorPool->acquireBuffer(estimateMaxCompressionSize(inputSize));
+    block->compressedSize = 0;
+    PendingBlock* task = block.get();
+    block->done = executor->submit(this, [this, task] {
+      task->compressedSize = compressBlock(task->input->data(), task->inputSize,
+                                           task->output->data(), task->output->size());
+    });
+    pendingSize_ += inputSize + HEADER_SIZE;
+    pendingBlocks_.push_back(std::move(block));
+    writeFinishedBlocks();
+  }
+
+  void CompressionStreamBase::writeBlock(PendingBlock& block) {
+    // rethrows the error of a failed compression
+    block.done.get();
+    pendingSize_ -= block.inputSize + HEADER_SIZE;
+    ensureHeader();
+    if (block.compressedSize >= block.inputSize) {
+      writeHeader(block.inputSize, true);
+      writeData(block.input->data(), static_cast<int>(block.inputSize));
+    } else {
+      writeHeader(block.compressedSize, false);
+      writeData(block.output->data(), static_cast<int>(block.compressedSize));
+    }
+    compressorPool->releaseBuffer(std::move(block.input));
+    compressorPool->releaseBuffer(std::move(block.output));
+  }
+
+  void CompressionStreamBase::writeFinishedBlocks() {
+    while (!pendingBlocks_.empty() && pendingBlocks_.front()->done.wait_for(
+                                          std::chrono::seconds(0)) == std::future_status::ready) {
+      std::unique_ptr<PendingBlock> block = std::move(pendingBlocks_.front());
+      pendingBlocks_.pop_front();
+      writeBlock(*block);
+    }
+  }
+
+  void CompressionStreamBase::writePendingBlocks() {
+    while (!pendingBlocks_.empty()) {
+      std::unique_ptr<PendingBlock> block = std::move(pendingBlocks_.front());
+      pendingBlocks_.pop_front();
+      writeBlock(*block);
+    }
+  }
+
+  void CompressionStreamBase::discardPendingBlocks() {
+    for (auto& block : pendingBlocks_) {
+      block->done.wait();
+    }
+    pendingBlocks_.clear();
+    pendingSize_ = 0;
   }
 
   // write the data content into outputBuffer
@@ -164,7 +440,8 @@ namespace orc {
    public:
     CompressionStream(OutputStream* outStream, int compressionLevel, uint64_t capacity,
                       uint64_t compressionBlockSize, uint64_t memoryBlockSize, MemoryPool& pool,
-                      WriterMetrics* metrics);
+                      WriterMetrics* metrics, std::shared_ptr<CompressorPool> compressorPool,
+                      IOExecutor* executor);
 
     virtual bool Next(void** data, int* size) override;
     virtual std::string getName() const override = 0;
@@ -176,6 +453,7 @@ namespace orc {
     }
     virtual void finishStream() override {
       compressInternal();
+      writePendingBlocks();
       BufferedOutputStream::finishStream();
     }
 
@@ -200,6 +478,7 @@ namespace orc {
 
   uint64_t CompressionStream::flush() {
     compressInternal();
+    writePendingBlocks();
     BufferedOutputStream::BackUp(outputSize - outputPosition);
     rawInputBuffer.resize(0);
     outputSize = outputPosition = 0;
@@ -207,6 +486,7 @@ namespace orc {
   }
 
   void CompressionStream::suppress() {
+    discardPendingBlocks();
     outputBuffer = nullptr;
     outputPosition = outputSize = 0;
     rawInputBuffer.resize(0);
@@ -216,15 +496,29 @@ namespace orc {
   CompressionStream::CompressionStream(OutputStream* outStream, int compressionLevel,
                                        uint64_t capacity, uint64_t compressionBlockSize,
                                        uint64_t memoryBlockSize, MemoryPool& pool,
-                                       WriterMetrics* metrics)
+                                       WriterMetrics* metrics,
+                                       std::shared_ptr<CompressorPool> compressorPool,
+                                       IOExecutor* executor)
       : CompressionStreamBase(outStream, compressionLevel, capacity, compressionBlockSize,
-                              memoryBlockSize, pool, metrics),
+                              memoryBlockSize, pool, metrics, std::move(compressorPool), executor),
         rawInputBuffer(pool, memoryBlockSize) {
     // PASS
   }
 
   void CompressionStream::compressInternal() {
-    if (rawInputBuffer.size() != 0) {
+    if (rawInputBuffer.size() != 0 && executor) {
+      // the executor needs the block in one piece
+      std::unique_ptr<DataBuffer<unsigned char>> input =
+          compressorPool->acquireBuffer(compressionBlockSize);
+      uint64_t inputSize = 0;
+      for (uint64_t i = 0; i < rawInputBuffer.getBlockNumber(); ++i) {
+        auto block = rawInputBuffer.getBlock(i);
+        memcpy(input->data() + inputSize, block.data, block.size);
+        inputSize += block.size;
+      }
+      rawInputBuffer.resize(0);
+      submitBlock(std::move(input), inputSize);
+    } else if (rawInputBuffer.size() != 0) {
       ensureHeader();
 
       uint64_t preSize = getSize();
@@ -273,10 +567,11 @@ namespace orc {
    public:
     ZlibCompressionStream(OutputStream* outStream, int compressionLevel, uint64_t bufferCapacity,
                           uint64_t compressionBlockSize, uint64_t memoryBlockSize, MemoryPool& pool,
-                          WriterMetrics* metrics);
+                          WriterMetrics* metrics, std::shared_ptr<CompressorPool> compressorPool,
+                          IOExecutor* executor);
 
     virtual ~ZlibCompressionStream() override {
-      end();
+      discardPendingBlocks();
     }
 
     virtual std::string getName() const override;
@@ -284,24 +579,39 @@ namespace orc {
    protected:
     virtual uint64_t doStreamingCompression() override;
 
+    virtual uint64_t compressBlock(const unsigned char* input, size_t inputSize,
+                                   unsigned char* output, size_t outputSize) override;
+
+    virtual uint64_t estimateMaxCompressionSize(uint64_t size) override {
+      return compressBound(static_cast<uLong>(size));
+    }
+
    private:
-    void init();
-    void end();
-    z_stream strm_;
+    uint64_t deflateBlocks(z_stream& strm);
   };
 
   ZlibCompressionStream::ZlibCompressionStream(OutputStream* outStream, int compressionLevel,
                                                uint64_t bufferCapacity,
                                                uint64_t compressionBlockSize,
                                                uint64_t memoryBlockSize, MemoryPool& pool,
-                                               WriterMetrics* metrics)
+                                               WriterMetrics* metrics,
+                                               std::shared_ptr<CompressorPool> compressorPool,
+                                               IOExecutor* executor)
       : CompressionStream(outStream, compressionLevel, bufferCapacity, compressionBlockSize,
-                          memoryBlockSize, pool, metrics) {
-    init();
+                          memoryBlockSize, pool, metrics, std::move(compressorPool), executor) {
+    // PASS
   }
 
   uint64_t ZlibCompressionStream::doStreamingCompression() {
-    if (deflateReset(&strm_) != Z_OK) {
+    // the stream is only returned on success, a failed one is freed
+    DeflateStreamPtr strm = compressorPool->acquireDeflateStream(level);
+    uint64_t compressedSize = deflateBlocks(*strm);
+    compressorPool->releaseDeflateStream(level, std::move(strm));
+    return compressedSize;
+  }
+
+  uint64_t ZlibCompressionStream::deflateBlocks(z_stream& strm) {
+    if (deflateReset(&strm) != Z_OK) {
       throw CompressionError("Failed to reset inflate.");
     }
 
@@ -312,12 +622,12 @@ namespace orc {
     do {
       if (blockId == rawInputBuffer.getBlockNumber()) {
         finish = true;
-        strm_.avail_in = 0;
-        strm_.next_in = nullptr;
+        strm.avail_in = 0;
+        strm.next_in = nullptr;
       } else {
         auto block = rawInputBuffer.getBlock(blockId++);
-        strm_.avail_in = static_cast<unsigned int>(block.size);
-        strm_.next_in = reinterpret_cast<unsigned char*>(block.data);
+        strm.avail_in = static_cast<unsigned int>(block.size);
+        strm.next_in = reinterpret_cast<unsigned char*>(block.data);
       }
 
       do {
@@ -327,11 +637,11 @@ namespace orc {
           }
           outputPosition = 0;
         }
-        strm_.next_out = reinterpret_cast<unsigned char*>(outputBuffer + outputPosition);
-        strm_.avail_out = static_cast<unsigned int>(outputSize - outputPosition);
+        strm.next_out = reinterpret_cast<unsigned char*>(outputBuffer + outputPosition);
+        strm.avail_out = static_cast<unsigned int>(outputSize - outputPosition);
 
-        int ret = deflate(&strm_, finish ? Z_FINISH : Z_NO_FLUSH);
-        outputPosition = outputSize - static_cast<int>(strm_.avail_out);
+        int ret = deflate(&strm, finish ? Z_FINISH : Z_NO_FLUSH);
+        outputPosition = outputSize - static_cast<int>(strm.avail_out);
 
         if (ret == Z_STREAM_END) {
           break;
@@ -340,38 +650,33 @@ namespace orc {
         } else {
           throw CompressionError("Failed to deflate input data.");
         }
-      } while (strm_.avail_out == 0);
+      } while (strm.avail_out == 0);
     } while (!finish);
-    return strm_.total_out;
-  }
-
-  std::string ZlibCompressionStream::getName() const {
-    return "ZlibCompressionStream";
+    return strm.total_out;
   }
 
-  DIAGNOSTIC_PUSH
-
-#if defined(__GNUC__) || defined(__clang__)
-  DIAGNOSTIC_IGNORE("-Wold-style-cast")
-#endif
-
-  void ZlibCompressionStream::init() {
-    strm_.zalloc = nullptr;
-    strm_.zfree = nullptr;
-    strm_.opaque = nullptr;
-    strm_.next_in = nullptr;
-
-    if (deflateInit2(&strm_, level, Z_DEFLATED, -15, 8, Z_DEFAULT_STRATEGY) != Z_OK) {
-      throw CompressionError("Error while calling deflateInit2() for zlib.");
+  uint64_t ZlibCompressionStream::compressBlock(const unsigned char* input, size_t inputSize,
+                                                unsigned char* output, size_t outputSize) {
+    DeflateStreamPtr strm = compressorPool->acquireDeflateStream(level);
+    if (deflateReset(strm.get()) != Z_OK) {
+      throw CompressionError("Failed to reset inflate.");
     }
+    strm->next_in = const_cast<unsigned char*>(input);
+    strm->avail_in = static_cast<unsigned int>(inputSize);
+    strm->next_out = output;
+    strm->avail_out = static_cast<unsigned int>(outputSize);
+    if (deflate(strm.get(), Z_FINISH) != Z_STREAM_END) {
+      throw CompressionError("Failed to deflate input data.");
+    }
+    uint64_t compressedSize = strm->total_out;
+    compressorPool->releaseDeflateStream(level, std::move(strm));
+    return compressedSize;
   }
 
-  void ZlibCompressionStream::end() {
-    (void)deflateEnd(&strm_);
+  std::string ZlibCompressionStream::getName() const {
+    return "ZlibCompressionStream";
   }
 
-  DIAGNOSTIC_PUSH
-
   enum DecompressState {
     DECOMPRESS_HEADER,
     DECOMPRESS_START,
@@ -396,11 +701,158 @@ namespace orc {
     return "unknown";
   }
 
+  class DecompressorPool {
+   public:
+    explicit DecompressorPool(MemoryPool& pool) : memoryPool_(pool) {}
+    ~DecompressorPool();
+
+    // Get a buffer with exactly the given capacity.
+    std::unique_ptr<DataBuffer<char>> acquireBuffer(uint64_t capacity);
+    void releaseBuffer(std::unique_ptr<DataBuffer<char>> buffer);
+
+    // Get a stream initialized for raw inflate.
+    std::unique_ptr<z_stream> acquireZlibStream();
+    void releaseZlibStream(std::unique_ptr<z_stream> zstream);
+
+    ZSTD_DCtx* acquireZstdContext();
+    void releaseZstdContext(ZSTD_DCtx* dctx);
+
+    // Free everything that isn't borrowed.
+    void releaseIdle();
+
+   private:
+    MemoryPool& memoryPool_;
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<DataBuffer<char>>> buffers_;
+    std::vector<std::unique_ptr<z_stream>> zlibStreams_;
+    std::vector<ZSTD_DCtx*> zstdContexts_;
+  };
+
+  DecompressorPool::~DecompressorPool() {
+    releaseIdle();
+  }
+
+  void DecompressorPool::releaseIdle() {
+    std::vector<std::unique_ptr<DataBuffer<char>>> buffers;
+    std::vector<std::unique_ptr<z_stream>> zlibStreams;
+    std::vector<ZSTD_DCtx*> zstdContexts;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      buffers.swap(buffers_);
+      zlibStreams.swap(zlibStreams_);
+      zstdContexts.swap(zstdContexts_);
+    }
+    for (auto& zstream : zlibStreams) {
+      (void)inflateEnd(zstream.get());
+    }
+    for (ZSTD_DCtx* dctx : zstdContexts) {
+      (void)ZSTD_freeDCtx(dctx);
+    }
+  }
+
+  std::unique_ptr<DataBuffer<char>> DecompressorPool::acquireBuffer(uint64_t capacity) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (auto it = buffers_.rbegin(); it != buffers_.rend(); ++it) {
+        if ((*it)->capacity() == capacity) {
+          std::unique_ptr<DataBuffer<char>> buffer = std::move(*it);
+          buffers_.erase(std::next(it).base());
+          return buffer;
+        }
+      }
+    }
+    return std::make_unique<DataBuffer<char>>(memoryPool_, capacity);
+  }
+
+  void DecompressorPool::releaseBuffer(std::unique_ptr<DataBuffer<char>> buffer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    buffers_.push_back(std::move(buffer));
+  }
+
+  DIAGNOSTIC_PUSH
+
+#if defined(__GNUC__) || defined(__clang__)
+  DIAGNOSTIC_IGNORE("-Wold-style-cast")
+#endif
+
+  std::unique_ptr<z_stream> DecompressorPool::acquireZlibStream() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!zlibStreams_.empty()) {
+        std::unique_ptr<z_stream> zstream = std::move(zlibStreams_.back());
+        zlibStreams_.pop_back();
+        return zstream;
+      }
+    }
+    auto zstream = std::make_unique<z_stream>();
+    zstream->next_in = nullptr;
+    zstream->avail_in = 0;
+    zstream->zalloc = nullptr;
+    zstream->zfree = nullptr;
+    zstream->opaque = nullptr;
+    zstream->next_out = nullptr;
+    zstream->avail_out = 0;
+    int64_t result = inflateInit2(zstream.get(), -15);
+    switch (result) {
+      case Z_OK:
+        return zstream;
+      case Z_MEM_ERROR:
+        throw CompressionError(
+            "Memory error from ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
+      case Z_VERSION_ERROR:
+        throw CompressionError(
+            "Version error from ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
+      case Z_STREAM_ERROR:
+        throw CompressionError(
+            "Stream error from ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
+      default:
+        throw CompressionError(
+            "Unknown error from  ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
+    }
+  }
+
+  DIAGNOSTIC_POP
+
+  void DecompressorPool::releaseZlibStream(std::unique_ptr<z_stream> zstream) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    zlibStreams_.push_back(std::move(zstream));
+  }
+
+  ZSTD_DCtx* DecompressorPool::acquireZstdContext() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!zstdContexts_.empty()) {
+        ZSTD_DCtx* dctx = zstdContexts_.back();
+        zstdContexts_.pop_back();
+        return dctx;
+      }
+    }
+    ZSTD_DCtx* dctx = ZSTD_createDCtx();
+    if (!dctx) {
+      throw CompressionError("Error while calling ZSTD_createDCtx() for zstd.");
+    }
+    return dctx;
+  }
+
+  void DecompressorPool::releaseZstdContext(ZSTD_DCtx* dctx) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    zstdContexts_.push_back(dctx);
+  }
+
+  std::shared_ptr<DecompressorPool> createDecompressorPool(MemoryPool& pool) {
+    return std::make_shared<DecompressorPool>(pool);
+  }
+
+  void releaseIdleDecompressors(DecompressorPool& pool) {
+    pool.releaseIdle();
+  }
+
   class DecompressionStream : public SeekableInputStream {
    public:
     DecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t bufferSize,
-                        MemoryPool& pool, ReaderMetrics* metrics);
-    virtual ~DecompressionStream() override {}
+                        MemoryPool& pool, ReaderMetrics* metrics,
+                        std::shared_ptr<DecompressorPool> decompressorPool);
+    virtual ~DecompressionStream() override;
     virtual bool Next(const void** data, int* size) override;
     virtual void BackUp(int count) override;
     virtual bool Skip(int count) override;
@@ -422,8 +874,10 @@ namespace orc {
     // the configured compression block size, used to validate chunk lengths
     size_t blockSize;
 
-    // uncompressed output
-    DataBuffer<char> outputDataBuffer;
+    // borrowed from decompressorPool when the first chunk is decompressed
+    std::shared_ptr<DecompressorPool> decompressorPool;
+    // uncompressed output, holds blockSize bytes once borrowed
+    std::unique_ptr<DataBuffer<char>> outputDataBuffer;
 
     // the current state
     DecompressState state;
@@ -460,11 +914,12 @@ namespace orc {
 
   DecompressionStream::DecompressionStream(std::unique_ptr<SeekableInputStream> inStream,
                                            size_t bufferSize, MemoryPool& pool,
-                                           ReaderMetrics* metrics)
+                                           ReaderMetrics* metrics,
+                                           std::shared_ptr<DecompressorPool> decompressorPool)
       : pool(pool),
         input(std::move(inStream)),
         blockSize(bufferSize),
-        outputDataBuffer(pool, bufferSize),
+        decompressorPool(std::move(decompressorPool)),
         state(DECOMPRESS_HEADER),
         outputBufferStart(nullptr),
         outputBuffer(nullptr),
@@ -479,6 +934,12 @@ namespace orc {
         bytesReturned(0),
         metrics(metrics) {}
 
+  DecompressionStream::~DecompressionStream() {
+    if (outputDataBuffer) {
+      decompressorPool->releaseBuffer(std::move(outputDataBuffer));
+    }
+  }
+
   std::string DecompressionStream::getStreamName() const {
     return input->getName();
   }
@@ -570,6 +1031,9 @@ namespace orc {
       inputBuffer += availableSize;
       remainingLength -= availableSize;
     } else if (state == DECOMPRESS_START) {
+      if (!outputDataBuffer) {
+        outputDataBuffer = decompressorPool->acquireBuffer(blockSize);
+      }
       NextDecompress(data, size, availableSize);
     } else {
       throw CompressionError(
@@ -681,7 +1145,8 @@ namespace orc {
   class ZlibDecompressionStream : public DecompressionStream {
    public:
     ZlibDecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t blockSize,
-                            MemoryPool& pool, ReaderMetrics* metrics);
+                            MemoryPool& pool, ReaderMetrics* metrics,
+                            std::shared_ptr<DecompressorPool> decompressorPool);
     virtual ~ZlibDecompressionStream() override;
     virtual std::string getName() const override;
 
@@ -689,69 +1154,42 @@ namespace orc {
     virtual void NextDecompress(const void** data, int* size, size_t availableSize) override;
 
    private:
-    z_stream zstream_;
+    // borrowed from decompressorPool when the first chunk is decompressed
+    std::unique_ptr<z_stream> zstream_;
   };
 
-  DIAGNOSTIC_PUSH
-
-#if defined(__GNUC__) || defined(__clang__)
-  DIAGNOSTIC_IGNORE("-Wold-style-cast")
-#endif
-
-  ZlibDecompressionStream::ZlibDecompressionStream(std::unique_ptr<SeekableInputStream> inStream,
-                                                   size_t bufferSize, MemoryPool& pool,
-                                                   ReaderMetrics* metrics)
-      : DecompressionStream(std::move(inStream), bufferSize, pool, metrics) {
-    zstream_.next_in = nullptr;
-    zstream_.avail_in = 0;
-    zstream_.zalloc = nullptr;
-    zstream_.zfree = nullptr;
-    zstream_.opaque = nullptr;
-    zstream_.next_out = reinterpret_cast<Bytef*>(outputDataBuffer.data());
-    zstream_.avail_out = static_cast<uInt>(outputDataBuffer.capacity());
-    int64_t result = inflateInit2(&zstream_, -15);
-    switch (result) {
-      case Z_OK:
-        break;
-      case Z_MEM_ERROR:
-        throw CompressionError(
-            "Memory error from ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
-      case Z_VERSION_ERROR:
-        throw CompressionError(
-            "Version error from ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
-      case Z_STREAM_ERROR:
-        throw CompressionError(
-            "Stream error from ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
-      default:
-        throw CompressionError(
-            "Unknown error from  ZlibDecompressionStream::ZlibDecompressionStream inflateInit2");
-    }
+  ZlibDecompressionStream::ZlibDecompressionStream(
+      std::unique_ptr<SeekableInputStream> inStream, size_t bufferSize, MemoryPool& pool,
+      ReaderMetrics* metrics, std::shared_ptr<DecompressorPool> decompressorPool)
+      : DecompressionStream(std::move(inStream), bufferSize, pool, metrics,
+                            std::move(decompressorPool)) {
+    // PASS
   }
 
-  DIAGNOSTIC_POP
-
   ZlibDecompressionStream::~ZlibDecompressionStream() {
-    int64_t result = inflateEnd(&zstream_);
-    if (result != Z_OK) {
-      // really can't throw in destructors
-      std::cout << "Error in ~ZlibDecompressionStream() " << result << "\n";
+    if (zstream_) {
+      decompressorPool->releaseZlibStream(std::move(zstream_));
     }
   }
 
   void ZlibDecompressionStream::NextDecompress(const void** data, int* size, size_t availableSize) {
-    zstream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(inputBuffer));
-    zstream_.avail_in = static_cast<uInt>(availableSize);
-    outputBuffer = outputDataBuffer.data();
-    zstream_.next_out = reinterpret_cast<Bytef*>(const_cast<char*>(outputBuffer));
-    zstream_.avail_out = static_cast<uInt>(outputDataBuffer.capacity());
-    if (inflateReset(&zstream_) != Z_OK) {
+    if (!zstream_) {
+      zstream_ = decompressorPool->acquireZlibStream();
+    }
+    zstream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(inputBuffer));
+    zstream_->avail_in = static_cast<uInt>(availableSize);
+    outputBuffer = outputDataBuffer->data();
+    zstream_->next_out = reinterpret_cast<Bytef*>(const_cast<char*>(outputBuffer));
+    zstream_->avail_out = static_cast<uInt>(blockSize);
+    if (inflateReset(zstream_.get()) != Z_OK) {
       throw CompressionError(
           "Bad inflateReset in "
           "ZlibDecompressionStream::NextDecompress");
     }
     int64_t result;
     do {
-      result = inflate(&zstream_, availableSize == remainingLength ? Z_FINISH : Z_SYNC_FLUSH);
+      result =
+          inflate(zstream_.get(), availableSize == remainingLength ? Z_FINISH : Z_SYNC_FLUSH);
       switch (result) {
         case Z_OK:
           remainingLength -= availableSize;
@@ -759,8 +1197,8 @@ namespace orc {
           readBuffer(true);
           availableSize =
               std::min(static_cast<size_t>(inputBufferEnd - inputBuffer), remainingLength);
-          zstream_.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(inputBuffer));
-          zstream_.avail_in = static_cast<uInt>(availableSize);
+          zstream_->next_in = reinterpret_cast<Bytef*>(const_cast<char*>(inputBuffer));
+          zstream_->avail_in = static_cast<uInt>(availableSize);
           break;
         case Z_STREAM_END:
           break;
@@ -782,7 +1220,7 @@ namespace orc {
               "ZlibDecompressionStream::NextDecompress");
       }
     } while (result != Z_STREAM_END);
-    *size = static_cast<int>(outputDataBuffer.capacity() - zstream_.avail_out);
+    *size = static_cast<int>(blockSize - zstream_->avail_out);
     *data = outputBuffer;
     outputBufferLength = 0;
     outputBuffer += *size;
@@ -799,9 +1237,10 @@ namespace orc {
   class BlockDecompressionStream : public DecompressionStream {
    public:
     BlockDecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t blockSize,
-                             MemoryPool& pool, ReaderMetrics* metrics);
+                             MemoryPool& pool, ReaderMetrics* metrics,
+                             std::shared_ptr<DecompressorPool> decompressorPool);
 
-    virtual ~BlockDecompressionStream() override {}
+    virtual ~BlockDecompressionStream() override;
     virtual std::string getName() const override = 0;
 
    protected:
@@ -812,15 +1251,23 @@ namespace orc {
 
    private:
     // may need to stitch together multiple input buffers;
-    // to give snappy a contiguous block
-    DataBuffer<char> inputDataBuffer_;
+    // to give snappy a contiguous block. Borrowed when first needed.
+    std::unique_ptr<DataBuffer<char>> inputDataBuffer_;
   };
 
-  BlockDecompressionStream::BlockDecompressionStream(std::unique_ptr<SeekableInputStream> inStream,
-                                                     size_t blockSize, MemoryPool& pool,
-                                                     ReaderMetrics* metrics)
-      : DecompressionStream(std::move(inStream), blockSize, pool, metrics),
-        inputDataBuffer_(pool, blockSize) {}
+  BlockDecompressionStream::BlockDecompressionStream(
+      std::unique_ptr<SeekableInputStream> inStream, size_t blockSize, MemoryPool& pool,
+      ReaderMetrics* metrics, std::shared_ptr<DecompressorPool> decompressorPool)
+      : DecompressionStream(std::move(inStream), blockSize, pool, metrics,
+                            std::move(decompressorPool)) {
+    // PASS
+  }
+
+  BlockDecompressionStream::~BlockDecompressionStream() {
+    if (inputDataBuffer_) {
+      decompressorPool->releaseBuffer(std::move(inputDataBuffer_));
+    }
+  }
 
   void BlockDecompressionStream::NextDecompress(const void** data, int* size,
                                                 size_t availableSize) {
@@ -830,37 +1277,40 @@ namespace orc {
       inputBuffer += availableSize;
     } else {
       // Did not read enough from input.
-      if (inputDataBuffer_.capacity() < remainingLength) {
-        inputDataBuffer_.resize(remainingLength);
+      // readHeader() checked that the chunk fits in blockSize
+      if (!inputDataBuffer_) {
+        inputDataBuffer_ = decompressorPool->acquireBuffer(blockSize);
       }
-      ::memcpy(inputDataBuffer_.data(), inputBuffer, availableSize);
+      ::memcpy(inputDataBuffer_->data(), inputBuffer, availableSize);
       inputBuffer += availableSize;
-      compressed = inputDataBuffer_.data();
+      compressed = inputDataBuffer_->data();
 
       for (size_t pos = availableSize; pos < remainingLength;) {
         readBuffer(true);
         size_t avail =
             std::min(static_cast<size_t>(inputBufferEnd - inputBuffer), remainingLength - pos);
-        ::memcpy(inputDataBuffer_.data() + pos, inputBuffer, avail);
+        ::memcpy(inputDataBuffer_->data() + pos, inputBuffer, avail);
         pos += avail;
         inputBuffer += avail;
       }
     }
-    outputBufferLength = decompress(compressed, remainingLength, outputDataBuffer.data(),
-                                    outputDataBuffer.capacity());
+    outputBufferLength =
+        decompress(compressed, remainingLength, outputDataBuffer->data(), blockSize);
     remainingLength = 0;
     state = DECOMPRESS_HEADER;
-    *data = outputDataBuffer.data();
+    *data = outputDataBuffer->data();
     *size = static_cast<int>(outputBufferLength);
-    outputBuffer = outputDataBuffer.data() + outputBufferLength;
+    outputBuffer = outputDataBuffer->data() + outputBufferLength;
     outputBufferLength = 0;
   }
 
   class SnappyDecompressionStream : public BlockDecompressionStream {
    public:
     SnappyDecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t blockSize,
-                              MemoryPool& pool, ReaderMetrics* metrics)
-        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics) {
+                              MemoryPool& pool, ReaderMetrics* metrics,
+                              std::shared_ptr<DecompressorPool> decompressorPool)
+        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics,
+                                   std::move(decompressorPool)) {
       // PASS
     }
 
@@ -895,8 +1345,10 @@ namespace orc {
   class LzoDecompressionStream : public BlockDecompressionStream {
    public:
     LzoDecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t blockSize,
-                           MemoryPool& pool, ReaderMetrics* metrics)
-        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics) {
+                           MemoryPool& pool, ReaderMetrics* metrics,
+                           std::shared_ptr<DecompressorPool> decompressorPool)
+        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics,
+                                   std::move(decompressorPool)) {
       // PASS
     }
 
@@ -919,8 +1371,10 @@ namespace orc {
   class Lz4DecompressionStream : public BlockDecompressionStream {
    public:
     Lz4DecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t blockSize,
-                           MemoryPool& pool, ReaderMetrics* metrics)
-        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics) {
+                           MemoryPool& pool, ReaderMetrics* metrics,
+                           std::shared_ptr<DecompressorPool> decompressorPool)
+        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics,
+                                   std::move(decompressorPool)) {
       // PASS
     }
 
@@ -951,10 +1405,10 @@ namespace orc {
   class BlockCompressionStream : public CompressionStreamBase {
    public:
     BlockCompressionStream(OutputStream* outStream, int compressionLevel, uint64_t capacity,
-                           uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics)
+                           uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics,
+                           std::shared_ptr<CompressorPool> compressorPool, IOExecutor* executor)
         : CompressionStreamBase(outStream, compressionLevel, capacity, blockSize, blockSize, pool,
-                                metrics),
-          compressorBuffer(pool),
+                                metrics, std::move(compressorPool), executor),
           rawInputBuffer(pool, blockSize) {
       // PASS
     }
@@ -971,16 +1425,6 @@ namespace orc {
     virtual void finishStream() override;
 
    protected:
-    // compresses a block and returns the compressed size
-    virtual uint64_t doBlockCompression() = 0;
-
-    // return maximum possible compression size for allocating space for
-    // compressorBuffer below
-    virtual uint64_t estimateMaxCompressionSize() = 0;
-
-    // should allocate max possible compressed size
-    DataBuffer<unsigned char> compressorBuffer;
-
     // Buffer to hold uncompressed data until user calls Next()
     DataBuffer<unsigned char> rawInputBuffer;
   };
@@ -998,11 +1442,21 @@ namespace orc {
   }
 
   bool BlockCompressionStream::Next(void** data, int* size) {
-    if (bufferSize != 0) {
+    if (bufferSize != 0 && executor) {
+      std::unique_ptr<DataBuffer<unsigned char>> input =
+          compressorPool->acquireBuffer(rawInputBuffer.size());
+      memcpy(input->data(), rawInputBuffer.data(), static_cast<size_t>(bufferSize));
+      submitBlock(std::move(input), static_cast<uint64_t>(bufferSize));
+    } else if (bufferSize != 0) {
       ensureHeader();
 
-      // perform compression
-      size_t totalCompressedSize = doBlockCompression();
+      // perform compression, sizing the buffer for a full block so that
+      // any pooled buffer fits any block
+      std::unique_ptr<DataBuffer<unsigned char>> compressorBuffer =
+          compressorPool->acquireBuffer(estimateMaxCompressionSize(rawInputBuffer.size()));
+      size_t totalCompressedSize =
+          compressBlock(rawInputBuffer.data(), static_cast<size_t>(bufferSize),
+                        compressorBuffer->data(), compressorBuffer->size());
 
       const unsigned char* dataToWrite = nullptr;
       int totalSizeToWrite = 0;
@@ -1013,23 +1467,23 @@ namespace orc {
         totalSizeToWrite = bufferSize;
       } else {
         writeHeader(totalCompressedSize, false);
-        dataToWrite = compressorBuffer.data();
+        dataToWrite = compressorBuffer->data();
         totalSizeToWrite = static_cast<int>(totalCompressedSize);
       }
 
       writeData(dataToWrite, totalSizeToWrite);
+      compressorPool->releaseBuffer(std::move(compressorBuffer));
     }
 
     *data = rawInputBuffer.data();
     *size = static_cast<int>(rawInputBuffer.size());
     bufferSize = *size;
-    compressorBuffer.resize(estimateMaxCompressionSize());
 
     return true;
   }
 
   void BlockCompressionStream::suppress() {
-    compressorBuffer.resize(0);
+    discardPendingBlocks();
     outputBuffer = nullptr;
     bufferSize = outputPosition = outputSize = 0;
     BufferedOutputStream::suppress();
@@ -1041,6 +1495,7 @@ namespace orc {
     if (!Next(&data, &size)) {
       throw CompressionError("Failed to flush compression buffer.");
     }
+    writePendingBlocks();
     BufferedOutputStream::BackUp(outputSize - outputPosition);
     bufferSize = outputSize = outputPosition = 0;
   }
@@ -1051,85 +1506,77 @@ namespace orc {
   class Lz4CompressionSteam : public BlockCompressionStream {
    public:
     Lz4CompressionSteam(OutputStream* outStream, int compressionLevel, uint64_t capacity,
-                        uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics)
-        : BlockCompressionStream(outStream, compressionLevel, capacity, blockSize, pool, metrics) {
-      this->init();
+                        uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics,
+                        std::shared_ptr<CompressorPool> compressorPool, IOExecutor* executor)
+        : BlockCompressionStream(outStream, compressionLevel, capacity, blockSize, pool, metrics,
+                                 std::move(compressorPool), executor) {
+      // PASS
     }
 
-    virtual std::string getName() const override {
-      return "Lz4CompressionStream";
+    virtual ~Lz4CompressionSteam() override {
+      discardPendingBlocks();
     }
 
-    virtual ~Lz4CompressionSteam() override {
-      this->end();
+    virtual std::string getName() const override {
+      return "Lz4CompressionStream";
     }
 
    protected:
-    virtual uint64_t doBlockCompression() override;
+    virtual uint64_t compressBlock(const unsigned char* input, size_t inputSize,
+                                   unsigned char* output, size_t outputSize) override;
 
-    virtual uint64_t estimateMaxCompressionSize() override {
-      return static_cast<uint64_t>(LZ4_compressBound(bufferSize));
+    virtual uint64_t estimateMaxCompressionSize(uint64_t size) override {
+      return static_cast<uint64_t>(LZ4_compressBound(static_cast<int>(size)));
     }
-
-   private:
-    void init();
-    void end();
-    LZ4_stream_t* state_;
   };
 
-  uint64_t Lz4CompressionSteam::doBlockCompression() {
+  uint64_t Lz4CompressionSteam::compressBlock(const unsigned char* input, size_t inputSize,
+                                              unsigned char* output, size_t outputSize) {
+    Lz4StreamPtr state = compressorPool->acquireLz4State();
     int result = LZ4_compress_fast_extState(
-        static_cast<void*>(state_), reinterpret_cast<const char*>(rawInputBuffer.data()),
-        reinterpret_cast<char*>(compressorBuffer.data()), bufferSize,
-        static_cast<int>(compressorBuffer.size()), level);
+        static_cast<void*>(state.get()), reinterpret_cast<const char*>(input),
+        reinterpret_cast<char*>(output), static_cast<int>(inputSize),
+        static_cast<int>(outputSize), level);
+    compressorPool->releaseLz4State(std::move(state));
     if (result == 0) {
       throw CompressionError("Error during block compression using lz4.");
     }
     return static_cast<uint64_t>(result);
   }
 
-  void Lz4CompressionSteam::init() {
-    state_ = LZ4_createStream();
-    if (!state_) {
-      throw CompressionError("Error while allocating state for lz4.");
-    }
-  }
-
-  void Lz4CompressionSteam::end() {
-    (void)LZ4_freeStream(state_);
-    state_ = nullptr;
-  }
-
   /**
    * Snappy block compression
    */
   class SnappyCompressionStream : public BlockCompressionStream {
    public:
     SnappyCompressionStream(OutputStream* outStream, int compressionLevel, uint64_t capacity,
-                            uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics)
-        : BlockCompressionStream(outStream, compressionLevel, capacity, blockSize, pool, metrics) {}
+                            uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics,
+                            std::shared_ptr<CompressorPool> compressorPool, IOExecutor* executor)
+        : BlockCompressionStream(outStream, compressionLevel, capacity, blockSize, pool, metrics,
+                                 std::move(compressorPool), executor) {}
 
     virtual std::string getName() const override {
       return "SnappyCompressionStream";
     }
 
     virtual ~SnappyCompressionStream() override {
-      // PASS
+      discardPendingBlocks();
     }
 
    protected:
-    virtual uint64_t doBlockCompression() override;
+    virtual uint64_t compressBlock(const unsigned char* input, size_t inputSize,
+                                   unsigned char* output, size_t outputSize) override;
 
-    virtual uint64_t estimateMaxCompressionSize() override {
-      return static_cast<uint64_t>(snappy::MaxCompressedLength(static_cast<size_t>(bufferSize)));
+    virtual uint64_t estimateMaxCompressionSize(uint64_t size) override {
+      return static_cast<uint64_t>(snappy::MaxCompressedLength(static_cast<size_t>(size)));
     }
   };
 
-  uint64_t SnappyCompressionStream::doBlockCompression() {
+  uint64_t SnappyCompressionStream::compressBlock(const unsigned char* input, size_t inputSize,
+                                                  unsigned char* output, size_t) {
     size_t compressedLength;
-    snappy::RawCompress(reinterpret_cast<const char*>(rawInputBuffer.data()),
-                        static_cast<size_t>(bufferSize),
-                        reinterpret_cast<char*>(compressorBuffer.data()), &compressedLength);
+    snappy::RawCompress(reinterpret_cast<const char*>(input), inputSize,
+                        reinterpret_cast<char*>(output), &compressedLength);
     return static_cast<uint64_t>(compressedLength);
   }
 
@@ -1139,35 +1586,35 @@ namespace orc {
   class ZSTDCompressionStream : public BlockCompressionStream {
    public:
     ZSTDCompressionStream(OutputStream* outStream, int compressionLevel, uint64_t capacity,
-                          uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics)
-        : BlockCompressionStream(outStream, compressionLevel, capacity, blockSize, pool, metrics) {
-      this->init();
+                          uint64_t blockSize, MemoryPool& pool, WriterMetrics* metrics,
+                          std::shared_ptr<CompressorPool> compressorPool, IOExecutor* executor)
+        : BlockCompressionStream(outStream, compressionLevel, capacity, blockSize, pool, metrics,
+                                 std::move(compressorPool), executor) {
+      // PASS
     }
 
-    virtual std::string getName() const override {
-      return "ZstdCompressionStream";
+    virtual ~ZSTDCompressionStream() override {
+      discardPendingBlocks();
     }
 
-    virtual ~ZSTDCompressionStream() override {
-      this->end();
+    virtual std::string getName() const override {
+      return "ZstdCompressionStream";
     }
 
    protected:
-    virtual uint64_t doBlockCompression() override;
+    virtual uint64_t compressBlock(const unsigned char* input, size_t inputSize,
+                                   unsigned char* output, size_t outputSize) override;
 
-    virtual uint64_t estimateMaxCompressionSize() override {
-      return ZSTD_compressBound(static_cast<size_t>(bufferSize));
+    virtual uint64_t estimateMaxCompressionSize(uint64_t size) override {
+      return ZSTD_compressBound(static_cast<size_t>(size));
     }
-
-   private:
-    void init();
-    void end();
-    ZSTD_CCtx* cctx_;
   };
 
-  uint64_t ZSTDCompressionStream::doBlockCompression() {
-    auto ret = ZSTD_compressCCtx(cctx_, compressorBuffer.data(), compressorBuffer.size(),
-                                 rawInputBuffer.data(), static_cast<size_t>(bufferSize), level);
+  uint64_t ZSTDCompressionStream::compressBlock(const unsigned char* input, size_t inputSize,
+                                                unsigned char* output, size_t outputSize) {
+    ZstdCCtxPtr cctx = compressorPool->acquireZstdContext();
+    auto ret = ZSTD_compressCCtx(cctx.get(), output, outputSize, input, inputSize, level);
+    compressorPool->releaseZstdContext(std::move(cctx));
     if (ZSTD_isError(ret)) {
       throw CompressionError(std::string("Error while calling ZSTD_compressCCtx(), error: ") +
                              ZSTD_getErrorName(ret));
@@ -1175,23 +1622,35 @@ namespace orc {
     return ret;
   }
 
-  DIAGNOSTIC_PUSH
+  /**
+   * Writes every block as an original chunk, so that single streams of a
+   * compressed file can skip compression and still be read by any reader
+   */
+  class UncompressedChunkStream : public BlockCompressionStream {
+   public:
+    UncompressedChunkStream(OutputStream* outStream, uint64_t capacity, uint64_t blockSize,
+                            MemoryPool& pool, WriterMetrics* metrics,
+                            std::shared_ptr<CompressorPool> compressorPool)
+        : BlockCompressionStream(outStream, 0, capacity, blockSize, pool, metrics,
+                                 std::move(compressorPool), nullptr) {
+      // PASS
+    }
 
-#if defined(__GNUC__) || defined(__clang__)
-  DIAGNOSTIC_IGNORE("-Wold-style-cast")
-#endif
+    virtual std::string getName() const override {
+      return "UncompressedChunkStream";
+    }
 
-  void ZSTDCompressionStream::init() {
-    cctx_ = ZSTD_createCCtx();
-    if (!cctx_) {
-      throw CompressionError("Error while calling ZSTD_createCCtx() for zstd.");
+   protected:
+    // the block is never smaller than its input, so it is written as is
+    virtual uint64_t compressBlock(const unsigned char*, size_t inputSize, unsigned char*,
+                                   size_t) override {
+      return inputSize;
     }
-  }
 
-  void ZSTDCompressionStream::end() {
-    (void)ZSTD_freeCCtx(cctx_);
-    cctx_ = nullptr;
-  }
+    virtual uint64_t estimateMaxCompressionSize(uint64_t) override {
+      return 0;
+    }
+  };
 
   DIAGNOSTIC_PUSH
 
@@ -1201,13 +1660,18 @@ namespace orc {
   class ZSTDDecompressionStream : public BlockDecompressionStream {
    public:
     ZSTDDecompressionStream(std::unique_ptr<SeekableInputStream> inStream, size_t blockSize,
-                            MemoryPool& pool, ReaderMetrics* metrics)
-        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics) {
-      this->init();
+                            MemoryPool& pool, ReaderMetrics* metrics,
+                            std::shared_ptr<DecompressorPool> decompressorPool)
+        : BlockDecompressionStream(std::move(inStream), blockSize, pool, metrics,
+                                   std::move(decompressorPool)),
+          dctx_(nullptr) {
+      // PASS
     }
 
     virtual ~ZSTDDecompressionStream() override {
-      this->end();
+      if (dctx_) {
+        decompressorPool->releaseZstdContext(dctx_);
+      }
     }
 
     std::string getName() const override {
@@ -1221,13 +1685,15 @@ namespace orc {
                                 size_t maxOutputLength) override;
 
    private:
-    void init();
-    void end();
+    // borrowed from decompressorPool when the first chunk is decompressed
     ZSTD_DCtx* dctx_;
   };
 
   uint64_t ZSTDDecompressionStream::decompress(const char* inputPtr, uint64_t length, char* output,
                                                size_t maxOutputLength) {
+    if (!dctx_) {
+      dctx_ = decompressorPool->acquireZstdContext();
+    }
     auto ret = ZSTD_decompressDCtx(dctx_, output, maxOutputLength, inputPtr, length);
     if (ZSTD_isError(ret)) {
       throw CompressionError(std::string("Error while calling ZSTD_decompressDCtx(), error: ") +
@@ -1236,30 +1702,20 @@ namespace orc {
     return static_cast<uint64_t>(ret);
   }
 
-  DIAGNOSTIC_PUSH
-
-#if defined(__GNUC__) || defined(__clang__)
-  DIAGNOSTIC_IGNORE("-Wold-style-cast")
-#endif
-
-  void ZSTDDecompressionStream::init() {
-    dctx_ = ZSTD_createDCtx();
-    if (!dctx_) {
-      throw CompressionError("Error while calling ZSTD_createDCtx() for zstd.");
-    }
-  }
-
-  void ZSTDDecompressionStream::end() {
-    (void)ZSTD_freeDCtx(dctx_);
-    dctx_ = nullptr;
-  }
-
-  DIAGNOSTIC_PUSH
-
   std::unique_ptr<BufferedOutputStream> createCompressor(
       CompressionKind kind, OutputStream* outStream, CompressionStrategy strategy,
       uint64_t bufferCapacity, uint64_t compressionBlockSize, uint64_t memoryBlockSize,
-      MemoryPool& pool, WriterMetrics* metrics) {
+      MemoryPool& pool, WriterMetrics* metrics, std::shared_ptr<CompressorPool> compressorPool,
+      IOExecutor* executor, const ColumnCompression& compression) {
+    if (kind != CompressionKind_NONE && !compressorPool) {
+      compressorPool = createCompressorPool(pool);
+    }
+    if (kind != CompressionKind_NONE && compression.uncompressed) {
+      // copying blocks is not worth a trip through the executor
+      return std::make_unique<UncompressedChunkStream>(outStream, bufferCapacity,
+                                                       compressionBlockSize, pool, metrics,
+                                                       std::move(compressorPool));
+    }
     switch (static_cast<int64_t>(kind)) {
       case CompressionKind_NONE: {
         return std::make_unique<BufferedOutputStream>(pool, outStream, bufferCapacity,
@@ -1268,24 +1724,47 @@ namespace orc {
       case CompressionKind_ZLIB: {
         int level =
             (strategy == CompressionStrategy_SPEED) ? Z_BEST_SPEED + 1 : Z_DEFAULT_COMPRESSION;
-        return std::make_unique<ZlibCompressionStream>(
-            outStream, level, bufferCapacity, compressionBlockSize, memoryBlockSize, pool, metrics);
+        if (compression.level != 0) {
+          if (compression.level < Z_BEST_SPEED || compression.level > Z_BEST_COMPRESSION) {
+            throw std::invalid_argument("Invalid zlib compression level " +
+                                        std::to_string(compression.level));
+          }
+          level = compression.level;
+        }
+        return std::make_unique<ZlibCompressionStream>(outStream, level, bufferCapacity,
+                                                       compressionBlockSize, memoryBlockSize, pool,
+                                                       metrics, std::move(compressorPool),
+                                                       executor);
       }
       case CompressionKind_ZSTD: {
         int level = (strategy == CompressionStrategy_SPEED) ? 1 : ZSTD_CLEVEL_DEFAULT;
+        if (compression.level != 0) {
+          if (compression.level < ZSTD_minCLevel() || compression.level > ZSTD_maxCLevel()) {
+            throw std::invalid_argument("Invalid zstd compression level " +
+                                        std::to_string(compression.level));
+          }
+          level = compression.level;
+        }
         return std::make_unique<ZSTDCompressionStream>(outStream, level, bufferCapacity,
-                                                       compressionBlockSize, pool, metrics);
+                                                       compressionBlockSize, pool, metrics,
+                                                       std::move(compressorPool), executor);
       }
       case CompressionKind_LZ4: {
         int level = (strategy == CompressionStrategy_SPEED) ? LZ4_ACCELERATION_MAX
                                                             : LZ4_ACCELERATION_DEFAULT;
+        if (compression.level != 0) {
+          // lz4 clamps the acceleration to its valid range
+          level = compression.level;
+        }
         return std::make_unique<Lz4CompressionSteam>(outStream, level, bufferCapacity,
-                                                     compressionBlockSize, pool, metrics);
+                                                     compressionBlockSize, pool, metrics,
+                                                     std::move(compressorPool), executor);
       }
       case CompressionKind_SNAPPY: {
         int level = 0;
         return std::make_unique<SnappyCompressionStream>(outStream, level, bufferCapacity,
-                                                         compressionBlockSize, pool, metrics);
+                                                         compressionBlockSize, pool, metrics,
+                                                         std::move(compressorPool), executor);
       }
       case CompressionKind_LZO:
       default:
@@ -1295,23 +1774,29 @@ namespace orc {
 
   std::unique_ptr<SeekableInputStream> createDecompressor(
       CompressionKind kind, std::unique_ptr<SeekableInputStream> input, uint64_t blockSize,
-      MemoryPool& pool, ReaderMetrics* metrics) {
+      MemoryPool& pool, ReaderMetrics* metrics,
+      std::shared_ptr<DecompressorPool> decompressorPool) {
+    if (kind != CompressionKind_NONE && !decompressorPool) {
+      decompressorPool = createDecompressorPool(pool);
+    }
     switch (static_cast<int64_t>(kind)) {
       case CompressionKind_NONE:
         return input;
       case CompressionKind_ZLIB:
         return std::make_unique<ZlibDecompressionStream>(std::move(input), blockSize, pool,
-                                                         metrics);
+                                                         metrics, std::move(decompressorPool));
       case CompressionKind_SNAPPY:
         return std::make_unique<SnappyDecompressionStream>(std::move(input), blockSize, pool,
-                                                           metrics);
+                                                           metrics, std::move(decompressorPool));
       case CompressionKind_LZO:
-        return std::make_unique<LzoDecompressionStream>(std::move(input), blockSize, pool, metrics);
+        return std::make_unique<LzoDecompressionStream>(std::move(input), blockSize, pool, metrics,
+                                                        std::move(decompressorPool));
       case CompressionKind_LZ4:
-        return std::make_unique<Lz4DecompressionStream>(std::move(input), blockSize, pool, metrics);
+        return std::make_unique<Lz4DecompressionStream>(std::move(input), blockSize, pool, metrics,
+                                                        std::move(decompressorPool));
       case CompressionKind_ZSTD:
         return std::make_unique<ZSTDDecompressionStream>(std::move(input), blockSize, pool,
-                                                         metrics);
+                                                         metrics, std::move(decompressorPool));
       default: {
         std::ostringstream buffer;
         buffer << "Unknown compression codec " << kind;
@@ -24,6 +24,28 @@
 
 namespace orc {
 
+  class IOExecutor;
+
+  /**
+   * Decompression contexts and block buffers that the decompression streams
+   * of a reader borrow when they first decompress a chunk and return when
+   * they are destroyed. A wide schema opens several streams per column in
+   * every stripe, so creating them per stream dominates the setup of a
+   * stripe and its peak memory. The class is thread-safe.
+   */
+  class DecompressorPool;
+
+  /**
+   * Create an empty pool whose buffers are allocated from the memory pool.
+   */
+  std::shared_ptr<DecompressorPool> createDecompressorPool(MemoryPool& pool);
+
+  /**
+   * Free the contexts and buffers that no stream has borrowed, so that the
+   * pool doesn't keep the peak of a finished read.
+   */
+  void releaseIdleDecompressors(DecompressorPool& pool);
+
   /**
    * Create a decompressor for the given compression kind.
    * @param kind the compression type to implement
@@ -31,10 +53,26 @@ namespace orc {
    * @param bufferSize the maximum size of the buffer
    * @param pool the memory pool
    * @param metrics the reader metrics
+   * @param decompressorPool the pool to borrow contexts and buffers from;
+   *        if null, the decompressor creates its own
    */
   std::unique_ptr<SeekableInputStream> createDecompressor(
       CompressionKind kind, std::unique_ptr<SeekableInputStream> input, uint64_t bufferSize,
-      MemoryPool& pool, ReaderMetrics* metrics);
+      MemoryPool& pool, ReaderMetrics* metrics,
+      std::shared_ptr<DecompressorPool> decompressorPool = nullptr);
+
+  /**
+   * Compression contexts and scratch buffers that the compression streams of
+   * a writer borrow while they compress a block. Every stream of every
+   * column used to keep its own for the life of the writer, although a
+   * writer compresses only one block at a time. The class is thread-safe.
+   */
+  class CompressorPool;
+
+  /**
+   * Create an empty pool whose buffers are allocated from the memory pool.
+   */
+  std::shared_ptr<CompressorPool> createCompressorPool(MemoryPool& pool);
 
   /**
    * Create a compressor for the given compression kind.
@@ -47,11 +85,20 @@ namespace orc {
    * @param memoryBlockSize the block size for original input buffer
    * @param pool the memory pool
    * @param metrics the writer metrics
+   * @param compressorPool the pool to borrow contexts and buffers from; if
+   *        null, the compressor creates its own
+   * @param executor if not null, full blocks are compressed on its threads
+   *        while the caller keeps writing, and are written out in order once
+   *        done; otherwise they are compressed on the calling thread
+   * @param compression overrides the level of the strategy, or stores every
+   *        block as an original chunk of the compressed stream
    */
   std::unique_ptr<BufferedOutputStream> createCompressor(
       CompressionKind kind, OutputStream* outStream, CompressionStrategy strategy,
       uint64_t bufferCapacity, uint64_t compressionBlockSize, uint64_t memoryBlockSize,
-      MemoryPool& pool, WriterMetrics* metrics);
+      MemoryPool& pool, WriterMetrics* metrics,
+      std::shared_ptr<CompressorPool> compressorPool = nullptr, IOExecutor* executor = nullptr,
+      const ColumnCompression& compression = ColumnCompression());
 }  // namespace orc
 
 #endif
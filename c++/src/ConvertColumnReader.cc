@@ -426,6 +426,14 @@ namespace orc {
     void next(ColumnVectorBatch& rowBatch, uint64_t numValues, char* notNull) override;
 
    protected:
+    // Convert the seconds of the batch from UTC to the reader timezone
+    void convertFromReaderTimezone(TimestampVectorBatch& dstBatch, uint64_t numValues) const {
+      if (needConvertTimezone) {
+        readerTimezone->convertFromUTC(dstBatch.data.data(), dstBatch.data.data(), numValues,
+                                       dstBatch.hasNulls ? dstBatch.notNull.data() : nullptr);
+      }
+    }
+
     const bool isInstant;
     const orc::Timezone* readerTimezone;
     const bool needConvertTimezone;
@@ -454,6 +462,7 @@ namespace orc {
           convertToTimestamp(dstBatch, i, srcBatch.data[i]);
         }
       }
+      convertFromReaderTimezone(dstBatch, numValues);
     }
 
    private:
@@ -482,9 +491,6 @@ namespace orc {
       dstBatch.data[idx] = value;
       dstBatch.nanoseconds[idx] = 0;
     }
-    if (needConvertTimezone) {
-      dstBatch.data[idx] = readerTimezone->convertFromUTC(dstBatch.data[idx]);
-    }
   }
 
   template <typename FileTypeBatch, typename ReadTypeBatch, typename ReadType>
@@ -634,6 +640,7 @@ namespace orc {
           convertDecimalToTimestamp(dstBatch, i, srcBatch);
         }
       }
+      convertFromReaderTimezone(dstBatch, rowBatch.numElements);
     }
 
    private:
@@ -669,10 +676,6 @@ namespace orc {
       // line 630 has guaranteed toLong() will not overflow
       dstBatch.data[idx] = integerPortion.toLong();
       dstBatch.nanoseconds[idx] = fractionPortion.toLong();
-
-      if (needConvertTimezone) {
-        dstBatch.data[idx] = readerTimezone->convertFromUTC(dstBatch.data[idx]);
-      }
     }
 
     const int32_t precision_;
@@ -843,6 +846,7 @@ namespace orc {
           convertToTimestamp(dstBatch, i, std::string(srcBatch.data[i], srcBatch.length[i]));
         }
       }
+      convertFromReaderTimezone(dstBatch, numValues);
     }
 
    private:
@@ -912,20 +916,26 @@ namespace orc {
         pos += 1;
         size_t subStrLength = timeStr.length() - pos;
         try {
-          second = getTimezoneByName(timeStr.substr(pos, subStrLength)).convertFromUTC(second);
+          // rows of a batch usually name the same timezone
+          if (!instantVariants_ || timeStr.compare(pos, subStrLength, instantZoneName_) != 0) {
+            instantZoneName_ = timeStr.substr(pos, subStrLength);
+            instantVariants_.emplace(getTimezoneByName(instantZoneName_));
+          }
+          second = instantVariants_->convertFromUTC(second);
         } catch (const TimezoneError&) {
+          instantVariants_.reset();
           handleParseFromStringError(dstBatch, idx, throwOnOverflow, "Timestamp_Instant", timeStr,
                                      expectedTimestampInstantFormat);
           return;
         }
-      } else {
-        if (needConvertTimezone) {
-          second = readerTimezone->convertFromUTC(second);
-        }
       }
       dstBatch.data[idx] = second;
       dstBatch.nanoseconds[idx] = nanos;
     }
+
+    // the timezone named by the last timestamp_instant string
+    std::string instantZoneName_;
+    std::optional<TimezoneVariantCache> instantVariants_;
   };
 
   template <typename ReadTypeBatch>
@@ -467,6 +467,7 @@ namespace orc {
     bool ArchParseUserSimdLevel(const std::string& simdLevel, int64_t* hardwareFlags) {
       enum {
         USER_SIMD_NONE,
+        USER_SIMD_AVX2,
         USER_SIMD_AVX512,
         USER_SIMD_MAX,
       };
@@ -475,6 +476,8 @@ namespace orc {
       // Parse the level
       if (simdLevel == "AVX512") {
         level = USER_SIMD_AVX512;
+      } else if (simdLevel == "AVX2") {
+        level = USER_SIMD_AVX2;
       } else if (simdLevel == "NONE") {
         level = USER_SIMD_NONE;
       } else {
@@ -485,6 +488,9 @@ namespace orc {
       if (level < USER_SIMD_AVX512) {
         *hardwareFlags &= ~CpuInfo::AVX512;
       }
+      if (level < USER_SIMD_AVX2) {
+        *hardwareFlags &= ~CpuInfo::AVX2;
+      }
       return true;
     }
 
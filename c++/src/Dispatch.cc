@@ -0,0 +1,53 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Dispatch.hh"
+
+namespace orc {
+
+  namespace {
+    // negative until setMaxDispatchLevel() is called
+    std::atomic<int> maxDispatchLevel{-1};
+    std::atomic<uint64_t> dispatchGeneration{0};
+  }  // namespace
+
+  void setMaxDispatchLevel(DispatchLevel level) {
+    maxDispatchLevel.store(static_cast<int>(level), std::memory_order_relaxed);
+    dispatchGeneration.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  void resetMaxDispatchLevel() {
+    maxDispatchLevel.store(-1, std::memory_order_relaxed);
+    dispatchGeneration.fetch_add(1, std::memory_order_acq_rel);
+  }
+
+  DispatchLevel getMaxDispatchLevel() {
+    int level = maxDispatchLevel.load(std::memory_order_relaxed);
+    return level < 0 ? DispatchLevel::MAX : static_cast<DispatchLevel>(level);
+  }
+
+  bool isMaxDispatchLevelSet() {
+    return maxDispatchLevel.load(std::memory_order_relaxed) >= 0;
+  }
+
+  uint64_t getDispatchGeneration() {
+    return dispatchGeneration.load(std::memory_order_acquire);
+  }
+
+}  // namespace orc
@@ -19,26 +19,61 @@
 #ifndef ORC_DISPATCH_HH
 #define ORC_DISPATCH_HH
 
+#include <atomic>
 #include <utility>
 #include <vector>
 
 #include "CpuInfoUtil.hh"
+#include "orc/Exceptions.hh"
+
+// Compiles a function for AVX2 without building the whole library for it, so
+// the function must only be reached through a DynamicDispatch.
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+#if defined(_MSC_VER)
+#define ORC_TARGET_AVX2
+#else
+#define ORC_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
 
 namespace orc {
   enum class DispatchLevel : int {
     // These dispatch levels, corresponding to instruction set features,
     // are sorted in increasing order of preference.
     NONE = 0,
+    AVX2,
     AVX512,
     MAX
   };
 
+  /**
+   * Set the highest DispatchLevel every DynamicDispatch may pick, e.g. to opt
+   * in to the SIMD kernels from code or to compare the kernels of different
+   * levels in a benchmark. It takes precedence over ORC_USER_SIMD_LEVEL, but
+   * levels that the CPU doesn't support are never picked.
+   */
+  void setMaxDispatchLevel(DispatchLevel level);
+
+  /**
+   * Go back to the levels enabled by ORC_USER_SIMD_LEVEL, which is none of
+   * the SIMD ones unless the variable is set.
+   */
+  void resetMaxDispatchLevel();
+
+  // MAX unless setMaxDispatchLevel() was called
+  DispatchLevel getMaxDispatchLevel();
+  bool isMaxDispatchLevelSet();
+
+  // Incremented by setMaxDispatchLevel() so that dispatchers re-resolve
+  uint64_t getDispatchGeneration();
+
   /**
    * A facility for dynamic dispatch according to available DispatchLevel.
    *
    * Typical use:
    *
    *   static void my_function_default(...);
+   *   static void my_function_avx2(...);
    *   static void my_function_avx512(...);
    *
    *   struct MyDynamicFunction {
@@ -47,6 +82,9 @@ namespace orc {
    *     static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
    *       return {
    *         { DispatchLevel::NONE, my_function_default }
+   *   #if defined(ORC_HAVE_RUNTIME_AVX2)
+   *         , { DispatchLevel::AVX2, my_function_avx2 }
+   *   #endif
    *   #if defined(ORC_HAVE_RUNTIME_AVX512)
    *         , { DispatchLevel::AVX512, my_function_avx512 }
    *   #endif
@@ -56,7 +94,7 @@ namespace orc {
    *
    *   void my_function(...) {
    *     static DynamicDispatch<MyDynamicFunction> dispatch;
-   *     return dispatch.func(...);
+   *     return dispatch.get()(...);
    *   }
    */
   template <typename DynamicFunction>
@@ -66,19 +104,26 @@ namespace orc {
     using Implementation = std::pair<DispatchLevel, FunctionType>;
 
    public:
-    DynamicDispatch() {
-      Resolve(DynamicFunction::implementations());
+    DynamicDispatch() : implementations_(DynamicFunction::implementations()) {
+      resolve();
     }
 
-    FunctionType func = {};
+    FunctionType get() {
+      if (generation_.load(std::memory_order_acquire) != getDispatchGeneration()) {
+        resolve();
+      }
+      return func_.load(std::memory_order_relaxed);
+    }
 
    protected:
-    // Use the Implementation with the highest DispatchLevel
-    void Resolve(const std::vector<Implementation>& implementations) {
+    // Use the Implementation with the highest allowed DispatchLevel
+    void resolve() {
+      uint64_t generation = getDispatchGeneration();
+      DispatchLevel maxLevel = getMaxDispatchLevel();
       Implementation cur{DispatchLevel::NONE, {}};
 
-      for (const auto& impl : implementations) {
-        if (impl.first >= cur.first && levelSupported(impl.first)) {
+      for (const auto& impl : implementations_) {
+        if (impl.first >= cur.first && impl.first <= maxLevel && levelSupported(impl.first)) {
           // Higher (or same) level than current
           cur = impl;
         }
@@ -87,23 +132,35 @@ namespace orc {
       if (!cur.second) {
         throw InvalidArgument("No appropriate implementation found");
       }
-      func = cur.second;
+      func_.store(cur.second, std::memory_order_relaxed);
+      generation_.store(generation, std::memory_order_release);
     }
 
    private:
     bool levelSupported(DispatchLevel level) const {
       static const auto cpu_info = CpuInfo::getInstance();
+      // a level set in code overrides the features ORC_USER_SIMD_LEVEL disables
+      const bool isLevelSet = isMaxDispatchLevelSet();
+      auto isEnabled = [isLevelSet](int64_t flags) {
+        return isLevelSet ? cpu_info->isDetected(flags) : cpu_info->isSupported(flags);
+      };
 
       switch (level) {
         case DispatchLevel::NONE:
           return true;
+        case DispatchLevel::AVX2:
+          return isEnabled(CpuInfo::AVX2);
         case DispatchLevel::AVX512:
         case DispatchLevel::MAX:
-          return cpu_info->isSupported(CpuInfo::AVX512);
+          return isEnabled(CpuInfo::AVX512);
         default:
           return false;
       }
     }
+
+    const std::vector<Implementation> implementations_;
+    std::atomic<FunctionType> func_{};
+    std::atomic<uint64_t> generation_{0};
   };
 }  // namespace orc
 
@@ -0,0 +1,114 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/FileTailCache.hh"
+
+#include <list>
+#include <mutex>
+#include <unordered_map>
+
+namespace orc {
+
+  CachedFileTail::~CachedFileTail() {
+    // PASS
+  }
+
+  FileTailCache::~FileTailCache() {
+    // PASS
+  }
+
+  class LruFileTailCache : public FileTailCache {
+   private:
+    struct Entry {
+      std::string key;
+      std::shared_ptr<const CachedFileTail> tail;
+      uint64_t memoryUsage;
+    };
+
+    const uint64_t maxMemory_;
+    std::mutex mutex_;
+    uint64_t memoryUsage_;
+    // the most recently used tail first
+    std::list<Entry> entries_;
+    std::unordered_map<std::string, std::list<Entry>::iterator> index_;
+
+    // Remove the tail of key if any. Caller holds mutex_.
+    void erase(const std::string& key) {
+      auto it = index_.find(key);
+      if (it != index_.end()) {
+        memoryUsage_ -= it->second->memoryUsage;
+        entries_.erase(it->second);
+        index_.erase(it);
+      }
+    }
+
+    // Record the current memory of a tail. Caller holds mutex_.
+    void measure(Entry& entry) {
+      uint64_t memoryUsage = entry.tail->getMemoryUsage();
+      memoryUsage_ = memoryUsage_ - entry.memoryUsage + memoryUsage;
+      entry.memoryUsage = memoryUsage;
+    }
+
+    // Evict the least recently used tails until they fit. Caller holds mutex_.
+    void evict() {
+      while (memoryUsage_ > maxMemory_) {
+        erase(entries_.back().key);
+      }
+    }
+
+   public:
+    explicit LruFileTailCache(uint64_t maxMemory) : maxMemory_(maxMemory), memoryUsage_(0) {}
+
+    std::shared_ptr<const CachedFileTail> get(const std::string& key) override {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = index_.find(key);
+      if (it == index_.end()) {
+        return nullptr;
+      }
+      std::shared_ptr<const CachedFileTail> tail = it->second->tail;
+      entries_.splice(entries_.begin(), entries_, it->second);
+      // the readers of the tail may have decoded more of it
+      measure(*it->second);
+      evict();
+      return tail;
+    }
+
+    void put(const std::string& key, std::shared_ptr<const CachedFileTail> tail) override {
+      uint64_t memoryUsage = tail->getMemoryUsage();
+      std::lock_guard<std::mutex> lock(mutex_);
+      erase(key);
+      if (memoryUsage > maxMemory_) {
+        // caching it would evict everything else
+        return;
+      }
+      // the cached tails grow as their statistics are decoded
+      for (Entry& entry : entries_) {
+        measure(entry);
+      }
+      entries_.push_front(Entry{key, std::move(tail), memoryUsage});
+      index_[key] = entries_.begin();
+      memoryUsage_ += memoryUsage;
+      evict();
+    }
+  };
+
+  std::shared_ptr<FileTailCache> createFileTailCache(uint64_t maxMemory) {
+    return std::make_shared<LruFileTailCache>(maxMemory);
+  }
+
+}  // namespace orc
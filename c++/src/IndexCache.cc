@@ -0,0 +1,106 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "IndexCache.hh"
+
+namespace orc {
+
+  size_t IndexCache::KeyHash::operator()(const Key& key) const {
+    std::hash<uint64_t> hasher;
+    size_t hash = hasher(key.stripe);
+    hash = hash * 31 + hasher(key.column);
+    return hash * 2 + (key.isBloomFilter ? 1 : 0);
+  }
+
+  IndexCache::IndexCache(uint64_t maxMemory, ReaderMetrics* metrics)
+      : maxMemory_(maxMemory), metrics_(metrics), memoryUsage_(0) {
+    // PASS
+  }
+
+  std::shared_ptr<const proto::RowIndex> IndexCache::getRowIndex(uint64_t stripe,
+                                                                 uint64_t column) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry* entry = get(Key{stripe, column, false});
+    return entry ? entry->rowIndex : nullptr;
+  }
+
+  void IndexCache::putRowIndex(uint64_t stripe, uint64_t column,
+                               std::shared_ptr<const proto::RowIndex> rowIndex) {
+    uint64_t memoryUsage = static_cast<uint64_t>(rowIndex->SpaceUsedLong());
+    std::lock_guard<std::mutex> lock(mutex_);
+    put(Entry{Key{stripe, column, false}, std::move(rowIndex), nullptr, memoryUsage});
+  }
+
+  std::shared_ptr<const BloomFilterIndex> IndexCache::getBloomFilters(uint64_t stripe,
+                                                                      uint64_t column) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const Entry* entry = get(Key{stripe, column, true});
+    return entry ? entry->bloomFilters : nullptr;
+  }
+
+  void IndexCache::putBloomFilters(uint64_t stripe, uint64_t column,
+                                   std::shared_ptr<const BloomFilterIndex> bloomFilters,
+                                   uint64_t memoryUsage) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    put(Entry{Key{stripe, column, true}, nullptr, std::move(bloomFilters), memoryUsage});
+  }
+
+  uint64_t IndexCache::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return memoryUsage_;
+  }
+
+  const IndexCache::Entry* IndexCache::get(const Key& key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      if (metrics_) {
+        metrics_->IndexCacheMisses.fetch_add(1);
+      }
+      return nullptr;
+    }
+    if (metrics_) {
+      metrics_->IndexCacheHits.fetch_add(1);
+    }
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &*it->second;
+  }
+
+  void IndexCache::put(Entry entry) {
+    erase(entry.key);
+    if (entry.memoryUsage > maxMemory_) {
+      // caching it would evict everything else
+      return;
+    }
+    memoryUsage_ += entry.memoryUsage;
+    entries_.push_front(std::move(entry));
+    index_[entries_.front().key] = entries_.begin();
+    while (memoryUsage_ > maxMemory_) {
+      erase(entries_.back().key);
+    }
+  }
+
+  void IndexCache::erase(const Key& key) {
+    auto it = index_.find(key);
+    if (it != index_.end()) {
+      memoryUsage_ -= it->second->memoryUsage;
+      entries_.erase(it->second);
+      index_.erase(it);
+    }
+  }
+
+}  // namespace orc
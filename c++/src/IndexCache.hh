@@ -0,0 +1,111 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_INDEXCACHE_HH
+#define ORC_INDEXCACHE_HH
+
+#include "orc/BloomFilter.hh"
+#include "orc/Reader.hh"
+#include "wrap/orc-proto-wrapper.hh"
+
+#include <list>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace orc {
+
+  /**
+   * The parsed row indexes and bloom filters of the stripes of a file, shared
+   * by all the row readers of a Reader. Entries are evicted in least recently
+   * used order once their memory usage exceeds the limit.
+   *
+   * The class is thread-safe.
+   */
+  class IndexCache {
+   public:
+    /**
+     * @param maxMemory the memory available to the cached indexes in bytes
+     * @param metrics if not null, counts the hits and misses of lookups
+     */
+    IndexCache(uint64_t maxMemory, ReaderMetrics* metrics);
+
+    /**
+     * Look up the row index of a column in a stripe.
+     * @return nullptr if it isn't cached
+     */
+    std::shared_ptr<const proto::RowIndex> getRowIndex(uint64_t stripe, uint64_t column);
+
+    void putRowIndex(uint64_t stripe, uint64_t column,
+                     std::shared_ptr<const proto::RowIndex> rowIndex);
+
+    /**
+     * Look up the bloom filters of a column in a stripe.
+     * @return nullptr if they aren't cached
+     */
+    std::shared_ptr<const BloomFilterIndex> getBloomFilters(uint64_t stripe, uint64_t column);
+
+    /**
+     * @param memoryUsage the approximate memory used by the bloom filters
+     */
+    void putBloomFilters(uint64_t stripe, uint64_t column,
+                         std::shared_ptr<const BloomFilterIndex> bloomFilters,
+                         uint64_t memoryUsage);
+
+    uint64_t getMemoryUsage() const;
+
+   private:
+    struct Key {
+      uint64_t stripe;
+      uint64_t column;
+      bool isBloomFilter;
+
+      bool operator==(const Key& other) const {
+        return stripe == other.stripe && column == other.column &&
+               isBloomFilter == other.isBloomFilter;
+      }
+    };
+
+    struct KeyHash {
+      size_t operator()(const Key& key) const;
+    };
+
+    struct Entry {
+      Key key;
+      // exactly one of them is set, as given by key.isBloomFilter
+      std::shared_ptr<const proto::RowIndex> rowIndex;
+      std::shared_ptr<const BloomFilterIndex> bloomFilters;
+      uint64_t memoryUsage;
+    };
+
+    const uint64_t maxMemory_;
+    ReaderMetrics* metrics_;
+    mutable std::mutex mutex_;
+    uint64_t memoryUsage_;
+    // the most recently used entry first
+    std::list<Entry> entries_;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> index_;
+
+    const Entry* get(const Key& key);
+    void put(Entry entry);
+    void erase(const Key& key);
+  };
+
+}  // namespace orc
+
+#endif
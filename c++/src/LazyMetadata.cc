@@ -0,0 +1,159 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "LazyMetadata.hh"
+#include "orc/Exceptions.hh"
+#include "wrap/coded-stream-wrapper.h"
+
+namespace orc {
+
+  namespace {
+    constexpr uint32_t WIRETYPE_VARINT = 0;
+    constexpr uint32_t WIRETYPE_FIXED64 = 1;
+    constexpr uint32_t WIRETYPE_LENGTH_DELIMITED = 2;
+    constexpr uint32_t WIRETYPE_FIXED32 = 5;
+
+    // stripe_stats in Metadata and col_stats in StripeStatistics
+    constexpr uint32_t REPEATED_FIELD_NUMBER = 1;
+
+    /**
+     * Find the entries of the repeated message field of a serialized
+     * Metadata or StripeStatistics, without parsing them.
+     * @return false if the message is malformed
+     */
+    template <typename Range>
+    bool findEntries(const std::string& serialized, uint64_t offset, uint64_t length,
+                     std::vector<Range>& entries) {
+      google::protobuf::io::CodedInputStream input(
+          reinterpret_cast<const uint8_t*>(serialized.data() + offset), static_cast<int>(length));
+      while (true) {
+        uint32_t tag = input.ReadTag();
+        if (tag == 0) {
+          return static_cast<uint64_t>(input.CurrentPosition()) == length;
+        }
+        uint32_t value32;
+        uint64_t value64;
+        switch (tag & 0x7) {
+          case WIRETYPE_VARINT:
+            if (!input.ReadVarint64(&value64)) {
+              return false;
+            }
+            break;
+          case WIRETYPE_FIXED64:
+            if (!input.ReadLittleEndian64(&value64)) {
+              return false;
+            }
+            break;
+          case WIRETYPE_FIXED32:
+            if (!input.ReadLittleEndian32(&value32)) {
+              return false;
+            }
+            break;
+          case WIRETYPE_LENGTH_DELIMITED: {
+            if (!input.ReadVarint32(&value32)) {
+              return false;
+            }
+            uint64_t start = offset + static_cast<uint64_t>(input.CurrentPosition());
+            if (!input.Skip(static_cast<int>(value32))) {
+              return false;
+            }
+            if ((tag >> 3) == REPEATED_FIELD_NUMBER) {
+              entries.push_back({start, value32});
+            }
+            break;
+          }
+          default:
+            // groups are not used by ORC
+            return false;
+        }
+      }
+    }
+  }  // namespace
+
+  LazyMetadata::LazyMetadata(std::string serialized)
+      : serialized_(std::move(serialized)), decodedMemoryUsage_(0) {
+    if (serialized_.size() > static_cast<uint64_t>(PROTOBUF_MESSAGE_MAX_LIMIT)) {
+      throw ParseError("Failed to parse the metadata");
+    }
+    std::vector<Range> ranges;
+    if (!findEntries(serialized_, 0, serialized_.size(), ranges)) {
+      throw ParseError("Failed to parse the metadata");
+    }
+    stripes_.resize(ranges.size());
+    for (size_t i = 0; i < ranges.size(); ++i) {
+      stripes_[i].range = ranges[i];
+    }
+  }
+
+  uint64_t LazyMetadata::getNumberOfStripes() const {
+    return stripes_.size();
+  }
+
+  LazyMetadata::Stripe& LazyMetadata::scanStripe(uint64_t stripe) const {
+    Stripe& result = stripes_[stripe];
+    if (!result.isScanned) {
+      if (!findEntries(serialized_, result.range.offset, result.range.length, result.columns)) {
+        throw ParseError("Failed to parse the statistics of stripe " + std::to_string(stripe));
+      }
+      result.columnStats.resize(result.columns.size());
+      result.isScanned = true;
+      decodedMemoryUsage_ += result.columns.capacity() * sizeof(Range) +
+                             result.columnStats.capacity() * sizeof(result.columnStats[0]);
+    }
+    return result;
+  }
+
+  uint64_t LazyMetadata::getNumberOfColumns(uint64_t stripe) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return scanStripe(stripe).columns.size();
+  }
+
+  proto::StripeStatistics LazyMetadata::getStripeStatistics(uint64_t stripe) const {
+    const Range& range = stripes_[stripe].range;
+    proto::StripeStatistics result;
+    if (!result.ParseFromArray(serialized_.data() + range.offset, static_cast<int>(range.length))) {
+      throw ParseError("Failed to parse the statistics of stripe " + std::to_string(stripe));
+    }
+    return result;
+  }
+
+  const proto::ColumnStatistics& LazyMetadata::getColumnStatistics(uint64_t stripe,
+                                                                   uint64_t column) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    Stripe& entry = scanStripe(stripe);
+    std::unique_ptr<proto::ColumnStatistics>& stats = entry.columnStats[column];
+    if (stats == nullptr) {
+      const Range& range = entry.columns[column];
+      auto decoded = std::make_unique<proto::ColumnStatistics>();
+      if (!decoded->ParseFromArray(serialized_.data() + range.offset,
+                                   static_cast<int>(range.length))) {
+        throw ParseError("Failed to parse the statistics of column " + std::to_string(column) +
+                         " in stripe " + std::to_string(stripe));
+      }
+      decodedMemoryUsage_ += decoded->SpaceUsedLong();
+      stats = std::move(decoded);
+    }
+    return *stats;
+  }
+
+  uint64_t LazyMetadata::getMemoryUsage() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return serialized_.capacity() + stripes_.capacity() * sizeof(Stripe) + decodedMemoryUsage_;
+  }
+
+}  // namespace orc
@@ -0,0 +1,99 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_LAZYMETADATA_HH
+#define ORC_LAZYMETADATA_HH
+
+#include "wrap/orc-proto-wrapper.hh"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * The stripe statistics of a file, i.e. its proto::Metadata, decoded on
+   * demand. Files with many stripes and columns have large metadata, while
+   * predicate pushdown only needs the statistics of a few columns in the
+   * stripes it reads. So only the boundaries of the stripes are found up
+   * front, and the statistics of a column are decoded when first used.
+   *
+   * The class is thread-safe, as it is shared by all the readers of a file.
+   */
+  class LazyMetadata {
+   public:
+    /**
+     * @param serialized the uncompressed proto::Metadata
+     * @throws ParseError if the stripes can't be found in it
+     */
+    explicit LazyMetadata(std::string serialized);
+
+    uint64_t getNumberOfStripes() const;
+
+    /**
+     * Get the number of columns with statistics in a stripe.
+     */
+    uint64_t getNumberOfColumns(uint64_t stripe) const;
+
+    /**
+     * Decode the statistics of all the columns of a stripe. They are not
+     * kept, unlike the ones returned by getColumnStatistics().
+     */
+    proto::StripeStatistics getStripeStatistics(uint64_t stripe) const;
+
+    /**
+     * Get the statistics of a column in a stripe, which must be less than
+     * getNumberOfColumns(stripe). They are valid as long as this object.
+     */
+    const proto::ColumnStatistics& getColumnStatistics(uint64_t stripe, uint64_t column) const;
+
+    /**
+     * Get the memory used by the serialized metadata, the stripe boundaries
+     * and the statistics decoded so far, so it grows as columns are used.
+     */
+    uint64_t getMemoryUsage() const;
+
+   private:
+    struct Range {
+      uint64_t offset;
+      uint64_t length;
+    };
+
+    struct Stripe {
+      Range range;
+      // set when a column of the stripe is first used
+      bool isScanned = false;
+      std::vector<Range> columns;
+      std::vector<std::unique_ptr<proto::ColumnStatistics>> columnStats;
+    };
+
+    // Find the columns of a stripe. Caller holds mutex_.
+    Stripe& scanStripe(uint64_t stripe) const;
+
+    const std::string serialized_;
+    mutable std::mutex mutex_;
+    mutable std::vector<Stripe> stripes_;
+    // the memory of the scanned stripes and decoded statistics
+    mutable uint64_t decodedMemoryUsage_;
+  };
+
+}  // namespace orc
+
+#endif
@@ -48,12 +48,16 @@ namespace orc {
     std::string serializedTail;
     ReaderMetrics* metrics;
     CacheOptions cacheOptions;
+    std::shared_ptr<FileTailCache> fileTailCache;
+    std::string fileTailCacheToken;
+    uint64_t indexCacheMemory;
 
     ReaderOptionsPrivate() {
       tailLocation = std::numeric_limits<uint64_t>::max();
       errorStream = &std::cerr;
       memoryPool = getDefaultPool();
       metrics = nullptr;
+      indexCacheMemory = 0;
     }
   };
 
@@ -109,6 +113,30 @@ namespace orc {
     return privateBits_->tailLocation;
   }
 
+  ReaderOptions& ReaderOptions::setFileTailCache(std::shared_ptr<FileTailCache> cache,
+                                                 const std::string& token) {
+    privateBits_->fileTailCache = std::move(cache);
+    privateBits_->fileTailCacheToken = token;
+    return *this;
+  }
+
+  std::shared_ptr<FileTailCache> ReaderOptions::getFileTailCache() const {
+    return privateBits_->fileTailCache;
+  }
+
+  const std::string& ReaderOptions::getFileTailCacheToken() const {
+    return privateBits_->fileTailCacheToken;
+  }
+
+  ReaderOptions& ReaderOptions::setIndexCacheMemory(uint64_t maxMemory) {
+    privateBits_->indexCacheMemory = maxMemory;
+    return *this;
+  }
+
+  uint64_t ReaderOptions::getIndexCacheMemory() const {
+    return privateBits_->indexCacheMemory;
+  }
+
   ReaderOptions& ReaderOptions::setSerializedFileTail(const std::string& value) {
     privateBits_->serializedTail = value;
     return *this;
@@ -157,7 +185,12 @@ namespace orc {
     bool throwOnSchemaEvolutionOverflow;
     bool enableAsyncPrefetch;
     uint64_t smallStripeLookAheadLimit;
+    uint64_t prefetchWindowSize;
     uint32_t dictionaryFilteringSizeThreshold;
+    uint32_t decodeThreads;
+    std::list<std::string> rowFilterColumns;
+    RowReaderOptions::RowFilter rowFilter;
+    bool filterRowsBySearchArgument;
 
     RowReaderOptionsPrivate() {
       selection = ColumnSelection_NONE;
@@ -171,7 +204,10 @@ namespace orc {
       throwOnSchemaEvolutionOverflow = false;
       enableAsyncPrefetch = false;
       smallStripeLookAheadLimit = 8;
+      prefetchWindowSize = 0;
       dictionaryFilteringSizeThreshold = 0;
+      decodeThreads = 1;
+      filterRowsBySearchArgument = false;
     }
   };
 
@@ -365,6 +401,15 @@ namespace orc {
     return privateBits_->smallStripeLookAheadLimit;
   }
 
+  RowReaderOptions& RowReaderOptions::setPrefetchWindowSize(uint64_t bytes) {
+    privateBits_->prefetchWindowSize = bytes;
+    return *this;
+  }
+
+  uint64_t RowReaderOptions::getPrefetchWindowSize() const {
+    return privateBits_->prefetchWindowSize;
+  }
+
   RowReaderOptions& RowReaderOptions::setDictionaryFilteringSizeThreshold(uint32_t threshold) {
     privateBits_->dictionaryFilteringSizeThreshold = threshold;
     return *this;
@@ -374,6 +419,39 @@ namespace orc {
     return privateBits_->dictionaryFilteringSizeThreshold;
   }
 
+  RowReaderOptions& RowReaderOptions::setDecodeThreads(uint32_t numThreads) {
+    privateBits_->decodeThreads = numThreads;
+    return *this;
+  }
+
+  uint32_t RowReaderOptions::getDecodeThreads() const {
+    return privateBits_->decodeThreads;
+  }
+
+  RowReaderOptions& RowReaderOptions::setRowFilter(const std::list<std::string>& columns,
+                                                   RowFilter filter) {
+    privateBits_->rowFilterColumns = columns;
+    privateBits_->rowFilter = std::move(filter);
+    return *this;
+  }
+
+  const RowReaderOptions::RowFilter& RowReaderOptions::getRowFilter() const {
+    return privateBits_->rowFilter;
+  }
+
+  const std::list<std::string>& RowReaderOptions::getRowFilterColumns() const {
+    return privateBits_->rowFilterColumns;
+  }
+
+  RowReaderOptions& RowReaderOptions::setFilterRowsBySearchArgument(bool filter) {
+    privateBits_->filterRowsBySearchArgument = filter;
+    return *this;
+  }
+
+  bool RowReaderOptions::getFilterRowsBySearchArgument() const {
+    return privateBits_->filterRowsBySearchArgument;
+  }
+
 }  // namespace orc
 
 #endif
@@ -19,8 +19,10 @@
 #include "orc/OrcFile.hh"
 #include "Adaptor.hh"
 #include "Utils.hh"
+#include "io/AsyncFileReader.hh"
 #include "orc/Exceptions.hh"
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <stdio.h>
@@ -35,6 +37,7 @@
 #define fstat _fstat64
 #define fsync _commit
 #else
+#include <sys/mman.h>
 #include <unistd.h>
 #define O_BINARY 0
 #endif
@@ -53,10 +56,29 @@ namespace orc {
     int file_;
     uint64_t totalLength_;
     ReaderMetrics* metrics_;
+    std::unique_ptr<AsyncFileReader> asyncReader_;
+    IOExecutor* executor_;
+    char* mapped_;
+
+    void map() {
+#ifndef _MSC_VER
+      if (totalLength_ == 0) {
+        return;
+      }
+      void* addr = mmap(nullptr, totalLength_, PROT_READ, MAP_SHARED, file_, 0);
+      if (addr == MAP_FAILED) {
+        return;
+      }
+      mapped_ = static_cast<char*>(addr);
+      // only the ranges of the selected columns are advised to be paged in,
+      // so keep the kernel from reading ahead into the other columns
+      madvise(mapped_, totalLength_, MADV_RANDOM);
+#endif
+    }
 
    public:
     FileInputStream(std::string filename, ReaderMetrics* metrics)
-        : filename_(filename), metrics_(metrics) {
+        : filename_(filename), metrics_(metrics), executor_(nullptr), mapped_(nullptr) {
       file_ = open(filename_.c_str(), O_BINARY | O_RDONLY);
       if (file_ == -1) {
         throw ParseError("Can't open " + filename_);
@@ -68,6 +90,17 @@ namespace orc {
       totalLength_ = static_cast<uint64_t>(fileStat.st_size);
     }
 
+    FileInputStream(std::string filename, ReaderMetrics* metrics, const LocalFileOptions& options)
+        : FileInputStream(std::move(filename), metrics) {
+      if (options.memoryMap) {
+        map();
+      }
+      if (!mapped_ && options.asyncMode == LocalFileAsyncMode::IO_URING) {
+        asyncReader_ = createIoUringFileReader(file_, filename_, options.queueDepth, metrics_);
+      }
+      executor_ = options.executor;
+    }
+
     ~FileInputStream() override;
 
     uint64_t getLength() const override {
@@ -83,6 +116,13 @@ namespace orc {
       if (!buf) {
         throw ParseError("Buffer is null");
       }
+      if (mapped_) {
+        if (offset > totalLength_ || length > totalLength_ - offset) {
+          throw ParseError("Short read of " + filename_);
+        }
+        memcpy(buf, mapped_ + offset, length);
+        return;
+      }
       ssize_t bytesRead = pread(file_, buf, length, static_cast<off_t>(offset));
 
       if (bytesRead == -1) {
@@ -93,12 +133,52 @@ namespace orc {
       }
     }
 
+    // read() and the io_uring reader record metrics_ already
+    std::future<void> readAsync(void* buf, uint64_t length, uint64_t offset,
+                                ReaderMetrics*) override {
+      if (asyncReader_) {
+        if (!buf) {
+          throw ParseError("Buffer is null");
+        }
+        return asyncReader_->submit(buf, length, offset);
+      }
+      IOExecutor* executor = executor_ ? executor_ : getDefaultIOExecutor();
+      return executor->submit(
+          this, [this, buf, length, offset] { read(buf, length, offset); }, metrics_);
+    }
+
+    const char* getMappedData() const override {
+      return mapped_;
+    }
+
+    void adviseWillNeed(uint64_t offset, uint64_t length) override {
+#ifndef _MSC_VER
+      if (mapped_ && offset < totalLength_) {
+        // madvise() wants a page-aligned start
+        uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+        uint64_t start = offset - offset % pageSize;
+        uint64_t end = std::min(totalLength_, offset + length);
+        madvise(mapped_ + start, end - start, MADV_WILLNEED);
+      }
+#else
+      (void)offset;
+      (void)length;
+#endif
+    }
+
     const std::string& getName() const override {
       return filename_;
     }
   };
 
   FileInputStream::~FileInputStream() {
+    // stop in-flight reads before the descriptor goes away
+    asyncReader_.reset();
+#ifndef _MSC_VER
+    if (mapped_) {
+      munmap(mapped_, totalLength_);
+    }
+#endif
     close(file_);
   }
 
@@ -112,6 +192,11 @@ namespace orc {
     return std::make_unique<FileInputStream>(path, metrics);
   }
 
+  std::unique_ptr<InputStream> readLocalFile(const std::string& path, ReaderMetrics* metrics,
+                                             const LocalFileOptions& options) {
+    return std::make_unique<FileInputStream>(path, metrics, options);
+  }
+
   OutputStream::~OutputStream(){
       // PASS
   };
@@ -0,0 +1,187 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "ParallelScan.hh"
+#include "Reader.hh"
+
+#include <algorithm>
+#include <atomic>
+#include <deque>
+#include <exception>
+#include <limits>
+#include <mutex>
+#include <set>
+#include <thread>
+#include <vector>
+
+namespace orc {
+
+  class ParallelScanImpl : public ParallelScan {
+   private:
+    // stripes waiting to be read by one thread
+    struct StripeQueue {
+      std::mutex mutex;
+      std::deque<uint64_t> stripes;
+    };
+
+    std::shared_ptr<FileContents> contents_;
+    const RowReaderOptions options_;
+    const uint32_t numThreads_;
+    // describes the selected rows and evaluates the file statistics; it never reads
+    std::unique_ptr<RowReaderImpl> prototype_;
+    std::vector<uint64_t> stripes_;
+
+    std::vector<std::unique_ptr<StripeQueue>> queues_;
+    // offsets of the stripes that are not read yet
+    std::mutex unfinishedMutex_;
+    std::set<uint64_t> unfinished_;
+    std::atomic<bool> failed_;
+    std::mutex errorMutex_;
+    std::exception_ptr error_;
+
+    bool takeStripe(size_t thread, uint64_t& stripe) {
+      {
+        StripeQueue& own = *queues_[thread];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.stripes.empty()) {
+          stripe = own.stripes.front();
+          own.stripes.pop_front();
+          return true;
+        }
+      }
+      // Steal the last stripe of another thread, which is the one its owner
+      // would get to last.
+      for (size_t i = 1; i < queues_.size(); ++i) {
+        StripeQueue& victim = *queues_[(thread + i) % queues_.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.stripes.empty()) {
+          stripe = victim.stripes.back();
+          victim.stripes.pop_back();
+          return true;
+        }
+      }
+      return false;
+    }
+
+    void finishStripe(uint64_t offset) {
+      if (!options_.getEnableAsyncPrefetch()) {
+        return;
+      }
+      uint64_t boundary;
+      {
+        std::lock_guard<std::mutex> lock(unfinishedMutex_);
+        unfinished_.erase(offset);
+        boundary =
+            unfinished_.empty() ? std::numeric_limits<uint64_t>::max() : *unfinished_.begin();
+      }
+      // ranges cached for any stripe that still has to be read must survive
+      contents_->evictCache(boundary);
+    }
+
+    void scanStripes(size_t thread, ColumnVectorBatch& batch, const Consumer& consumer) {
+      // one reader per thread; run() has checked the file statistics
+      RowReaderImpl rowReader(contents_, options_, /*evictCache=*/false);
+      uint64_t stripe;
+      while (!failed_.load() && takeStripe(thread, stripe)) {
+        uint64_t offset = contents_->footer->stripes(static_cast<int>(stripe)).offset();
+        rowReader.seekToStripe(stripe);
+        while (!failed_.load() && rowReader.next(batch)) {
+          consumer(batch, rowReader.getRowNumber());
+        }
+        finishStripe(offset);
+      }
+    }
+
+   public:
+    ParallelScanImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& options,
+                     uint32_t numThreads)
+        : contents_(std::move(contents)),
+          options_(options),
+          numThreads_(numThreads > 0 ? numThreads
+                                     : std::max(std::thread::hardware_concurrency(), 1u)),
+          prototype_(std::make_unique<RowReaderImpl>(contents_, options, false)),
+          failed_(false) {
+      const proto::Footer& footer = *contents_->footer;
+      for (int i = 0; i < footer.stripes_size(); ++i) {
+        uint64_t offset = footer.stripes(i).offset();
+        if (offset >= options.getOffset() && offset < options.getOffset() + options.getLength()) {
+          stripes_.push_back(static_cast<uint64_t>(i));
+        }
+      }
+    }
+
+    const Type& getSelectedType() const override {
+      return prototype_->getSelectedType();
+    }
+
+    void run(uint64_t batchSize, const Consumer& consumer) override {
+      size_t numThreads = std::min<size_t>(numThreads_, stripes_.size());
+      if (numThreads == 0 || !prototype_->mayMatchFileStatistics()) {
+        return;
+      }
+
+      // hand out neighboring stripes to the same thread to keep its reads sequential
+      queues_.clear();
+      unfinished_.clear();
+      for (size_t i = 0; i < numThreads; ++i) {
+        queues_.push_back(std::make_unique<StripeQueue>());
+      }
+      for (size_t i = 0; i < stripes_.size(); ++i) {
+        queues_[i * numThreads / stripes_.size()]->stripes.push_back(stripes_[i]);
+        unfinished_.insert(contents_->footer->stripes(static_cast<int>(stripes_[i])).offset());
+      }
+      failed_ = false;
+      error_ = nullptr;
+
+      std::vector<std::unique_ptr<ColumnVectorBatch>> batches;
+      for (size_t i = 0; i < numThreads; ++i) {
+        batches.push_back(prototype_->createRowBatch(batchSize));
+      }
+
+      std::vector<std::thread> threads;
+      threads.reserve(numThreads);
+      for (size_t i = 0; i < numThreads; ++i) {
+        threads.emplace_back([this, i, &batches, &consumer] {
+          try {
+            scanStripes(i, *batches[i], consumer);
+          } catch (...) {
+            std::lock_guard<std::mutex> lock(errorMutex_);
+            if (!error_) {
+              error_ = std::current_exception();
+            }
+            failed_ = true;
+          }
+        });
+      }
+      for (auto& thread : threads) {
+        thread.join();
+      }
+      if (error_) {
+        std::rethrow_exception(error_);
+      }
+    }
+  };
+
+  std::unique_ptr<ParallelScan> createParallelScan(std::shared_ptr<FileContents> contents,
+                                                   const RowReaderOptions& options,
+                                                   uint32_t numThreads) {
+    return std::make_unique<ParallelScanImpl>(std::move(contents), options, numThreads);
+  }
+
+}  // namespace orc
@@ -0,0 +1,41 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_PARALLEL_SCAN_HH
+#define ORC_PARALLEL_SCAN_HH
+
+#include "orc/Reader.hh"
+
+#include <memory>
+
+namespace orc {
+
+  struct FileContents;
+
+  /**
+   * Create a scan over the stripes selected by options that shares contents
+   * between its threads.
+   */
+  std::unique_ptr<ParallelScan> createParallelScan(std::shared_ptr<FileContents> contents,
+                                                   const RowReaderOptions& options,
+                                                   uint32_t numThreads);
+
+}  // namespace orc
+
+#endif
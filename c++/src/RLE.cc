@@ -20,6 +20,9 @@
 #include "RLEv2.hh"
 #include "orc/Exceptions.hh"
 
+#include <algorithm>
+#include <cstring>
+
 namespace orc {
 
   RleEncoder::~RleEncoder() {
@@ -106,8 +109,26 @@ namespace orc {
     buffer[bufferPosition++] = c;
   }
 
+  void RleEncoder::writeBytes(const char* data, size_t length) {
+    while (length > 0) {
+      if (bufferPosition == bufferLength) {
+        int addedSize = 0;
+        if (!outputStream->Next(reinterpret_cast<void**>(&buffer), &addedSize)) {
+          throw std::bad_alloc();
+        }
+        bufferPosition = 0;
+        bufferLength = static_cast<size_t>(addedSize);
+      }
+      size_t copyLength = std::min(length, bufferLength - bufferPosition);
+      memcpy(buffer + bufferPosition, data, copyLength);
+      bufferPosition += copyLength;
+      data += copyLength;
+      length -= copyLength;
+    }
+  }
+
   void RleEncoder::recordPosition(PositionRecorder* recorder) const {
-    uint64_t flushedSize = outputStream->getSize();
+    uint64_t flushedSize = outputStream->getExactSize();
     uint64_t unusedBufferSize = static_cast<uint64_t>(bufferLength - bufferPosition);
     if (outputStream->isCompressed()) {
       recorder->add(flushedSize);
@@ -101,6 +101,8 @@ namespace orc {
 
     virtual void writeByte(char c);
 
+    void writeBytes(const char* data, size_t length);
+
     virtual void writeVulong(int64_t val);
 
     virtual void writeVslong(int64_t val);
@@ -21,10 +21,12 @@
 #include "BloomFilter.hh"
 #include "DictionaryLoader.hh"
 #include "Options.hh"
+#include "ParallelScan.hh"
 #include "RLE.hh"
 #include "Statistics.hh"
 #include "StripeStream.hh"
 #include "Utils.hh"
+#include "sargs/SargsRowFilter.hh"
 
 #include "wrap/coded-stream-wrapper.h"
 
@@ -267,8 +269,20 @@ namespace orc {
       proto::Stream_Kind_DATA, proto::Stream_Kind_DICTIONARY_DATA, proto::Stream_Kind_PRESENT,
       proto::Stream_Kind_LENGTH, proto::Stream_Kind_SECONDARY};
 
-  static const std::unordered_set<proto::Stream_Kind> INDEX_STREAM_KINDS = {
-      proto::Stream_Kind_ROW_INDEX, proto::Stream_Kind_BLOOM_FILTER_UTF8};
+  static void checkStreamRange(uint64_t stripeIndex, const proto::StripeInformation& stripeInfo,
+                               int streamIndex, uint64_t offset, uint64_t length) {
+    uint64_t stripeFooterStart =
+        stripeInfo.offset() + stripeInfo.index_length() + stripeInfo.data_length();
+    if (offset + length > stripeFooterStart) {
+      std::stringstream msg;
+      msg << "Malformed stream meta at stream index " << streamIndex << " in stripe "
+          << stripeIndex << ": streamOffset=" << offset << ", streamLength=" << length
+          << ", stripeOffset=" << stripeInfo.offset()
+          << ", stripeIndexLength=" << stripeInfo.index_length()
+          << ", stripeDataLength=" << stripeInfo.data_length();
+      throw ParseError(msg.str());
+    }
+  }
 
   std::vector<ReadRange> extractReadRangesForStripe(
       uint64_t stripeIndex, const proto::StripeInformation& stripeInfo,
@@ -276,21 +290,11 @@ namespace orc {
       const std::unordered_set<proto::Stream_Kind>& allowedKinds = DATA_STREAM_KINDS) {
     std::vector<ReadRange> ranges;
 
-    uint64_t stripeFooterStart =
-        stripeInfo.offset() + stripeInfo.index_length() + stripeInfo.data_length();
     uint64_t offset = stripeInfo.offset();
 
     for (int i = 0; i < stripeFooter.streams_size(); i++) {
       const proto::Stream& stream = stripeFooter.streams(i);
-      if (offset + stream.length() > stripeFooterStart) {
-        std::stringstream msg;
-        msg << "Malformed stream meta at stream index " << i << " in stripe " << stripeIndex
-            << ": streamOffset=" << offset << ", streamLength=" << stream.length()
-            << ", stripeOffset=" << stripeInfo.offset()
-            << ", stripeIndexLength=" << stripeInfo.index_length()
-            << ", stripeDataLength=" << stripeInfo.data_length();
-        throw ParseError(msg.str());
-      }
+      checkStreamRange(stripeIndex, stripeInfo, i, offset, stream.length());
 
       if (stream.has_kind() && selectedColumns[stream.column()]) {
         if (allowedKinds.find(stream.kind()) != allowedKinds.cend()) {
@@ -304,13 +308,145 @@ namespace orc {
     return ranges;
   }
 
-  RowReaderImpl::RowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& opts)
+  /**
+   * Get the index of the first position of a stream in the row index entries
+   * of its column.
+   * @return -1 if the stream isn't positioned per row group, e.g. because it
+   *         belongs to the dictionary
+   */
+  static int getStreamPositionIndex(TypeKind typeKind, proto::ColumnEncoding_Kind encoding,
+                                    proto::Stream_Kind streamKind, bool isCompressed,
+                                    bool hasNulls) {
+    // Each stream records the offset of its compressed chunk (if any), the
+    // offset in the uncompressed bytes, and then the offset into the current
+    // run for RLE streams and into the current byte for bit fields.
+    const int compressedPositions = isCompressed ? 1 : 0;
+    const int byteStreamPositions = compressedPositions + 1;
+    const int runLengthPositions = compressedPositions + 2;
+    const int bitFieldPositions = compressedPositions + 3;
+
+    if (streamKind == proto::Stream_Kind_PRESENT) {
+      return 0;
+    }
+    int base = hasNulls ? bitFieldPositions : 0;
+    switch (typeKind) {
+      case STRING:
+      case VARCHAR:
+      case CHAR:
+        if (encoding == proto::ColumnEncoding_Kind_DICTIONARY ||
+            encoding == proto::ColumnEncoding_Kind_DICTIONARY_V2) {
+          return streamKind == proto::Stream_Kind_DATA ? base : -1;
+        }
+        return streamKind == proto::Stream_Kind_DATA ? base : base + byteStreamPositions;
+      case BINARY:
+      case DECIMAL:
+      case GEOMETRY:
+      case GEOGRAPHY:
+        return streamKind == proto::Stream_Kind_DATA ? base : base + byteStreamPositions;
+      case TIMESTAMP:
+      case TIMESTAMP_INSTANT:
+        return streamKind == proto::Stream_Kind_DATA ? base : base + runLengthPositions;
+      default:
+        return base;
+    }
+  }
+
+  static std::vector<ReadRange> extractReadRangesForRowGroups(
+      uint64_t stripeIndex, const proto::StripeInformation& stripeInfo,
+      const proto::StripeFooter& stripeFooter, const std::vector<bool>& selectedColumns,
+      const Type& schema,
+      const std::unordered_map<uint64_t, std::shared_ptr<const proto::RowIndex>>& rowIndexes,
+      const std::vector<bool>& selectedRowGroups, bool isCompressed, uint64_t blockSize) {
+    // A row group ends somewhere after the next one starts: its last run or
+    // compression chunk may extend past that position.
+    const uint64_t slop = isCompressed ? 2 * (3 + blockSize) : 2 + 8 * 512;
+
+    std::unordered_set<uint64_t> columnsWithNulls;
+    for (int i = 0; i < stripeFooter.streams_size(); i++) {
+      const proto::Stream& stream = stripeFooter.streams(i);
+      if (stream.has_kind() && stream.kind() == proto::Stream_Kind_PRESENT) {
+        columnsWithNulls.insert(stream.column());
+      }
+    }
+
+    std::vector<ReadRange> ranges;
+    uint64_t offset = stripeInfo.offset();
+    for (int i = 0; i < stripeFooter.streams_size(); i++) {
+      const proto::Stream& stream = stripeFooter.streams(i);
+      checkStreamRange(stripeIndex, stripeInfo, i, offset, stream.length());
+      uint64_t streamOffset = offset;
+      uint64_t streamLength = stream.length();
+      offset += streamLength;
+
+      if (!stream.has_kind() || !selectedColumns[stream.column()] ||
+          DATA_STREAM_KINDS.find(stream.kind()) == DATA_STREAM_KINDS.cend()) {
+        continue;
+      }
+
+      const Type* type = schema.getTypeByColumnId(stream.column());
+      auto rowIndex = rowIndexes.find(stream.column());
+      int position = -1;
+      if (type != nullptr && rowIndex != rowIndexes.cend() &&
+          static_cast<int>(stream.column()) < stripeFooter.columns_size()) {
+        position = getStreamPositionIndex(
+            type->getKind(), stripeFooter.columns(static_cast<int>(stream.column())).kind(),
+            stream.kind(), isCompressed, columnsWithNulls.count(stream.column()) != 0);
+      }
+
+      std::vector<ReadRange> streamRanges;
+      for (int rg = 0; position >= 0 && rg < rowIndex->second->entry_size(); ++rg) {
+        if (static_cast<size_t>(rg) >= selectedRowGroups.size() || !selectedRowGroups[rg]) {
+          continue;
+        }
+        const proto::RowIndexEntry& entry = rowIndex->second->entry(rg);
+        if (entry.positions_size() <= position) {
+          position = -1;
+          break;
+        }
+        uint64_t start = entry.positions(position);
+        uint64_t end = streamLength;
+        if (rg + 1 < rowIndex->second->entry_size()) {
+          const proto::RowIndexEntry& nextEntry = rowIndex->second->entry(rg + 1);
+          if (nextEntry.positions_size() <= position) {
+            position = -1;
+            break;
+          }
+          end = std::min(streamLength, nextEntry.positions(position) + slop);
+        }
+        if (start >= end) {
+          continue;
+        }
+        if (!streamRanges.empty() &&
+            start <= streamRanges.back().offset + streamRanges.back().length) {
+          ReadRange& last = streamRanges.back();
+          last.length = std::max(end, last.offset + last.length) - last.offset;
+        } else {
+          streamRanges.emplace_back(start, end - start);
+        }
+      }
+
+      if (position < 0) {
+        // the whole stream is needed
+        ranges.emplace_back(streamOffset, streamLength);
+      } else {
+        for (const auto& range : streamRanges) {
+          ranges.emplace_back(streamOffset + range.offset, range.length);
+        }
+      }
+    }
+    return ranges;
+  }
+
+  RowReaderImpl::RowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& opts,
+                               bool evictCache)
       : localTimezone_(getLocalTimezone()),
         contents_(contents),
         throwOnHive11DecimalOverflow_(opts.getThrowOnHive11DecimalOverflow()),
         forcedScaleOnHive11Decimal_(opts.getForcedScaleOnHive11Decimal()),
         enableAsyncPrefetch_(opts.getEnableAsyncPrefetch()),
         smallStripeLookAheadLimit_(opts.getSmallStripeLookAheadLimit()),
+        prefetchWindowSize_(opts.getPrefetchWindowSize()),
+        evictCache_(evictCache),
         footer_(contents_->footer.get()),
         firstRowOfStripe_(*contents_->pool, 0),
         enableEncodedBlock_(opts.getEnableLazyDecoding()),
@@ -323,6 +459,7 @@ namespace orc {
     currentRowInStripe_ = 0;
     rowsInCurrentStripe_ = 0;
     numRowGroupsInStripeRange_ = 0;
+    checkFileStatistics_ = true;
     useTightNumericVector_ = opts.getUseTightNumericVector();
     throwOnSchemaEvolutionOverflow_ = opts.getThrowOnSchemaEvolutionOverflow();
     uint64_t rowTotal = 0;
@@ -372,6 +509,61 @@ namespace orc {
     }
 
     skipBloomFilters_ = hasBadBloomFilters();
+
+    if (opts.getDecodeThreads() > 1) {
+      decodePool_ = std::make_unique<ColumnDecodePool>(opts.getDecodeThreads());
+    }
+
+    bool filterBySargs = opts.getFilterRowsBySearchArgument() && opts.getSearchArgument();
+    if (opts.getRowFilter() || filterBySargs) {
+      // find the fields of the batch that the filters read
+      const Type& schema = *contents_->schema;
+      std::vector<std::string> fieldNames;
+      std::vector<uint64_t> fieldColumnIds;
+      if (schema.getKind() == STRUCT) {
+        for (uint64_t i = 0; i < schema.getSubtypeCount(); ++i) {
+          if (selectedColumns_[schema.getSubtype(i)->getColumnId()]) {
+            fieldNames.push_back(schema.getFieldName(i));
+            fieldColumnIds.push_back(schema.getSubtype(i)->getColumnId());
+          }
+        }
+      }
+      filterFields_.assign(fieldNames.size(), false);
+      for (const auto& column : opts.getRowFilterColumns()) {
+        auto field = std::find(fieldNames.begin(), fieldNames.end(), column);
+        if (field == fieldNames.end()) {
+          throw ParseError("Row filter column " + column + " is not selected");
+        }
+        filterFields_[static_cast<size_t>(field - fieldNames.begin())] = true;
+      }
+      rowFilter_ = opts.getRowFilter();
+      if (filterBySargs && !fieldNames.empty()) {
+        auto sargsFilter = std::make_shared<SargsRowFilter>(opts.getSearchArgument(), fieldNames,
+                                                            fieldColumnIds);
+        for (size_t field : sargsFilter->getFields()) {
+          filterFields_[field] = true;
+        }
+        RowReaderOptions::RowFilter userFilter = rowFilter_;
+        rowFilter_ = [sargsFilter, userFilter](const ColumnVectorBatch& batch, char* selected) {
+          if (userFilter) {
+            userFilter(batch, selected);
+          }
+          sargsFilter->filter(batch, selected);
+        };
+      }
+      for (size_t i = 0; i < std::max<size_t>(fieldNames.size(), 1); ++i) {
+        stringArenas_.push_back(std::make_unique<StringArena>(*contents_->pool));
+      }
+    }
+  }
+
+  RowReaderImpl::~RowReaderImpl() {
+    // return the borrowed decompressors before the idle ones are freed
+    decodePool_.reset();
+    reader_.reset();
+    if (contents_->decompressorPool) {
+      releaseIdleDecompressors(*contents_->decompressorPool);
+    }
   }
 
   // Check if the file has inconsistent bloom filters.
@@ -501,64 +693,97 @@ namespace orc {
     rowIndexes_.clear();
     bloomFilterIndex_.clear();
 
-    if (enableAsyncPrefetch_ &&
-        fullyCachedStripes_.find(currentStripe_) == fullyCachedStripes_.end()) {
-      // Cache required ranges of index which are usually very small
-      auto ranges =
-          extractReadRangesForStripe(currentStripe_, currentStripeInfo_, currentStripeFooter_,
-                                     selectedColumns_, INDEX_STREAM_KINDS);
-      contents_->cacheRanges(std::move(ranges));
-    }
+    IndexCache* indexCache = contents_->indexCache.get();
+    bool isIndexPrefetched = !enableAsyncPrefetch_ ||
+                             fullyCachedStripes_.find(currentStripe_) != fullyCachedStripes_.end();
 
-    // obtain row indexes for selected columns
+    // obtain row indexes for selected columns from the cache, and find the
+    // streams of the others
+    std::vector<int> missingStreams;
+    std::vector<ReadRange> missingRanges;
     uint64_t offset = currentStripeInfo_.offset();
     for (int i = 0; i < currentStripeFooter_.streams_size(); ++i) {
       const proto::Stream& pbStream = currentStripeFooter_.streams(i);
       uint64_t colId = pbStream.column();
+      bool isRowIndex = pbStream.kind() == proto::Stream_Kind_ROW_INDEX;
       if (selectedColumns_[colId] && pbStream.has_kind() &&
-          (pbStream.kind() == proto::Stream_Kind_ROW_INDEX ||
-           pbStream.kind() == proto::Stream_Kind_BLOOM_FILTER_UTF8)) {
-        std::unique_ptr<SeekableInputStream> inStream;
-        BufferSlice slice;
-
-        {
-          std::lock_guard<std::mutex> lock(contents_->readCacheMutex);
-          if (contents_->readCache) {
-            slice = contents_->readCache->read(ReadRange(offset, pbStream.length()));
+          (isRowIndex ||
+           (pbStream.kind() == proto::Stream_Kind_BLOOM_FILTER_UTF8 && !skipBloomFilters_))) {
+        bool isCached = false;
+        if (indexCache && isRowIndex) {
+          if (auto rowIndex = indexCache->getRowIndex(currentStripe_, colId)) {
+            rowIndexes_[colId] = std::move(rowIndex);
+            isCached = true;
+          }
+        } else if (indexCache) {
+          if (auto bfIndex = indexCache->getBloomFilters(currentStripe_, colId)) {
+            bloomFilterIndex_[static_cast<uint32_t>(colId)] = *bfIndex;
+            isCached = true;
           }
         }
-        if (slice.buffer) {
-          inStream = std::make_unique<SeekableArrayInputStream>(slice.buffer->data() + slice.offset,
-                                                                slice.length);
-        } else {
-          inStream = std::make_unique<SeekableFileInputStream>(contents_->stream.get(), offset,
-                                                               pbStream.length(), *contents_->pool);
+        if (!isCached) {
+          checkStreamRange(currentStripe_, currentStripeInfo_, i, offset, pbStream.length());
+          missingStreams.push_back(i);
+          missingRanges.emplace_back(offset, pbStream.length());
         }
-        inStream = createDecompressor(getCompression(), std::move(inStream), getCompressionSize(),
-                                      *contents_->pool, contents_->readerMetrics);
+      }
+      offset += pbStream.length();
+    }
 
-        if (pbStream.kind() == proto::Stream_Kind_ROW_INDEX) {
-          proto::RowIndex rowIndex;
-          if (!parseProtobufFromStream(&rowIndex, inStream.get())) {
-            throw ParseError("Failed to parse the row index");
-          }
-          rowIndexes_[colId] = rowIndex;
-        } else if (!skipBloomFilters_) {  // Stream_Kind_BLOOM_FILTER_UTF8
-          proto::BloomFilterIndex pbBFIndex;
-          if (!parseProtobufFromStream(&pbBFIndex, inStream.get())) {
-            throw ParseError("Failed to parse bloom filter index");
-          }
-          BloomFilterIndex bfIndex;
-          for (int j = 0; j < pbBFIndex.bloom_filter_size(); j++) {
-            bfIndex.entries.push_back(BloomFilterUTF8Utils::deserialize(
-                pbStream.kind(), currentStripeFooter_.columns(static_cast<int>(pbStream.column())),
-                pbBFIndex.bloom_filter(j)));
-          }
-          // add bloom filters to result for one column
-          bloomFilterIndex_[pbStream.column()] = bfIndex;
+    if (!isIndexPrefetched && !missingRanges.empty()) {
+      // Cache required ranges of index which are usually very small
+      contents_->cacheRanges(missingRanges);
+    }
+
+    std::shared_ptr<ReadRangeCache> readCache = contents_->getReadCache();
+    for (size_t m = 0; m < missingStreams.size(); ++m) {
+      const proto::Stream& pbStream = currentStripeFooter_.streams(missingStreams[m]);
+      uint64_t colId = pbStream.column();
+      const ReadRange& range = missingRanges[m];
+      std::unique_ptr<SeekableInputStream> inStream;
+      BufferSlice slice;
+      if (readCache) {
+        slice = readCache->read(range);
+      }
+      if (slice.buffer) {
+        inStream = std::make_unique<SeekableArrayInputStream>(slice.buffer->data() + slice.offset,
+                                                              slice.length);
+      } else {
+        inStream = std::make_unique<SeekableFileInputStream>(contents_->stream.get(), range.offset,
+                                                             range.length, *contents_->pool);
+      }
+      inStream = createDecompressor(getCompression(), std::move(inStream), getCompressionSize(),
+                                    *contents_->pool, contents_->readerMetrics,
+                                    contents_->decompressorPool);
+
+      if (pbStream.kind() == proto::Stream_Kind_ROW_INDEX) {
+        auto rowIndex = std::make_shared<proto::RowIndex>();
+        if (!parseProtobufFromStream(rowIndex.get(), inStream.get())) {
+          throw ParseError("Failed to parse the row index");
+        }
+        if (indexCache) {
+          indexCache->putRowIndex(currentStripe_, colId, rowIndex);
         }
+        rowIndexes_[colId] = std::move(rowIndex);
+      } else {  // Stream_Kind_BLOOM_FILTER_UTF8
+        proto::BloomFilterIndex pbBFIndex;
+        if (!parseProtobufFromStream(&pbBFIndex, inStream.get())) {
+          throw ParseError("Failed to parse bloom filter index");
+        }
+        BloomFilterIndex bfIndex;
+        for (int j = 0; j < pbBFIndex.bloom_filter_size(); j++) {
+          bfIndex.entries.push_back(BloomFilterUTF8Utils::deserialize(
+              pbStream.kind(), currentStripeFooter_.columns(static_cast<int>(pbStream.column())),
+              pbBFIndex.bloom_filter(j)));
+        }
+        if (indexCache) {
+          indexCache->putBloomFilters(currentStripe_, colId,
+                                      std::make_shared<BloomFilterIndex>(bfIndex),
+                                      static_cast<uint64_t>(pbBFIndex.SpaceUsedLong()));
+        }
+        // add bloom filters to result for one column
+        bloomFilterIndex_[pbStream.column()] = std::move(bfIndex);
       }
-      offset += pbStream.length();
     }
   }
 
@@ -571,7 +796,7 @@ namespace orc {
     for (auto rowIndex = rowIndexes_.cbegin(); rowIndex != rowIndexes_.cend(); ++rowIndex) {
       uint64_t colId = rowIndex->first;
       const proto::RowIndexEntry& entry =
-          rowIndex->second.entry(static_cast<int32_t>(rowGroupEntryId));
+          rowIndex->second->entry(static_cast<int32_t>(rowGroupEntryId));
 
       // copy index positions for a specific column
       positions.push_back({});
@@ -608,12 +833,8 @@ namespace orc {
 
     std::unique_ptr<SeekableInputStream> pbStream;
     BufferSlice slice;
-
-    {
-      std::lock_guard<std::mutex> lock(contents.readCacheMutex);
-      if (contents.readCache) {
-        slice = contents.readCache->read(ReadRange(stripeFooterStart, stripeFooterLength));
-      }
+    if (std::shared_ptr<ReadRangeCache> readCache = contents.getReadCache()) {
+      slice = readCache->read(ReadRange(stripeFooterStart, stripeFooterLength));
     }
     if (slice.buffer) {
       pbStream = std::make_unique<SeekableArrayInputStream>(slice.buffer->data() + slice.offset,
@@ -623,7 +844,8 @@ namespace orc {
                                                            stripeFooterLength, *contents.pool);
     }
     pbStream = createDecompressor(contents.compression, std::move(pbStream), contents.blockSize,
-                                  *contents.pool, contents.readerMetrics);
+                                  *contents.pool, contents.readerMetrics,
+                                  contents.decompressorPool);
 
     proto::StripeFooter result;
     if (!parseProtobufFromStream(&result, pbStream.get())) {
@@ -639,6 +861,42 @@ namespace orc {
     return result;
   }
 
+  /**
+   * The tail of a file in a FileTailCache. It is immutable, so a reader that
+   * loads the metadata replaces it with a new one.
+   */
+  class FileTailCacheEntry : public CachedFileTail {
+   public:
+    const std::shared_ptr<const proto::PostScript> postscript;
+    const std::shared_ptr<const proto::Footer> footer;
+    const uint64_t postscriptLength;
+    // nullptr until a reader has loaded it
+    const std::shared_ptr<const LazyMetadata> metadata;
+
+    FileTailCacheEntry(std::shared_ptr<const proto::PostScript> ps,
+                       std::shared_ptr<const proto::Footer> ft, uint64_t psLength,
+                       std::shared_ptr<const LazyMetadata> md)
+        : postscript(std::move(ps)),
+          footer(std::move(ft)),
+          postscriptLength(psLength),
+          metadata(std::move(md)),
+          tailMemoryUsage_(postscript->SpaceUsedLong() + footer->SpaceUsedLong()) {}
+
+    // grows as the readers of the file decode stripe statistics
+    uint64_t getMemoryUsage() const override {
+      return tailMemoryUsage_ + (metadata ? metadata->getMemoryUsage() : 0);
+    }
+
+   private:
+    const uint64_t tailMemoryUsage_;
+  };
+
+  std::string getFileTailCacheKey(const std::string& name, uint64_t fileLength,
+                                  const std::string& token) {
+    // the token is length-prefixed, so that no two keys can collide
+    return std::to_string(fileLength) + ":" + std::to_string(token.size()) + ":" + token + name;
+  }
+
   ReaderImpl::ReaderImpl(std::shared_ptr<FileContents> contents, const ReaderOptions& opts,
                          uint64_t fileLength, uint64_t postscriptLength)
       : contents_(std::move(contents)),
@@ -646,12 +904,16 @@ namespace orc {
         fileLength_(fileLength),
         postscriptLength_(postscriptLength),
         footer_(contents_->footer.get()) {
-    isMetadataLoaded_ = false;
+    // the metadata may come from a FileTailCache
+    isMetadataLoaded_ = contents_->metadata != nullptr;
     checkOrcVersion();
     numberOfStripes_ = static_cast<uint64_t>(footer_->stripes_size());
     contents_->schema = convertType(footer_->types(0), *footer_);
     contents_->blockSize = getCompressionBlockSize(*contents_->postscript);
     contents_->compression = convertCompressionKind(*contents_->postscript);
+    if (contents_->compression != CompressionKind_NONE) {
+      contents_->decompressorPool = createDecompressorPool(*contents_->pool);
+    }
   }
 
   std::string ReaderImpl::getSerializedFileTail() const {
@@ -689,9 +951,7 @@ namespace orc {
     if (!isMetadataLoaded_) {
       readMetadata();
     }
-    return contents_->metadata == nullptr
-               ? 0
-               : static_cast<uint64_t>(contents_->metadata->stripe_stats_size());
+    return contents_->metadata == nullptr ? 0 : contents_->metadata->getNumberOfStripes();
   }
 
   std::unique_ptr<StripeInformation> ReaderImpl::getStripe(uint64_t stripeIndex) const {
@@ -819,7 +1079,8 @@ namespace orc {
             createDecompressor(contents_->compression,
                                std::unique_ptr<SeekableInputStream>(new SeekableFileInputStream(
                                    contents_->stream.get(), offset, length, *contents_->pool)),
-                               contents_->blockSize, *(contents_->pool), contents_->readerMetrics);
+                               contents_->blockSize, *(contents_->pool), contents_->readerMetrics,
+                               contents_->decompressorPool);
 
         proto::RowIndex rowIndex;
         if (!parseProtobufFromStream(&rowIndex, pbStream.get())) {
@@ -866,19 +1127,18 @@ namespace orc {
                                    : getLocalTimezone();
     StatContext statContext(hasCorrectStatistics(), &writerTZ);
 
+    proto::StripeStatistics stripeStats = contents_->metadata->getStripeStatistics(stripeIndex);
     if (!includeRowIndex) {
-      return std::make_unique<StripeStatisticsImpl>(
-          contents_->metadata->stripe_stats(static_cast<int>(stripeIndex)), statContext);
+      return std::make_unique<StripeStatisticsImpl>(stripeStats, statContext);
     }
 
-    size_t num_cols = static_cast<size_t>(
-        contents_->metadata->stripe_stats(static_cast<int>(stripeIndex)).col_stats_size());
+    size_t num_cols = static_cast<size_t>(stripeStats.col_stats_size());
     std::vector<std::vector<proto::ColumnStatistics>> indexStats(num_cols);
 
     getRowIndexStatistics(currentStripeInfo, stripeIndex, currentStripeFooter, &indexStats);
 
-    return std::make_unique<StripeStatisticsWithRowGroupIndexImpl>(
-        contents_->metadata->stripe_stats(static_cast<int>(stripeIndex)), indexStats, statContext);
+    return std::make_unique<StripeStatisticsWithRowGroupIndexImpl>(stripeStats, indexStats,
+                                                                   statContext);
   }
 
   std::unique_ptr<Statistics> ReaderImpl::getStatistics() const {
@@ -918,10 +1178,24 @@ namespace orc {
           contents_->compression,
           std::make_unique<SeekableFileInputStream>(contents_->stream.get(), metadataStart,
                                                     metadataSize, *contents_->pool),
-          contents_->blockSize, *contents_->pool, contents_->readerMetrics);
-      contents_->metadata.reset(new proto::Metadata());
-      if (!parseProtobufFromStream(contents_->metadata.get(), pbStream.get())) {
-        throw ParseError("Failed to parse the metadata");
+          contents_->blockSize, *contents_->pool, contents_->readerMetrics,
+          contents_->decompressorPool);
+      // only the stripes are found now, see LazyMetadata
+      std::string serialized;
+      const void* chunk;
+      int chunkSize;
+      while (pbStream->Next(&chunk, &chunkSize)) {
+        serialized.append(static_cast<const char*>(chunk), static_cast<size_t>(chunkSize));
+      }
+      contents_->metadata = std::make_shared<LazyMetadata>(std::move(serialized));
+
+      std::shared_ptr<FileTailCache> tailCache = options_.getFileTailCache();
+      if (tailCache && options_.getSerializedFileTail().empty()) {
+        auto entry = std::make_shared<FileTailCacheEntry>(contents_->postscript, contents_->footer,
+                                                          postscriptLength_, contents_->metadata);
+        tailCache->put(getFileTailCacheKey(contents_->stream->getName(), fileLength_,
+                                           options_.getFileTailCacheToken()),
+                       std::move(entry));
       }
     }
     isMetadataLoaded_ = true;
@@ -953,6 +1227,15 @@ namespace orc {
     return std::make_unique<RowReaderImpl>(contents_, opts);
   }
 
+  std::unique_ptr<ParallelScan> ReaderImpl::createParallelScan(const RowReaderOptions& opts,
+                                                               uint32_t numThreads) const {
+    if (opts.getSearchArgument() && !isMetadataLoaded_) {
+      // load stripe statistics for PPD
+      readMetadata();
+    }
+    return orc::createParallelScan(contents_, opts, numThreads);
+  }
+
   uint64_t maxStreamsForType(const proto::Type& type) {
     switch (static_cast<int64_t>(type.kind())) {
       case proto::Type_Kind_STRUCT:
@@ -1122,6 +1405,27 @@ namespace orc {
     return memory + decompressorMemory;
   }
 
+  bool RowReaderImpl::mayMatchFileStatistics() {
+    return !sargsApplier_ ||
+           sargsApplier_->evaluateFileStatistics(*footer_, numRowGroupsInStripeRange_);
+  }
+
+  void RowReaderImpl::seekToStripe(uint64_t stripe) {
+    reader_.reset();
+    checkFileStatistics_ = false;
+    firstStripe_ = stripe;
+    currentStripe_ = stripe;
+    lastStripe_ = stripe + 1;
+    processingStripe_ = lastStripe_;
+    currentRowInStripe_ = 0;
+    rowsInCurrentStripe_ = 0;
+    previousRow_ = stripe == 0 ? (std::numeric_limits<uint64_t>::max)()
+                               : firstRowOfStripe_[stripe] - 1;
+    // the prefetch window only covers the stripe now
+    prefetchedStripes_.clear();
+    prefetchedFooters_.clear();
+  }
+
   // Update fields to indicate we've reached the end of file
   void RowReaderImpl::markEndOfFile() {
     currentStripe_ = lastStripe_;
@@ -1237,8 +1541,7 @@ namespace orc {
     sharedDictionaries_.clear();  // Clear dictionaries from previous stripe
 
     // evaluate file statistics if it exists
-    if (sargsApplier_ &&
-        !sargsApplier_->evaluateFileStatistics(*footer_, numRowGroupsInStripeRange_)) {
+    if (checkFileStatistics_ && !mayMatchFileStatistics()) {
       // skip the entire file
       markEndOfFile();
       return;
@@ -1271,14 +1574,13 @@ namespace orc {
 
       bool isStripeNeeded = true;
       // If PPD enabled and stripe stats existed, evaulate it first
-      if (sargsApplier_ && contents_->metadata) {
-        const auto& currentStripeStats =
-            contents_->metadata->stripe_stats(static_cast<int>(currentStripe_));
+      if (sargsApplier_ && contents_->metadata &&
+          currentStripe_ < contents_->metadata->getNumberOfStripes()) {
         // skip this stripe after stats fail to satisfy sargs
         uint64_t stripeRowGroupCount =
             (rowsInCurrentStripe_ + footer_->row_index_stride() - 1) / footer_->row_index_stride();
-        isStripeNeeded =
-            sargsApplier_->evaluateStripeStatistics(currentStripeStats, stripeRowGroupCount);
+        isStripeNeeded = sargsApplier_->evaluateStripeStatistics(
+            *contents_->metadata, currentStripe_, stripeRowGroupCount);
       }
 
       if (isStripeNeeded) {
@@ -1314,7 +1616,9 @@ namespace orc {
 
     if (currentStripe_ < lastStripe_) {
       if (enableAsyncPrefetch_) {
-        contents_->evictCache(currentStripeInfo_.offset());
+        if (evictCache_) {
+          contents_->evictCache(currentStripeInfo_.offset());
+        }
 
         auto extractSmallStripeRanges = [this](uint64_t startStripe) {
           std::vector<ReadRange> ranges;
@@ -1330,7 +1634,9 @@ namespace orc {
           return ranges;
         };
 
-        if (fullyCachedStripes_.find(currentStripe_) != fullyCachedStripes_.cend()) {
+        if (prefetchWindowSize_ > 0) {
+          prefetchStripeWindow();
+        } else if (fullyCachedStripes_.find(currentStripe_) != fullyCachedStripes_.cend()) {
           // Current stripe has been fully cached, only prefetch next (small) stripe if not cached
           auto nextStripe = currentStripe_ + 1;
           if (nextStripe < lastStripe_ &&
@@ -1344,11 +1650,7 @@ namespace orc {
                    isSmallStripe(currentStripeInfo_, contents_->cacheOptions.rangeSizeLimit)) {
           contents_->cacheRanges(extractSmallStripeRanges(currentStripe_));
         } else {
-          // This is very coarse since I/O ranges of all selected columns are about to prefetch.
-          // We can further evaluate index stream with knowledge of pruned row groups to issue
-          // less I/O ranges.
-          contents_->cacheRanges(extractReadRangesForStripe(
-              currentStripe_, currentStripeInfo_, currentStripeFooter_, selectedColumns_));
+          contents_->cacheRanges(getCurrentStripeReadRanges());
           // Cache footer of next stripe to avoid blocking I/O.
           if (currentStripe_ + 1 < lastStripe_) {
             const auto& nextStripe = footer_->stripes(static_cast<int>(currentStripe_ + 1));
@@ -1386,56 +1688,286 @@ namespace orc {
     }
   }
 
-  bool RowReaderImpl::next(ColumnVectorBatch& data) {
-    SCOPED_STOPWATCH(contents_->readerMetrics, ReaderInclusiveLatencyUs, ReaderCall);
-    if (currentStripe_ >= lastStripe_) {
-      data.numElements = 0;
-      markEndOfFile();
-      return false;
+  std::vector<ReadRange> RowReaderImpl::getCurrentStripeReadRanges() const {
+    if (sargsApplier_ && sargsApplier_->hasSkipped()) {
+      // only fetch the parts of the streams that belong to selected row groups
+      const auto& nextSkippedRows = sargsApplier_->getNextSkippedRows();
+      std::vector<bool> selectedRowGroups(nextSkippedRows.size(), false);
+      uint64_t firstRowGroup = currentRowInStripe_ / footer_->row_index_stride();
+      for (size_t rg = firstRowGroup; rg < nextSkippedRows.size(); ++rg) {
+        selectedRowGroups[rg] = nextSkippedRows[rg] != 0;
+      }
+      return extractReadRangesForRowGroups(currentStripe_, currentStripeInfo_,
+                                           currentStripeFooter_, selectedColumns_,
+                                           *contents_->schema, rowIndexes_, selectedRowGroups,
+                                           contents_->compression != CompressionKind_NONE,
+                                           contents_->blockSize);
     }
-    if (currentRowInStripe_ == 0) {
-      startNextStripe();
+    return extractReadRangesForStripe(currentStripe_, currentStripeInfo_, currentStripeFooter_,
+                                      selectedColumns_);
+  }
+
+  void RowReaderImpl::prefetchStripeWindow() {
+    auto sumLength = [](const std::vector<ReadRange>& ranges) {
+      uint64_t length = 0;
+      for (const auto& range : ranges) {
+        length += range.length;
+      }
+      return length;
+    };
+    auto isStripeSkipped = [this](uint64_t stripe) {
+      return sargsApplier_ && contents_->metadata &&
+             stripe < contents_->metadata->getNumberOfStripes() &&
+             !sargsApplier_->mayMatchStripe(*contents_->metadata, stripe);
+    };
+    auto cacheFooter = [this](uint64_t stripe) {
+      if (prefetchedFooters_.insert(stripe).second) {
+        const auto& info = footer_->stripes(static_cast<int>(stripe));
+        contents_->cacheRanges(std::vector<ReadRange>{ReadRange{
+            info.offset() + info.index_length() + info.data_length(), info.footer_length()}});
+      }
+    };
+
+    // forget the stripes the reader has moved past; their buffers are evicted
+    prefetchedStripes_.erase(prefetchedStripes_.begin(),
+                             prefetchedStripes_.lower_bound(currentStripe_));
+    prefetchedFooters_.erase(prefetchedFooters_.begin(),
+                             prefetchedFooters_.upper_bound(currentStripe_));
+
+    if (prefetchedStripes_.find(currentStripe_) == prefetchedStripes_.end()) {
+      std::vector<ReadRange> ranges = getCurrentStripeReadRanges();
+      prefetchedStripes_[currentStripe_] = sumLength(ranges);
+      contents_->cacheRanges(std::move(ranges));
     }
-    uint64_t rowsToRead =
-        std::min(static_cast<uint64_t>(data.capacity), rowsInCurrentStripe_ - currentRowInStripe_);
-    if (sargsApplier_ && rowsToRead > 0) {
-      rowsToRead =
-          computeBatchSize(rowsToRead, currentRowInStripe_, rowsInCurrentStripe_,
-                           footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+
+    uint64_t windowLength = 0;
+    for (const auto& stripe : prefetchedStripes_) {
+      windowLength += stripe.second;
     }
-    data.numElements = rowsToRead;
-    if (rowsToRead == 0) {
-      markEndOfFile();
-      return false;
+
+    // Request the footers the window is likely to need at once, estimating the
+    // selected bytes of a stripe by its data length, so that they are not
+    // fetched one after another below.
+    uint64_t estimatedLength = windowLength;
+    for (uint64_t stripe = currentStripe_ + 1;
+         stripe < lastStripe_ && estimatedLength < prefetchWindowSize_; ++stripe) {
+      if (prefetchedStripes_.find(stripe) == prefetchedStripes_.end() &&
+          !isStripeSkipped(stripe)) {
+        cacheFooter(stripe);
+        estimatedLength += footer_->stripes(static_cast<int>(stripe)).data_length();
+      }
     }
-    if (enableEncodedBlock_) {
-      reader_->nextEncoded(data, rowsToRead, nullptr);
-    } else {
-      reader_->next(data, rowsToRead, nullptr);
-    }
-    // update row number
-    previousRow_ = firstRowOfStripe_[currentStripe_] + currentRowInStripe_;
-    currentRowInStripe_ += rowsToRead;
-
-    // check if we need to advance to next selected row group
-    if (sargsApplier_) {
-      uint64_t nextRowToRead =
-          advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
-                                footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
-      if (currentRowInStripe_ != nextRowToRead) {
-        // it is guaranteed to be at start of a row group
-        currentRowInStripe_ = nextRowToRead;
-        if (currentRowInStripe_ < rowsInCurrentStripe_) {
-          seekToRowGroup(static_cast<uint32_t>(currentRowInStripe_ / footer_->row_index_stride()));
+
+    uint64_t stripe = currentStripe_ + 1;
+    for (; stripe < lastStripe_ && windowLength < prefetchWindowSize_; ++stripe) {
+      if (prefetchedStripes_.find(stripe) != prefetchedStripes_.end() ||
+          isStripeSkipped(stripe)) {
+        continue;
+      }
+      cacheFooter(stripe);
+      const auto& info = footer_->stripes(static_cast<int>(stripe));
+      proto::StripeFooter stripeFooter = getStripeFooter(info, *contents_);
+      std::vector<ReadRange> ranges =
+          extractReadRangesForStripe(stripe, info, stripeFooter, selectedColumns_);
+      uint64_t length = sumLength(ranges);
+      prefetchedStripes_[stripe] = length;
+      windowLength += length;
+      contents_->cacheRanges(std::move(ranges));
+    }
+
+    // Cache footer of the first stripe beyond the window to avoid blocking I/O
+    // when the window moves forward.
+    while (stripe < lastStripe_ && (prefetchedStripes_.find(stripe) != prefetchedStripes_.end() ||
+                                    isStripeSkipped(stripe))) {
+      ++stripe;
+    }
+    if (stripe < lastStripe_) {
+      cacheFooter(stripe);
+    }
+  }
+
+  bool RowReaderImpl::next(ColumnVectorBatch& data) {
+    SCOPED_STOPWATCH(contents_->readerMetrics, ReaderInclusiveLatencyUs, ReaderCall);
+    uint64_t rowsSelected = 0;
+    // keep reading while the row filter drops every row of a batch
+    while (rowsSelected == 0) {
+      if (currentStripe_ >= lastStripe_) {
+        data.numElements = 0;
+        markEndOfFile();
+        return false;
+      }
+      if (currentRowInStripe_ == 0) {
+        startNextStripe();
+      }
+      uint64_t rowsToRead = std::min(static_cast<uint64_t>(data.capacity),
+                                     rowsInCurrentStripe_ - currentRowInStripe_);
+      if (sargsApplier_ && rowsToRead > 0) {
+        rowsToRead =
+            computeBatchSize(rowsToRead, currentRowInStripe_, rowsInCurrentStripe_,
+                             footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+      }
+      data.numElements = rowsToRead;
+      if (rowsToRead == 0) {
+        markEndOfFile();
+        return false;
+      }
+      if (rowFilter_) {
+        rowsSelected = nextFiltered(data, rowsToRead);
+      } else {
+        if (enableEncodedBlock_) {
+          reader_->nextEncoded(data, rowsToRead, nullptr);
+        } else {
+          reader_->next(data, rowsToRead, nullptr);
         }
+        rowsSelected = rowsToRead;
+      }
+      // update row number
+      previousRow_ = firstRowOfStripe_[currentStripe_] + currentRowInStripe_;
+      currentRowInStripe_ += rowsToRead;
+
+      // check if we need to advance to next selected row group
+      if (sargsApplier_) {
+        uint64_t nextRowToRead =
+            advanceToNextRowGroup(currentRowInStripe_, rowsInCurrentStripe_,
+                                  footer_->row_index_stride(), sargsApplier_->getNextSkippedRows());
+        if (currentRowInStripe_ != nextRowToRead) {
+          // it is guaranteed to be at start of a row group
+          currentRowInStripe_ = nextRowToRead;
+          if (currentRowInStripe_ < rowsInCurrentStripe_) {
+            seekToRowGroup(
+                static_cast<uint32_t>(currentRowInStripe_ / footer_->row_index_stride()));
+          }
+        }
+      }
+
+      if (currentRowInStripe_ >= rowsInCurrentStripe_) {
+        currentStripe_ += 1;
+        currentRowInStripe_ = 0;
       }
     }
+    return true;
+  }
 
-    if (currentRowInStripe_ >= rowsInCurrentStripe_) {
-      currentStripe_ += 1;
-      currentRowInStripe_ = 0;
+  uint64_t RowReaderImpl::nextFiltered(ColumnVectorBatch& data, uint64_t numRows) {
+    for (auto& arena : stringArenas_) {
+      arena->clear();
     }
-    return rowsToRead != 0;
+    auto* structReader = dynamic_cast<StructColumnReader*>(reader_.get());
+    auto* structBatch = dynamic_cast<StructVectorBatch*>(&data);
+    auto readField = [this, structReader, structBatch](size_t field, uint64_t numValues,
+                                                        char* notNull) {
+      ColumnVectorBatch& fieldBatch = *structBatch->fields[field];
+      if (enableEncodedBlock_) {
+        structReader->getField(field).nextEncoded(fieldBatch, numValues, notNull);
+      } else {
+        structReader->getField(field).next(fieldBatch, numValues, notNull);
+      }
+    };
+    // run fn for the fields that are read by the filter or for the others
+    auto forEachField = [this](bool filterFields, const std::function<void(size_t)>& fn) {
+      if (decodePool_) {
+        decodePool_->run(filterFields_.size(), [this, filterFields, &fn](size_t field) {
+          if (filterFields_[field] == filterFields) {
+            fn(field);
+          }
+        });
+      } else {
+        for (size_t field = 0; field < filterFields_.size(); ++field) {
+          if (filterFields_[field] == filterFields) {
+            fn(field);
+          }
+        }
+      }
+    };
+
+    bool readAll = structReader == nullptr || structBatch == nullptr;
+    if (readAll) {
+      if (enableEncodedBlock_) {
+        reader_->nextEncoded(data, numRows, nullptr);
+      } else {
+        reader_->next(data, numRows, nullptr);
+      }
+    } else {
+      structReader->nextStruct(data, numRows);
+      char* notNull = data.hasNulls ? data.notNull.data() : nullptr;
+      forEachField(true, [&readField, numRows, notNull](size_t field) {
+        readField(field, numRows, notNull);
+      });
+    }
+
+    selectedRows_.assign(numRows, 1);
+    rowFilter_(data, selectedRows_.data());
+    uint64_t numSelected = getSelectedRuns(selectedRows_.data(), numRows, selectedRuns_);
+
+    if (!readAll && data.hasNulls) {
+      // fields have no values for null structs, so the runs of the batch
+      // don't map to runs of the fields
+      char* notNull = data.notNull.data();
+      forEachField(false, [&readField, numRows, notNull](size_t field) {
+        readField(field, numRows, notNull);
+      });
+      readAll = true;
+    }
+    if (readAll || numSelected == numRows) {
+      if (numSelected == numRows) {
+        if (!readAll) {
+          forEachField(false, [&readField, numRows](size_t field) {
+            readField(field, numRows, nullptr);
+          });
+        }
+        return numSelected;
+      }
+      uint64_t rowsCopied = 0;
+      for (const auto& run : selectedRuns_) {
+        copyRows(data, run.offset, data, rowsCopied, run.length, *stringArenas_[0]);
+        rowsCopied += run.length;
+      }
+      data.numElements = numSelected;
+      return numSelected;
+    }
+
+    if (numSelected > 0 && (runBatch_ == nullptr || runBatch_->capacity < numRows)) {
+      runBatch_ = createRowBatch(numRows);
+    }
+    auto* runFields = dynamic_cast<StructVectorBatch*>(runBatch_.get());
+    forEachField(false, [this, structReader, structBatch, runFields, numRows](size_t field) {
+      ColumnReader& reader = structReader->getField(field);
+      ColumnVectorBatch& fieldBatch = *structBatch->fields[field];
+      uint64_t row = 0;
+      uint64_t rowsCopied = 0;
+      for (const auto& run : selectedRuns_) {
+        if (run.offset > row) {
+          reader.skip(run.offset - row);
+        }
+        ColumnVectorBatch& runBatch = *runFields->fields[field];
+        if (enableEncodedBlock_) {
+          reader.nextEncoded(runBatch, run.length, nullptr);
+        } else {
+          reader.next(runBatch, run.length, nullptr);
+        }
+        copyRows(runBatch, 0, fieldBatch, rowsCopied, run.length, *stringArenas_[field]);
+        rowsCopied += run.length;
+        row = run.offset + run.length;
+      }
+      if (numRows > row) {
+        reader.skip(numRows - row);
+      }
+      fieldBatch.numElements = rowsCopied;
+    });
+
+    // compact the fields read by the filter
+    forEachField(true, [this, structBatch](size_t field) {
+      ColumnVectorBatch& fieldBatch = *structBatch->fields[field];
+      uint64_t rowsCopied = 0;
+      for (const auto& run : selectedRuns_) {
+        copyRows(fieldBatch, run.offset, fieldBatch, rowsCopied, run.length,
+                 *stringArenas_[field]);
+        rowsCopied += run.length;
+      }
+      fieldBatch.numElements = rowsCopied;
+    });
+    data.numElements = numSelected;
+    return numSelected;
   }
 
   uint64_t RowReaderImpl::computeBatchSize(uint64_t requestedSize, uint64_t currentRowInStripe,
@@ -1635,6 +2167,10 @@ namespace orc {
     contents->errorStream = options.getErrorStream();
     contents->readerMetrics = options.getReaderMetrics();
     contents->cacheOptions = options.getCacheOptions();
+    if (options.getIndexCacheMemory() > 0) {
+      contents->indexCache =
+          std::make_unique<IndexCache>(options.getIndexCacheMemory(), contents->readerMetrics);
+    }
     std::string serializedFooter = options.getSerializedFileTail();
     uint64_t fileLength;
     uint64_t postscriptLength;
@@ -1652,39 +2188,69 @@ namespace orc {
       // figure out the size of the file using the option or filesystem
       fileLength = std::min(options.getTailLocation(), static_cast<uint64_t>(stream->getLength()));
 
-      // read last bytes into buffer to get PostScript
-      uint64_t readSize = std::min(fileLength, DIRECTORY_SIZE_GUESS);
-      if (readSize < 4) {
-        throw ParseError("File size too small");
+      std::shared_ptr<FileTailCache> tailCache = options.getFileTailCache();
+      std::string tailCacheKey;
+      std::shared_ptr<const FileTailCacheEntry> cachedTail;
+      if (tailCache) {
+        tailCacheKey =
+            getFileTailCacheKey(stream->getName(), fileLength, options.getFileTailCacheToken());
+        cachedTail =
+            std::dynamic_pointer_cast<const FileTailCacheEntry>(tailCache->get(tailCacheKey));
+        if (contents->readerMetrics) {
+          if (cachedTail) {
+            contents->readerMetrics->FileTailCacheHits.fetch_add(1);
+          } else {
+            contents->readerMetrics->FileTailCacheMisses.fetch_add(1);
+          }
+        }
       }
-      auto buffer = std::make_unique<DataBuffer<char>>(*contents->pool, readSize);
-      stream->read(buffer->data(), readSize, fileLength - readSize);
 
-      postscriptLength = buffer->data()[readSize - 1] & 0xff;
-      contents->postscript = readPostscript(stream.get(), buffer.get(), postscriptLength);
-      uint64_t footerSize = contents->postscript->footer_length();
+      if (cachedTail) {
+        contents->postscript = cachedTail->postscript;
+        contents->footer = cachedTail->footer;
+        contents->metadata = cachedTail->metadata;
+        postscriptLength = cachedTail->postscriptLength;
+      } else {
+        // read last bytes into buffer to get PostScript
+        uint64_t readSize = std::min(fileLength, DIRECTORY_SIZE_GUESS);
+        if (readSize < 4) {
+          throw ParseError("File size too small");
+        }
+        auto buffer = std::make_unique<DataBuffer<char>>(*contents->pool, readSize);
+        stream->read(buffer->data(), readSize, fileLength - readSize);
+
+        postscriptLength = buffer->data()[readSize - 1] & 0xff;
+        contents->postscript = readPostscript(stream.get(), buffer.get(), postscriptLength);
+        uint64_t footerSize = contents->postscript->footer_length();
 
-      // Check for overflow before calculating tailSize
-      uint64_t tailSize;
-      if (addOverflow(1ULL, postscriptLength, &tailSize) ||
-          addOverflow(tailSize, footerSize, &tailSize) || tailSize >= fileLength) {
-        std::stringstream msg;
-        msg << "Invalid tail size: footerSize=" << footerSize
-            << ", postscriptLength=" << postscriptLength << ", fileLength=" << fileLength;
-        throw ParseError(msg.str());
-      }
-      uint64_t footerOffset;
+        // Check for overflow before calculating tailSize
+        uint64_t tailSize;
+        if (addOverflow(1ULL, postscriptLength, &tailSize) ||
+            addOverflow(tailSize, footerSize, &tailSize) || tailSize >= fileLength) {
+          std::stringstream msg;
+          msg << "Invalid tail size: footerSize=" << footerSize
+              << ", postscriptLength=" << postscriptLength << ", fileLength=" << fileLength;
+          throw ParseError(msg.str());
+        }
+        uint64_t footerOffset;
 
-      if (tailSize > readSize) {
-        buffer->resize(footerSize);
-        stream->read(buffer->data(), footerSize, fileLength - tailSize);
-        footerOffset = 0;
-      } else {
-        footerOffset = readSize - tailSize;
-      }
+        if (tailSize > readSize) {
+          buffer->resize(footerSize);
+          stream->read(buffer->data(), footerSize, fileLength - tailSize);
+          footerOffset = 0;
+        } else {
+          footerOffset = readSize - tailSize;
+        }
 
-      contents->footer = readFooter(stream.get(), buffer.get(), footerOffset, *contents->postscript,
-                                    *contents->pool, contents->readerMetrics);
+        contents->footer = readFooter(stream.get(), buffer.get(), footerOffset,
+                                      *contents->postscript, *contents->pool,
+                                      contents->readerMetrics);
+        if (tailCache) {
+          auto entry = std::make_shared<FileTailCacheEntry>(contents->postscript, contents->footer,
+                                                            postscriptLength, nullptr);
+          tailCache->put(tailCacheKey, std::move(entry));
+        }
+      }
     }
     contents->isDecimalAsLong = false;
     if (contents->postscript->version_size() == 2) {
@@ -1700,6 +2266,7 @@ namespace orc {
   std::map<uint32_t, BloomFilterIndex> ReaderImpl::getBloomFilters(
       uint32_t stripeIndex, const std::set<uint32_t>& included) const {
     std::map<uint32_t, BloomFilterIndex> ret;
+    IndexCache* indexCache = contents_->indexCache.get();
 
     uint64_t offset;
     auto currentStripeFooter = loadCurrentStripeFooter(stripeIndex, offset);
@@ -1713,11 +2280,20 @@ namespace orc {
       // a bloom filter stream from a selected column is found
       if (stream.kind() == proto::Stream_Kind_BLOOM_FILTER_UTF8 &&
           (included.empty() || included.find(column) != included.end())) {
+        std::shared_ptr<const BloomFilterIndex> cached =
+            indexCache ? indexCache->getBloomFilters(stripeIndex, column) : nullptr;
+        if (cached) {
+          ret[column] = *cached;
+          offset += length;
+          continue;
+        }
+
         std::unique_ptr<SeekableInputStream> pbStream =
             createDecompressor(contents_->compression,
                                std::make_unique<SeekableFileInputStream>(
                                    contents_->stream.get(), offset, length, *contents_->pool),
-                               contents_->blockSize, *(contents_->pool), contents_->readerMetrics);
+                               contents_->blockSize, *(contents_->pool), contents_->readerMetrics,
+                               contents_->decompressorPool);
 
         proto::BloomFilterIndex pbBFIndex;
         if (!parseProtobufFromStream(&pbBFIndex, pbStream.get())) {
@@ -1731,9 +2307,14 @@ namespace orc {
               pbBFIndex.bloom_filter(j));
           bfIndex.entries.push_back(std::shared_ptr<BloomFilter>(std::move(entry)));
         }
+        if (indexCache) {
+          indexCache->putBloomFilters(stripeIndex, column,
+                                      std::make_shared<BloomFilterIndex>(bfIndex),
+                                      static_cast<uint64_t>(pbBFIndex.SpaceUsedLong()));
+        }
 
         // add bloom filters to result for one column
-        ret[column] = bfIndex;
+        ret[column] = std::move(bfIndex);
       }
 
       offset += length;
@@ -1758,6 +2339,7 @@ namespace orc {
   std::map<uint32_t, RowGroupIndex> ReaderImpl::getRowGroupIndex(
       uint32_t stripeIndex, const std::set<uint32_t>& included) const {
     std::map<uint32_t, RowGroupIndex> ret;
+    IndexCache* indexCache = contents_->indexCache.get();
     uint64_t offset;
     auto currentStripeFooter = loadCurrentStripeFooter(stripeIndex, offset);
 
@@ -1770,22 +2352,31 @@ namespace orc {
 
       if (stream.kind() == proto::Stream_Kind_ROW_INDEX &&
           (included.empty() || included.find(column) != included.end())) {
-        std::unique_ptr<SeekableInputStream> pbStream =
-            createDecompressor(contents_->compression,
-                               std::make_unique<SeekableFileInputStream>(
-                                   contents_->stream.get(), offset, length, *contents_->pool),
-                               contents_->blockSize, *(contents_->pool), contents_->readerMetrics);
-
-        proto::RowIndex pbRowIndex;
-        if (!parseProtobufFromStream(&pbRowIndex, pbStream.get())) {
-          std::stringstream errMsgBuffer;
-          errMsgBuffer << "Failed to parse RowIndex at column " << column << " in stripe "
-                       << stripeIndex;
-          throw ParseError(errMsgBuffer.str());
+        std::shared_ptr<const proto::RowIndex> pbRowIndex =
+            indexCache ? indexCache->getRowIndex(stripeIndex, column) : nullptr;
+        if (!pbRowIndex) {
+          std::unique_ptr<SeekableInputStream> pbStream = createDecompressor(
+              contents_->compression,
+              std::make_unique<SeekableFileInputStream>(contents_->stream.get(), offset, length,
+                                                        *contents_->pool),
+              contents_->blockSize, *(contents_->pool), contents_->readerMetrics,
+              contents_->decompressorPool);
+
+          auto rowIndex = std::make_shared<proto::RowIndex>();
+          if (!parseProtobufFromStream(rowIndex.get(), pbStream.get())) {
+            std::stringstream errMsgBuffer;
+            errMsgBuffer << "Failed to parse RowIndex at column " << column << " in stripe "
+                         << stripeIndex;
+            throw ParseError(errMsgBuffer.str());
+          }
+          if (indexCache) {
+            indexCache->putRowIndex(stripeIndex, column, rowIndex);
+          }
+          pbRowIndex = std::move(rowIndex);
         }
 
         // add rowGroupIndex to result for one column
-        for (auto& rowIndexEntry : pbRowIndex.entry()) {
+        for (auto& rowIndexEntry : pbRowIndex->entry()) {
           std::vector<uint64_t> posVector;
           for (auto& position : rowIndexEntry.positions()) {
             posVector.push_back(position);
@@ -1857,6 +2448,10 @@ namespace orc {
     // PASS
   }
 
+  ParallelScan::~ParallelScan() {
+    // PASS
+  }
+
   Reader::~Reader() {
     // PASS
   }
@@ -1865,19 +2460,55 @@ namespace orc {
     // PASS
   }
 
+  std::future<void> InputStream::readAsync(void* buf, uint64_t length, uint64_t offset,
+                                           ReaderMetrics* metrics) {
+    return getDefaultIOExecutor()->submit(
+        this,
+        [this, buf, length, offset, metrics] {
+          SCOPED_STOPWATCH(metrics, IOBlockingLatencyUs, IOCount);
+          this->read(buf, length, offset);
+        },
+        metrics);
+  }
+
+  const char* InputStream::getMappedData() const {
+    return nullptr;
+  }
+
+  void InputStream::adviseWillNeed(uint64_t, uint64_t) {
+    // PASS
+  }
+
   void FileContents::cacheRanges(std::vector<ReadRange> ranges) {
-    std::lock_guard<std::mutex> lock(readCacheMutex);
-    if (!readCache) {
-      readCache = std::make_shared<ReadRangeCache>(stream.get(), cacheOptions, pool, readerMetrics);
+    if (stream->getMappedData() != nullptr) {
+      // mapped data is read in place, so there is nothing to copy ahead
+      for (const auto& range : ranges) {
+        stream->adviseWillNeed(range.offset, range.length);
+      }
+      return;
     }
-    readCache->cache(std::move(ranges));
+    std::shared_ptr<ReadRangeCache> cache;
+    {
+      std::lock_guard<std::mutex> lock(readCacheMutex);
+      if (!readCache) {
+        readCache =
+            std::make_shared<ReadRangeCache>(stream.get(), cacheOptions, pool, readerMetrics);
+      }
+      cache = readCache;
+    }
+    // issuing the reads may block on a full I/O queue
+    cache->cache(std::move(ranges));
   }
 
   void FileContents::evictCache(uint64_t boundary) {
-    std::lock_guard<std::mutex> lock(readCacheMutex);
-    if (readCache) {
-      readCache->evictEntriesBefore(boundary);
+    if (std::shared_ptr<ReadRangeCache> cache = getReadCache()) {
+      cache->evictEntriesBefore(boundary);
     }
   }
 
+  std::shared_ptr<ReadRangeCache> FileContents::getReadCache() const {
+    std::lock_guard<std::mutex> lock(readCacheMutex);
+    return readCache;
+  }
+
 }  // namespace orc
@@ -24,11 +24,18 @@
 #include "orc/OrcFile.hh"
 #include "orc/Reader.hh"
 
+#include "ColumnDecodePool.hh"
 #include "ColumnReader.hh"
+#include "Compression.hh"
+#include "IndexCache.hh"
+#include "LazyMetadata.hh"
+#include "RowSelection.hh"
 #include "SchemaEvolution.hh"
 #include "io/Cache.hh"
 #include "sargs/SargsApplier.hh"
 
+#include <map>
+#include <set>
 #include <unordered_set>
 
 namespace orc {
@@ -59,8 +66,9 @@ namespace orc {
    */
   struct FileContents {
     std::unique_ptr<InputStream> stream;
-    std::unique_ptr<proto::PostScript> postscript;
-    std::unique_ptr<proto::Footer> footer;
+    // the parsed tail may be shared with other readers through a FileTailCache
+    std::shared_ptr<const proto::PostScript> postscript;
+    std::shared_ptr<const proto::Footer> footer;
     std::unique_ptr<Type> schema;
     uint64_t blockSize;
     CompressionKind compression;
@@ -69,20 +77,28 @@ namespace orc {
     /// Decimal64 in ORCv2 uses RLE to store values. This flag indicates whether
     /// this new encoding is used.
     bool isDecimalAsLong;
-    std::unique_ptr<proto::Metadata> metadata;
+    // the stripe statistics, loaded when first needed
+    std::shared_ptr<const LazyMetadata> metadata;
     ReaderMetrics* readerMetrics;
 
     // cache options to advise io coalescing in the read cache.
     CacheOptions cacheOptions;
-    // mutex to protect readCache_ from concurrent access
-    std::mutex readCacheMutex;
+    // mutex to protect readCache from concurrent access; the cache locks its
+    // own entries, so the mutex is never held while reading
+    mutable std::mutex readCacheMutex;
     // cached io ranges. only valid when preBuffer is invoked.
     std::shared_ptr<ReadRangeCache> readCache;
+    // the parsed index streams of the stripes, if enabled
+    std::unique_ptr<IndexCache> indexCache;
+    // decompression contexts and buffers shared by the streams of the file
+    std::shared_ptr<DecompressorPool> decompressorPool;
 
     // A thread-safe convenience method to cache ranges.
     void cacheRanges(std::vector<ReadRange> ranges);
     // A thread-safe convenience method to evict cache entries fully before a given boundary.
     void evictCache(uint64_t boundary);
+    // A thread-safe way to get the read cache, null if nothing was cached.
+    std::shared_ptr<ReadRangeCache> getReadCache() const;
   };
 
   proto::StripeFooter getStripeFooter(const proto::StripeInformation& info,
@@ -148,12 +164,14 @@ namespace orc {
     const int32_t forcedScaleOnHive11Decimal_;
     const bool enableAsyncPrefetch_;
     const uint64_t smallStripeLookAheadLimit_;
+    const uint64_t prefetchWindowSize_;
+    const bool evictCache_;
 
     // inputs
     std::vector<bool> selectedColumns_;
 
     // footer
-    proto::Footer* footer_;
+    const proto::Footer* footer_;
     DataBuffer<uint64_t> firstRowOfStripe_;
     mutable std::unique_ptr<Type> selectedSchema_;
     bool skipBloomFilters_;
@@ -168,21 +186,43 @@ namespace orc {
     uint64_t rowsInCurrentStripe_;
     // number of row groups between first stripe and last stripe
     uint64_t numRowGroupsInStripeRange_;
+    // false once the caller has checked the file statistics, see seekToStripe()
+    bool checkFileStatistics_;
     proto::StripeInformation currentStripeInfo_;
     proto::StripeFooter currentStripeFooter_;
     std::unique_ptr<ColumnReader> reader_;
+    // decodes the top-level columns concurrently if more than one thread is requested
+    std::unique_ptr<ColumnDecodePool> decodePool_;
+
+    // state of reading the fields selected by the row filter first
+    RowReaderOptions::RowFilter rowFilter_;
+    // whether each field of the batch is read by the row filter
+    std::vector<bool> filterFields_;
+    std::vector<char> selectedRows_;
+    std::vector<RowRun> selectedRuns_;
+    // receives the selected runs of the other fields before they are copied
+    std::unique_ptr<ColumnVectorBatch> runBatch_;
+    // one per field, so that fields can be filled concurrently
+    std::vector<std::unique_ptr<StringArena>> stringArenas_;
     // stripe indices that whose entire I/O ranges have been fully cached.
     std::unordered_set<uint64_t> fullyCachedStripes_;
+    // bytes requested for each stripe within the prefetch window
+    std::map<uint64_t, uint64_t> prefetchedStripes_;
+    // stripes whose footer has been requested by the prefetch window
+    std::set<uint64_t> prefetchedFooters_;
 
     bool enableEncodedBlock_;
     bool useTightNumericVector_;
     bool throwOnSchemaEvolutionOverflow_;
     // internal methods
     void startNextStripe();
+    uint64_t nextFiltered(ColumnVectorBatch& data, uint64_t numRows);
+    std::vector<ReadRange> getCurrentStripeReadRanges() const;
+    void prefetchStripeWindow();
     inline void markEndOfFile();
 
     // row index of current stripe with column id as the key
-    std::unordered_map<uint64_t, proto::RowIndex> rowIndexes_;
+    std::unordered_map<uint64_t, std::shared_ptr<const proto::RowIndex>> rowIndexes_;
     std::map<uint32_t, BloomFilterIndex> bloomFilterIndex_;
     std::shared_ptr<SearchArgument> sargs_;
     std::unique_ptr<SargsApplier> sargsApplier_;
@@ -237,8 +277,12 @@ namespace orc {
      * Constructor that lets the user specify additional options.
      * @param contents of the file
      * @param options options for reading
+     * @param evictCache whether to evict cached ranges before the current
+     *        stripe; false when other readers share the read cache
      */
-    RowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& options);
+    RowReaderImpl(std::shared_ptr<FileContents> contents, const RowReaderOptions& options,
+                  bool evictCache = true);
+    ~RowReaderImpl() override;
 
     // Select the columns from the options object
     const std::vector<bool> getSelectedColumns() const override;
@@ -257,6 +301,19 @@ namespace orc {
 
     void seekToRow(uint64_t rowNumber) override;
 
+    /**
+     * Whether the file statistics may match the search argument. They are
+     * evaluated only once, however often this is called.
+     */
+    bool mayMatchFileStatistics();
+
+    /**
+     * Read only the given stripe from now on, so that the threads of a scan
+     * can each reuse one reader for the stripes they take. The caller checks
+     * the file statistics with mayMatchFileStatistics() instead.
+     */
+    void seekToStripe(uint64_t stripe);
+
     const FileContents& getFileContents() const;
     bool getThrowOnHive11DecimalOverflow() const;
     bool getIsDecimalAsLong() const;
@@ -266,8 +323,12 @@ namespace orc {
       return &schemaEvolution_;
     }
 
+    ColumnDecodePool* getColumnDecodePool() const {
+      return decodePool_.get();
+    }
+
     std::shared_ptr<ReadRangeCache> getReadCache() const {
-      return contents_->readCache;
+      return contents_->getReadCache();
     }
 
     // Method to set shared dictionaries from external functions
@@ -291,7 +352,7 @@ namespace orc {
     const uint64_t postscriptLength_;
 
     // footer
-    proto::Footer* footer_;
+    const proto::Footer* footer_;
     uint64_t numberOfStripes_;
 
     uint64_t getMemoryUse(int stripeIx, std::vector<bool>& selectedColumns);
@@ -359,6 +420,9 @@ namespace orc {
 
     std::unique_ptr<RowReader> createRowReader(const RowReaderOptions& options) const override;
 
+    std::unique_ptr<ParallelScan> createParallelScan(const RowReaderOptions& options,
+                                                     uint32_t numThreads) const override;
+
     uint64_t getContentLength() const override;
     uint64_t getStripeStatisticsLength() const override;
     uint64_t getFileFooterLength() const override;
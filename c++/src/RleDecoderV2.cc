@@ -18,6 +18,9 @@
 
 #include "Adaptor.hh"
 #include "BpackingDefault.hh"
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+#include "BpackingAvx2.hh"
+#endif
 #if defined(ORC_HAVE_RUNTIME_AVX512)
 #include "BpackingAvx512.hh"
 #endif
@@ -75,18 +78,21 @@ namespace orc {
     using FunctionType = decltype(&BitUnpack::readLongs);
 
     static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      std::vector<std::pair<DispatchLevel, FunctionType>> impls = {
+          {DispatchLevel::NONE, BitUnpackDefault::readLongs}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      impls.emplace_back(DispatchLevel::AVX2, BitUnpackAVX2::readLongs);
+#endif
 #if defined(ORC_HAVE_RUNTIME_AVX512)
-      return {{DispatchLevel::NONE, BitUnpackDefault::readLongs},
-              {DispatchLevel::AVX512, BitUnpackAVX512::readLongs}};
-#else
-      return {{DispatchLevel::NONE, BitUnpackDefault::readLongs}};
+      impls.emplace_back(DispatchLevel::AVX512, BitUnpackAVX512::readLongs);
 #endif
+      return impls;
     }
   };
 
   void RleDecoderV2::readLongs(int64_t* data, uint64_t offset, uint64_t len, uint64_t fbs) {
     static DynamicDispatch<UnpackDynamicFunction> dispatch;
-    return dispatch.func(this, data, offset, len, fbs);
+    return dispatch.get()(this, data, offset, len, fbs);
   }
 
   RleDecoderV2::RleDecoderV2(std::unique_ptr<SeekableInputStream> input, bool isSigned,
@@ -0,0 +1,69 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RleEncodeKernels.hh"
+#include "RLE.hh"
+#include "RLEV2Util.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace orc {
+
+  void RleEncodeDefault::zigZag(const int64_t* in, int64_t* out, size_t len) {
+    for (size_t i = 0; i < len; ++i) {
+      out[i] = orc::zigZag(in[i]);
+    }
+  }
+
+  void RleEncodeDefault::bitWidthHistogram(const int64_t* data, size_t len, int32_t* hist) {
+    for (size_t i = 0; i < len; ++i) {
+      hist[encodeBitWidth(findClosestNumBits(data[i]))] += 1;
+    }
+  }
+
+  void RleEncodeDefault::scanLiterals(const int64_t* literals, size_t len, int64_t* adjDeltas,
+                                      LiteralScan& scan) {
+    scan.min = literals[0];
+    scan.max = literals[0];
+    scan.deltaMax = 0;
+    scan.isIncreasing = true;
+    scan.isDecreasing = true;
+    scan.isFixedDelta = true;
+    const int64_t initialDelta = literals[1] - literals[0];
+
+    for (size_t i = 1; i < len; i++) {
+      const int64_t l1 = literals[i];
+      const int64_t l0 = literals[i - 1];
+      const int64_t currDelta = l1 - l0;
+      scan.min = std::min(scan.min, l1);
+      scan.max = std::max(scan.max, l1);
+
+      scan.isIncreasing &= (l0 <= l1);
+      scan.isDecreasing &= (l0 >= l1);
+
+      scan.isFixedDelta &= (currDelta == initialDelta);
+      if (i > 1) {
+        adjDeltas[i - 1] = std::abs(currDelta);
+        scan.deltaMax = std::max(scan.deltaMax, adjDeltas[i - 1]);
+      }
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,78 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_RLEENCODEKERNELS_HH
+#define ORC_RLEENCODEKERNELS_HH
+
+#include <cstddef>
+#include <cstdint>
+
+namespace orc {
+
+  // What determineEncoding() needs to know about a run of literals
+  struct LiteralScan {
+    int64_t min;
+    int64_t max;
+    // the largest absolute delta after the first one
+    int64_t deltaMax;
+    bool isIncreasing;
+    bool isDecreasing;
+    bool isFixedDelta;
+  };
+
+  /**
+   * The scans of the RLEv2 encoder over a run of literals. Every instruction
+   * set provides the kernels it speeds up; RleEncoderV2 dispatches each of
+   * them to the best one the CPU supports.
+   */
+  class RleEncodeDefault {
+   public:
+    // out[i] = zigZag(in[i])
+    static void zigZag(const int64_t* in, int64_t* out, size_t len);
+
+    // Count the encoded closest fixed bit width of every value into hist
+    static void bitWidthHistogram(const int64_t* data, size_t len, int32_t* hist);
+
+    /**
+     * Scan len >= 2 literals for their range, monotonicity and whether the
+     * deltas are fixed. The absolute delta between literals[i] and
+     * literals[i - 1] is stored to adjDeltas[i - 1] for every i >= 2.
+     */
+    static void scanLiterals(const int64_t* literals, size_t len, int64_t* adjDeltas,
+                             LiteralScan& scan);
+  };
+
+  class RleEncodeAVX2 {
+   public:
+    static void zigZag(const int64_t* in, int64_t* out, size_t len);
+    static void scanLiterals(const int64_t* literals, size_t len, int64_t* adjDeltas,
+                             LiteralScan& scan);
+  };
+
+  class RleEncodeAVX512 {
+   public:
+    static void zigZag(const int64_t* in, int64_t* out, size_t len);
+    static void bitWidthHistogram(const int64_t* data, size_t len, int32_t* hist);
+    static void scanLiterals(const int64_t* literals, size_t len, int64_t* adjDeltas,
+                             LiteralScan& scan);
+  };
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,127 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Dispatch.hh"
+#include "RLE.hh"
+#include "RleEncodeKernels.hh"
+
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+namespace orc {
+
+  namespace {
+    // AVX2 has no signed 64-bit min and max
+    ORC_TARGET_AVX2 inline __m256i min64(__m256i a, __m256i b) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(a, b));
+    }
+
+    ORC_TARGET_AVX2 inline __m256i max64(__m256i a, __m256i b) {
+      return _mm256_blendv_epi8(a, b, _mm256_cmpgt_epi64(b, a));
+    }
+
+    ORC_TARGET_AVX2 inline bool allZero(__m256i v) {
+      return _mm256_testz_si256(v, v) != 0;
+    }
+
+    ORC_TARGET_AVX2 void zigZagAvx2(const int64_t* in, int64_t* out, size_t len) {
+      const __m256i zero = _mm256_setzero_si256();
+      size_t i = 0;
+      for (; i + 4 <= len; i += 4) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i));
+        __m256i sign = _mm256_cmpgt_epi64(zero, value);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                            _mm256_xor_si256(_mm256_slli_epi64(value, 1), sign));
+      }
+      for (; i < len; ++i) {
+        out[i] = orc::zigZag(in[i]);
+      }
+    }
+
+    ORC_TARGET_AVX2 void scanLiteralsAvx2(const int64_t* literals, size_t len,
+                                          int64_t* adjDeltas, LiteralScan& scan) {
+      const int64_t initialDelta = literals[1] - literals[0];
+      const __m256i zero = _mm256_setzero_si256();
+      const __m256i initial = _mm256_set1_epi64x(initialDelta);
+      __m256i min = _mm256_set1_epi64x(std::min(literals[0], literals[1]));
+      __m256i max = _mm256_set1_epi64x(std::max(literals[0], literals[1]));
+      // lanes that saw a decrease, an increase or another delta
+      __m256i decreased = zero;
+      __m256i increased = zero;
+      __m256i changedDelta = zero;
+      __m256i deltaMax = zero;
+
+      size_t i = 2;
+      for (; i + 4 <= len; i += 4) {
+        const __m256i l1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(literals + i));
+        const __m256i l0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(literals + i - 1));
+        const __m256i delta = _mm256_sub_epi64(l1, l0);
+        min = min64(min, l1);
+        max = max64(max, l1);
+        decreased = _mm256_or_si256(decreased, _mm256_cmpgt_epi64(l0, l1));
+        increased = _mm256_or_si256(increased, _mm256_cmpgt_epi64(l1, l0));
+        changedDelta = _mm256_or_si256(changedDelta, _mm256_xor_si256(delta, initial));
+        const __m256i sign = _mm256_cmpgt_epi64(zero, delta);
+        const __m256i absDelta = _mm256_sub_epi64(_mm256_xor_si256(delta, sign), sign);
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(adjDeltas + i - 1), absDelta);
+        deltaMax = max64(deltaMax, absDelta);
+      }
+
+      int64_t lanes[3][4];
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[0]), min);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[1]), max);
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(lanes[2]), deltaMax);
+      scan.min = *std::min_element(lanes[0], lanes[0] + 4);
+      scan.max = *std::max_element(lanes[1], lanes[1] + 4);
+      scan.deltaMax = *std::max_element(lanes[2], lanes[2] + 4);
+      scan.isIncreasing = literals[0] <= literals[1] && allZero(decreased);
+      scan.isDecreasing = literals[0] >= literals[1] && allZero(increased);
+      scan.isFixedDelta = allZero(changedDelta);
+
+      for (; i < len; ++i) {
+        const int64_t l1 = literals[i];
+        const int64_t l0 = literals[i - 1];
+        const int64_t currDelta = l1 - l0;
+        scan.min = std::min(scan.min, l1);
+        scan.max = std::max(scan.max, l1);
+        scan.isIncreasing &= (l0 <= l1);
+        scan.isDecreasing &= (l0 >= l1);
+        scan.isFixedDelta &= (currDelta == initialDelta);
+        adjDeltas[i - 1] = std::abs(currDelta);
+        scan.deltaMax = std::max(scan.deltaMax, adjDeltas[i - 1]);
+      }
+    }
+  }  // namespace
+
+  void RleEncodeAVX2::zigZag(const int64_t* in, int64_t* out, size_t len) {
+    zigZagAvx2(in, out, len);
+  }
+
+  void RleEncodeAVX2::scanLiterals(const int64_t* literals, size_t len, int64_t* adjDeltas,
+                                   LiteralScan& scan) {
+    scanLiteralsAvx2(literals, len, adjDeltas, scan);
+  }
+
+}  // namespace orc
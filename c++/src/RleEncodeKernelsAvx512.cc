@@ -0,0 +1,123 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RLE.hh"
+#include "RLEV2Util.hh"
+#include "RleEncodeKernels.hh"
+
+#include <algorithm>
+#include <array>
+#include <cstdlib>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+namespace orc {
+
+  void RleEncodeAVX512::zigZag(const int64_t* in, int64_t* out, size_t len) {
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+      __m512i value = _mm512_loadu_si512(in + i);
+      __m512i sign = _mm512_srai_epi64(value, 63);
+      _mm512_storeu_si512(out + i, _mm512_xor_si512(_mm512_slli_epi64(value, 1), sign));
+    }
+    for (; i < len; ++i) {
+      out[i] = orc::zigZag(in[i]);
+    }
+  }
+
+  void RleEncodeAVX512::bitWidthHistogram(const int64_t* data, size_t len, int32_t* hist) {
+    // the histogram slot of every number of significant bits
+    static const std::array<uint8_t, 65> slots = [] {
+      std::array<uint8_t, 65> result{};
+      for (uint32_t bits = 0; bits <= 64; ++bits) {
+        result[bits] = static_cast<uint8_t>(encodeBitWidth(getClosestFixedBits(bits)));
+      }
+      return result;
+    }();
+
+    const __m512i bitSize = _mm512_set1_epi64(64);
+    uint8_t numBits[8];
+    size_t i = 0;
+    for (; i + 8 <= len; i += 8) {
+      // negative values have no leading zero, hence need all 64 bits
+      __m512i value = _mm512_loadu_si512(data + i);
+      __m512i bits = _mm512_sub_epi64(bitSize, _mm512_lzcnt_epi64(value));
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(numBits), _mm512_cvtepi64_epi8(bits));
+      for (uint8_t n : numBits) {
+        hist[slots[n]] += 1;
+      }
+    }
+    for (; i < len; ++i) {
+      hist[encodeBitWidth(findClosestNumBits(data[i]))] += 1;
+    }
+  }
+
+  void RleEncodeAVX512::scanLiterals(const int64_t* literals, size_t len, int64_t* adjDeltas,
+                                     LiteralScan& scan) {
+    const int64_t initialDelta = literals[1] - literals[0];
+    const __m512i initial = _mm512_set1_epi64(initialDelta);
+    __m512i min = _mm512_set1_epi64(std::min(literals[0], literals[1]));
+    __m512i max = _mm512_set1_epi64(std::max(literals[0], literals[1]));
+    __m512i deltaMax = _mm512_setzero_si512();
+    // lanes that saw a decrease, an increase or another delta
+    __mmask8 decreased = 0;
+    __mmask8 increased = 0;
+    __mmask8 changedDelta = 0;
+
+    size_t i = 2;
+    for (; i + 8 <= len; i += 8) {
+      const __m512i l1 = _mm512_loadu_si512(literals + i);
+      const __m512i l0 = _mm512_loadu_si512(literals + i - 1);
+      const __m512i delta = _mm512_sub_epi64(l1, l0);
+      min = _mm512_min_epi64(min, l1);
+      max = _mm512_max_epi64(max, l1);
+      decreased |= _mm512_cmpgt_epi64_mask(l0, l1);
+      increased |= _mm512_cmpgt_epi64_mask(l1, l0);
+      changedDelta |= _mm512_cmpneq_epi64_mask(delta, initial);
+      const __m512i absDelta = _mm512_abs_epi64(delta);
+      _mm512_storeu_si512(adjDeltas + i - 1, absDelta);
+      deltaMax = _mm512_max_epi64(deltaMax, absDelta);
+    }
+
+    scan.min = _mm512_reduce_min_epi64(min);
+    scan.max = _mm512_reduce_max_epi64(max);
+    scan.deltaMax = _mm512_reduce_max_epi64(deltaMax);
+    scan.isIncreasing = literals[0] <= literals[1] && decreased == 0;
+    scan.isDecreasing = literals[0] >= literals[1] && increased == 0;
+    scan.isFixedDelta = changedDelta == 0;
+
+    for (; i < len; ++i) {
+      const int64_t l1 = literals[i];
+      const int64_t l0 = literals[i - 1];
+      const int64_t currDelta = l1 - l0;
+      scan.min = std::min(scan.min, l1);
+      scan.max = std::max(scan.max, l1);
+      scan.isIncreasing &= (l0 <= l1);
+      scan.isDecreasing &= (l0 >= l1);
+      scan.isFixedDelta &= (currDelta == initialDelta);
+      adjDeltas[i - 1] = std::abs(currDelta);
+      scan.deltaMax = std::max(scan.deltaMax, adjDeltas[i - 1]);
+    }
+  }
+
+}  // namespace orc
@@ -19,13 +19,60 @@
 
 #include "Adaptor.hh"
 #include "Compression.hh"
+#include "Dispatch.hh"
 #include "RLEV2Util.hh"
 #include "RLEv2.hh"
+#include "RleEncodeKernels.hh"
 
 #define MAX_SHORT_REPEAT_LENGTH 10
 
 namespace orc {
 
+  struct ZigZagDynamicFunction {
+    using FunctionType = decltype(&RleEncodeDefault::zigZag);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      std::vector<std::pair<DispatchLevel, FunctionType>> impls = {
+          {DispatchLevel::NONE, RleEncodeDefault::zigZag}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      impls.emplace_back(DispatchLevel::AVX2, RleEncodeAVX2::zigZag);
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+      impls.emplace_back(DispatchLevel::AVX512, RleEncodeAVX512::zigZag);
+#endif
+      return impls;
+    }
+  };
+
+  struct HistogramDynamicFunction {
+    using FunctionType = decltype(&RleEncodeDefault::bitWidthHistogram);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      std::vector<std::pair<DispatchLevel, FunctionType>> impls = {
+          {DispatchLevel::NONE, RleEncodeDefault::bitWidthHistogram}};
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+      impls.emplace_back(DispatchLevel::AVX512, RleEncodeAVX512::bitWidthHistogram);
+#endif
+      return impls;
+    }
+  };
+
+  struct ScanLiteralsDynamicFunction {
+    using FunctionType = decltype(&RleEncodeDefault::scanLiterals);
+
+    static std::vector<std::pair<DispatchLevel, FunctionType>> implementations() {
+      std::vector<std::pair<DispatchLevel, FunctionType>> impls = {
+          {DispatchLevel::NONE, RleEncodeDefault::scanLiterals}};
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      impls.emplace_back(DispatchLevel::AVX2, RleEncodeAVX2::scanLiterals);
+#endif
+#if defined(ORC_HAVE_RUNTIME_AVX512)
+      impls.emplace_back(DispatchLevel::AVX512, RleEncodeAVX512::scanLiterals);
+#endif
+      return impls;
+    }
+  };
+
   /**
    * Compute the bits required to represent pth percentile value
    * @param data - array
@@ -43,10 +90,8 @@ namespace orc {
       // maximum number of bits that can encoded is 32 (refer FixedBitSizes)
       memset(histgram_, 0, FixedBitSizes::SIZE * sizeof(int32_t));
       // compute the histogram
-      for (size_t i = offset; i < (offset + length); i++) {
-        uint32_t idx = encodeBitWidth(findClosestNumBits(data[i]));
-        histgram_[idx] += 1;
-      }
+      static DynamicDispatch<HistogramDynamicFunction> dispatch;
+      dispatch.get()(data + offset, length, histgram_);
     }
 
     int32_t perLen = static_cast<int32_t>(static_cast<double>(length) * (1.0 - p));
@@ -171,9 +216,9 @@ namespace orc {
 
   void RleEncoderV2::computeZigZagLiterals(EncodingOption& option) {
     assert(isSigned);
-    for (size_t i = 0; i < numLiterals; i++) {
-      zigzagLiterals_[option.zigzagLiteralsCount++] = zigZag(literals[i]);
-    }
+    static DynamicDispatch<ZigZagDynamicFunction> dispatch;
+    dispatch.get()(literals, zigzagLiterals_ + option.zigzagLiteralsCount, numLiterals);
+    option.zigzagLiteralsCount += static_cast<int64_t>(numLiterals);
   }
 
   void RleEncoderV2::preparePatchedBlob(EncodingOption& option) {
@@ -308,34 +353,20 @@ namespace orc {
 
     // DELTA encoding check
 
-    // for identifying monotonic sequences
-    bool isIncreasing = true;
-    bool isDecreasing = true;
-    option.isFixedDelta = true;
-
-    option.min = literals[0];
-    int64_t max = literals[0];
-    int64_t initialDelta = literals[1] - literals[0];
-    int64_t currDelta = 0;
-    int64_t deltaMax = 0;
-    adjDeltas_[option.adjDeltasCount++] = initialDelta;
-
-    for (size_t i = 1; i < numLiterals; i++) {
-      const int64_t l1 = literals[i];
-      const int64_t l0 = literals[i - 1];
-      currDelta = l1 - l0;
-      option.min = std::min(option.min, l1);
-      max = std::max(max, l1);
-
-      isIncreasing &= (l0 <= l1);
-      isDecreasing &= (l0 >= l1);
-
-      option.isFixedDelta &= (currDelta == initialDelta);
-      if (i > 1) {
-        adjDeltas_[option.adjDeltasCount++] = std::abs(currDelta);
-        deltaMax = std::max(deltaMax, adjDeltas_[i - 1]);
-      }
-    }
+    // for identifying monotonic sequences and the range of the literals
+    static DynamicDispatch<ScanLiteralsDynamicFunction> dispatch;
+    LiteralScan scan;
+    dispatch.get()(literals, numLiterals, adjDeltas_, scan);
+    const bool isIncreasing = scan.isIncreasing;
+    const bool isDecreasing = scan.isDecreasing;
+    option.isFixedDelta = scan.isFixedDelta;
+    option.min = scan.min;
+    const int64_t max = scan.max;
+    const int64_t initialDelta = literals[1] - literals[0];
+    const int64_t currDelta = literals[numLiterals - 1] - literals[numLiterals - 2];
+    const int64_t deltaMax = scan.deltaMax;
+    adjDeltas_[0] = initialDelta;
+    option.adjDeltasCount = static_cast<int64_t>(numLiterals) - 1;
 
     // it's faster to exit under delta overflow condition without checking for
     // PATCHED_BASE condition as encoding using DIRECT is faster and has less
@@ -679,76 +710,42 @@ namespace orc {
       return;
     }
 
-    if (getClosestAlignedFixedBits(bitSize) == bitSize) {
-      uint32_t numBytes;
-      uint32_t endOffSet = static_cast<uint32_t>(offset + len);
-      if (bitSize < 8) {
-        char bitMask = static_cast<char>((1 << bitSize) - 1);
-        uint32_t numHops = 8 / bitSize;
-        uint32_t remainder = static_cast<uint32_t>(len % numHops);
-        uint32_t endUnroll = endOffSet - remainder;
-        for (uint32_t i = offset; i < endUnroll; i += numHops) {
-          char toWrite = 0;
-          for (uint32_t j = 0; j < numHops; ++j) {
-            toWrite |= static_cast<char>((input[i + j] & bitMask) << (8 - (j + 1) * bitSize));
-          }
-          writeByte(toWrite);
-        }
-
-        if (remainder > 0) {
-          uint32_t startShift = 8 - bitSize;
-          char toWrite = 0;
-          for (uint32_t i = endUnroll; i < endOffSet; ++i) {
-            toWrite |= static_cast<char>((input[i] & bitMask) << startShift);
-            startShift -= bitSize;
-          }
-          writeByte(toWrite);
-        }
-
-      } else {
-        numBytes = bitSize / 8;
-
-        for (uint32_t i = offset; i < endOffSet; ++i) {
-          for (uint32_t j = 0; j < numBytes; ++j) {
-            char toWrite = static_cast<char>((input[i] >> (8 * (numBytes - j - 1))) & 255);
-            writeByte(toWrite);
-          }
-        }
+    // Values are packed MSB first into a bit buffer, whose whole bytes are
+    // staged locally and copied to the output stream in bulk.
+    char packed[256];
+    size_t packedSize = 0;
+    uint64_t bitBuffer = 0;
+    // never more than 7 between appends, so appending 32 bits can't overflow
+    uint32_t bitCount = 0;
+    auto append = [&](uint64_t bits, uint32_t numBits) {
+      bitBuffer = (bitBuffer << numBits) | bits;
+      bitCount += numBits;
+      while (bitCount >= 8) {
+        bitCount -= 8;
+        packed[packedSize++] = static_cast<char>(bitBuffer >> bitCount);
       }
-
-      return;
-    }
-
-    // write for unaligned bit size
-    uint32_t bitsLeft = 8;
-    char current = 0;
-    for (uint32_t i = offset; i < (offset + len); i++) {
-      int64_t value = input[i];
-      uint32_t bitsToWrite = bitSize;
-      while (bitsToWrite > bitsLeft) {
-        // add the bits to the bottom of the current word
-        current |= static_cast<char>(value >> (bitsToWrite - bitsLeft));
-        // subtract out the bits we just added
-        bitsToWrite -= bitsLeft;
-        // zero out the bits above bitsToWrite
-        value &= (static_cast<uint64_t>(1) << bitsToWrite) - 1;
-        writeByte(current);
-        current = 0;
-        bitsLeft = 8;
+      if (packedSize > sizeof(packed) - 8) {
+        writeBytes(packed, packedSize);
+        packedSize = 0;
       }
-      bitsLeft -= bitsToWrite;
-      current |= static_cast<char>(value << bitsLeft);
-      if (bitsLeft == 0) {
-        writeByte(current);
-        current = 0;
-        bitsLeft = 8;
+    };
+
+    const uint64_t mask = bitSize == 64 ? ~0ULL : (1ULL << bitSize) - 1;
+    for (size_t i = offset; i < offset + len; ++i) {
+      uint64_t value = static_cast<uint64_t>(input[i]) & mask;
+      if (bitSize > 32) {
+        append(value >> 32, bitSize - 32);
+        append(value & 0xffffffff, 32);
+      } else {
+        append(value, bitSize);
       }
     }
 
-    // flush
-    if (bitsLeft != 8) {
-      writeByte(current);
+    // flush the last partial byte, padded with zeros
+    if (bitCount > 0) {
+      packed[packedSize++] = static_cast<char>(bitBuffer << (8 - bitCount));
     }
+    writeBytes(packed, packedSize);
   }
 
   void RleEncoderV2::initializeLiterals(int64_t val) {
@@ -0,0 +1,238 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "RowSelection.hh"
+#include "orc/Exceptions.hh"
+
+#include <algorithm>
+#include <cstring>
+
+namespace orc {
+
+  uint64_t getSelectedRuns(const char* selected, uint64_t numRows, std::vector<RowRun>& runs) {
+    runs.clear();
+    uint64_t numSelected = 0;
+    uint64_t row = 0;
+    while (row < numRows) {
+      while (row < numRows && !selected[row]) {
+        ++row;
+      }
+      uint64_t start = row;
+      while (row < numRows && selected[row]) {
+        ++row;
+      }
+      if (row > start) {
+        runs.push_back(RowRun{start, row - start});
+        numSelected += row - start;
+      }
+    }
+    return numSelected;
+  }
+
+  StringArena::StringArena(MemoryPool& pool) : pool_(pool), currentBlock_(0), used_(0) {
+    // PASS
+  }
+
+  char* StringArena::allocate(uint64_t size) {
+    static const uint64_t MIN_BLOCK_SIZE = 64 * 1024;
+    while (currentBlock_ < blocks_.size() && used_ + size > blocks_[currentBlock_]->size()) {
+      ++currentBlock_;
+      used_ = 0;
+    }
+    if (currentBlock_ == blocks_.size()) {
+      blocks_.push_back(
+          std::make_unique<DataBuffer<char>>(pool_, std::max(size, MIN_BLOCK_SIZE)));
+    }
+    char* result = blocks_[currentBlock_]->data() + used_;
+    used_ += size;
+    return result;
+  }
+
+  void StringArena::clear() {
+    currentBlock_ = 0;
+    used_ = 0;
+  }
+
+  namespace {
+
+    // Copy values that may overlap when a batch is compacted in place.
+    template <typename T>
+    void copyValues(const DataBuffer<T>& src, uint64_t srcOffset, DataBuffer<T>& dst,
+                    uint64_t dstOffset, uint64_t count) {
+      if (&src != &dst || srcOffset != dstOffset) {
+        std::copy(src.data() + srcOffset, src.data() + srcOffset + count, dst.data() + dstOffset);
+      }
+    }
+
+    template <typename BatchType>
+    bool copyData(const ColumnVectorBatch& src, uint64_t srcOffset, ColumnVectorBatch& dst,
+                  uint64_t dstOffset, uint64_t count) {
+      auto* dstBatch = dynamic_cast<BatchType*>(&dst);
+      if (dstBatch == nullptr) {
+        return false;
+      }
+      copyValues(dynamic_cast<const BatchType&>(src).data, srcOffset, dstBatch->data, dstOffset,
+                 count);
+      return true;
+    }
+
+    void copyStrings(const StringVectorBatch& src, uint64_t srcOffset, StringVectorBatch& dst,
+                     uint64_t dstOffset, uint64_t count, StringArena& arena) {
+      copyValues(src.length, srcOffset, dst.length, dstOffset, count);
+      if (&src == &dst) {
+        // the values stay where they are
+        copyValues(src.data, srcOffset, dst.data, dstOffset, count);
+        return;
+      }
+      const char* notNull = src.hasNulls ? src.notNull.data() + srcOffset : nullptr;
+      uint64_t totalLength = 0;
+      for (uint64_t i = 0; i < count; ++i) {
+        if (!notNull || notNull[i]) {
+          totalLength += static_cast<uint64_t>(src.length[srcOffset + i]);
+        }
+      }
+      char* ptr = arena.allocate(totalLength);
+      for (uint64_t i = 0; i < count; ++i) {
+        if (!notNull || notNull[i]) {
+          size_t length = static_cast<size_t>(src.length[srcOffset + i]);
+          memcpy(ptr, src.data[srcOffset + i], length);
+          dst.data[dstOffset + i] = ptr;
+          ptr += length;
+        }
+      }
+    }
+
+    // Rebase the offsets of list or map rows and find the children to copy.
+    // @return the number of children
+    uint64_t copyOffsets(const DataBuffer<int64_t>& src, uint64_t srcOffset,
+                         DataBuffer<int64_t>& dst, uint64_t dstOffset, uint64_t count,
+                         uint64_t& childSrcOffset, uint64_t& childDstOffset) {
+      if (dstOffset == 0) {
+        dst[0] = 0;
+      }
+      int64_t srcStart = src[srcOffset];
+      int64_t srcEnd = src[srcOffset + count];
+      int64_t dstStart = dst[dstOffset];
+      for (uint64_t i = 1; i <= count; ++i) {
+        dst[dstOffset + i] = dstStart + (src[srcOffset + i] - srcStart);
+      }
+      childSrcOffset = static_cast<uint64_t>(srcStart);
+      childDstOffset = static_cast<uint64_t>(dstStart);
+      return static_cast<uint64_t>(srcEnd - srcStart);
+    }
+
+  }  // namespace
+
+  void copyRows(const ColumnVectorBatch& src, uint64_t srcOffset, ColumnVectorBatch& dst,
+                uint64_t dstOffset, uint64_t count, StringArena& arena) {
+    if (dst.capacity < dstOffset + count) {
+      dst.resize(dstOffset + count);
+    }
+    if (dstOffset == 0) {
+      dst.hasNulls = false;
+    }
+    if (src.hasNulls) {
+      copyValues(src.notNull, srcOffset, dst.notNull, dstOffset, count);
+      const char* notNull = dst.notNull.data() + dstOffset;
+      dst.hasNulls = dst.hasNulls || std::find(notNull, notNull + count, 0) != notNull + count;
+    } else {
+      memset(dst.notNull.data() + dstOffset, 1, count);
+    }
+    dst.numElements = dstOffset + count;
+    dst.isEncoded = src.isEncoded;
+
+    if (copyData<LongVectorBatch>(src, srcOffset, dst, dstOffset, count) ||
+        copyData<DoubleVectorBatch>(src, srcOffset, dst, dstOffset, count) ||
+        copyData<IntVectorBatch>(src, srcOffset, dst, dstOffset, count) ||
+        copyData<ShortVectorBatch>(src, srcOffset, dst, dstOffset, count) ||
+        copyData<ByteVectorBatch>(src, srcOffset, dst, dstOffset, count) ||
+        copyData<FloatVectorBatch>(src, srcOffset, dst, dstOffset, count)) {
+      return;
+    }
+    if (auto* strings = dynamic_cast<StringVectorBatch*>(&dst)) {
+      const auto& srcStrings = dynamic_cast<const StringVectorBatch&>(src);
+      auto* encoded = dynamic_cast<EncodedStringVectorBatch*>(&dst);
+      if (encoded && src.isEncoded) {
+        // only the dictionary indexes are set for encoded batches
+        const auto& srcEncoded = dynamic_cast<const EncodedStringVectorBatch&>(src);
+        copyValues(srcEncoded.index, srcOffset, encoded->index, dstOffset, count);
+        encoded->dictionary = srcEncoded.dictionary;
+      } else {
+        copyStrings(srcStrings, srcOffset, *strings, dstOffset, count, arena);
+      }
+    } else if (auto* timestamps = dynamic_cast<TimestampVectorBatch*>(&dst)) {
+      const auto& srcTimestamps = dynamic_cast<const TimestampVectorBatch&>(src);
+      copyValues(srcTimestamps.data, srcOffset, timestamps->data, dstOffset, count);
+      copyValues(srcTimestamps.nanoseconds, srcOffset, timestamps->nanoseconds, dstOffset, count);
+    } else if (auto* decimals = dynamic_cast<Decimal64VectorBatch*>(&dst)) {
+      const auto& srcDecimals = dynamic_cast<const Decimal64VectorBatch&>(src);
+      copyValues(srcDecimals.values, srcOffset, decimals->values, dstOffset, count);
+      decimals->precision = srcDecimals.precision;
+      decimals->scale = srcDecimals.scale;
+    } else if (auto* decimals128 = dynamic_cast<Decimal128VectorBatch*>(&dst)) {
+      const auto& srcDecimals = dynamic_cast<const Decimal128VectorBatch&>(src);
+      copyValues(srcDecimals.values, srcOffset, decimals128->values, dstOffset, count);
+      decimals128->precision = srcDecimals.precision;
+      decimals128->scale = srcDecimals.scale;
+    } else if (auto* structs = dynamic_cast<StructVectorBatch*>(&dst)) {
+      const auto& srcStructs = dynamic_cast<const StructVectorBatch&>(src);
+      for (size_t i = 0; i < structs->fields.size(); ++i) {
+        copyRows(*srcStructs.fields[i], srcOffset, *structs->fields[i], dstOffset, count, arena);
+      }
+    } else if (auto* lists = dynamic_cast<ListVectorBatch*>(&dst)) {
+      const auto& srcLists = dynamic_cast<const ListVectorBatch&>(src);
+      uint64_t childSrcOffset;
+      uint64_t childDstOffset;
+      uint64_t childCount = copyOffsets(srcLists.offsets, srcOffset, lists->offsets, dstOffset,
+                                        count, childSrcOffset, childDstOffset);
+      copyRows(*srcLists.elements, childSrcOffset, *lists->elements, childDstOffset, childCount,
+               arena);
+    } else if (auto* maps = dynamic_cast<MapVectorBatch*>(&dst)) {
+      const auto& srcMaps = dynamic_cast<const MapVectorBatch&>(src);
+      uint64_t childSrcOffset;
+      uint64_t childDstOffset;
+      uint64_t childCount = copyOffsets(srcMaps.offsets, srcOffset, maps->offsets, dstOffset,
+                                        count, childSrcOffset, childDstOffset);
+      copyRows(*srcMaps.keys, childSrcOffset, *maps->keys, childDstOffset, childCount, arena);
+      copyRows(*srcMaps.elements, childSrcOffset, *maps->elements, childDstOffset, childCount,
+               arena);
+    } else if (auto* unions = dynamic_cast<UnionVectorBatch*>(&dst)) {
+      const auto& srcUnions = dynamic_cast<const UnionVectorBatch&>(src);
+      if (dstOffset == 0) {
+        // the number of elements of each child tracks where its next row goes
+        for (auto* child : unions->children) {
+          child->numElements = 0;
+        }
+      }
+      for (uint64_t i = 0; i < count; ++i) {
+        unsigned char tag = srcUnions.tags[srcOffset + i];
+        uint64_t childRow = srcUnions.offsets[srcOffset + i];
+        unions->tags[dstOffset + i] = tag;
+        if (!src.hasNulls || src.notNull[srcOffset + i]) {
+          ColumnVectorBatch& child = *unions->children[tag];
+          unions->offsets[dstOffset + i] = child.numElements;
+          copyRows(*srcUnions.children[tag], childRow, child, child.numElements, 1, arena);
+        }
+      }
+    } else {
+      throw NotImplementedYet("copyRows unhandled batch type " + dst.toString());
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,78 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_ROW_SELECTION_HH
+#define ORC_ROW_SELECTION_HH
+
+#include "orc/MemoryPool.hh"
+#include "orc/Vector.hh"
+
+#include <memory>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * A run of consecutive selected rows of a batch.
+   */
+  struct RowRun {
+    uint64_t offset;
+    uint64_t length;
+  };
+
+  /**
+   * Collect the runs of rows whose selected byte is set.
+   * @return the number of selected rows
+   */
+  uint64_t getSelectedRuns(const char* selected, uint64_t numRows, std::vector<RowRun>& runs);
+
+  /**
+   * Owns copies of the string values taken from batches that are overwritten
+   * while the copies are still in use. Memory is reused after clear().
+   */
+  class StringArena {
+   public:
+    explicit StringArena(MemoryPool& pool);
+
+    char* allocate(uint64_t size);
+
+    void clear();
+
+   private:
+    MemoryPool& pool_;
+    std::vector<std::unique_ptr<DataBuffer<char>>> blocks_;
+    size_t currentBlock_;
+    uint64_t used_;
+  };
+
+  /**
+   * Copy count rows of src starting at srcOffset to dst starting at dstOffset,
+   * including the nested values of the rows. Both batches must be of the same
+   * type and dst is grown as needed. Rows must be copied in order, starting at
+   * dstOffset 0, and dst.numElements is set to the number of rows copied so far.
+   *
+   * src may be dst itself as long as dstOffset <= srcOffset, which compacts the
+   * batch in place. Otherwise, string values are copied into arena.
+   */
+  void copyRows(const ColumnVectorBatch& src, uint64_t srcOffset, ColumnVectorBatch& dst,
+                uint64_t dstOffset, uint64_t count, StringArena& arena);
+
+}  // namespace orc
+
+#endif
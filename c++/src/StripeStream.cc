@@ -104,21 +104,27 @@ namespace orc {
         BufferSlice slice;
         if (readCache_) {
           ReadRange range{offset, streamLength};
-          slice = readCache_->read(range);
+          // parts the cache lacks are counted as misses when they are read
+          slice = readCache_->read(range, false);
         }
 
-        uint64_t myBlock = shouldStream ? input_.getNaturalReadSize() : streamLength;
+        // mapped streams aren't copied, so there's no point in handing them
+        // out in small pieces
+        uint64_t myBlock = shouldStream && !input_.getMappedData() ? input_.getNaturalReadSize()
+                                                                   : streamLength;
         std::unique_ptr<SeekableInputStream> seekableInput;
         if (slice.buffer) {
           seekableInput = std::make_unique<SeekableArrayInputStream>(
               slice.buffer->data() + slice.offset, slice.length);
         } else {
+          // the stream may still be prefetched in parts, e.g. selected row groups
           seekableInput = std::make_unique<SeekableFileInputStream>(&input_, offset, streamLength,
-                                                                    *pool, myBlock);
+                                                                    *pool, myBlock, readCache_);
         }
+        const FileContents& contents = reader_.getFileContents();
         return createDecompressor(reader_.getCompression(), std::move(seekableInput),
-                                  reader_.getCompressionSize(), *pool,
-                                  reader_.getFileContents().readerMetrics);
+                                  reader_.getCompressionSize(), *pool, contents.readerMetrics,
+                                  contents.decompressorPool);
       }
       offset += stream.length();
     }
@@ -149,6 +155,10 @@ namespace orc {
     return reader_.getSchemaEvolution();
   }
 
+  ColumnDecodePool* StripeStreamsImpl::getColumnDecodePool() const {
+    return reader_.getColumnDecodePool();
+  }
+
   void StripeInformationImpl::ensureStripeFooterLoaded() const {
     if (stripeFooter_.get() == nullptr) {
       std::unique_ptr<SeekableInputStream> pbStream = createDecompressor(
@@ -83,6 +83,8 @@ namespace orc {
     const SchemaEvolution* getSchemaEvolution() const override;
     
     std::shared_ptr<StringDictionary> getSharedDictionary(uint64_t columnId) const override;
+
+    ColumnDecodePool* getColumnDecodePool() const override;
   };
 
   /**
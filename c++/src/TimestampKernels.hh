@@ -0,0 +1,54 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#ifndef ORC_TIMESTAMPKERNELS_HH
+#define ORC_TIMESTAMPKERNELS_HH
+
+#include <cstdint>
+
+namespace orc {
+
+  /**
+   * The nanoseconds of a timestamp are written without their trailing
+   * zeros: the low 3 bits hold the number of dropped zeros minus one (or 0
+   * when none was dropped) and the remaining bits the significant digits.
+   */
+  class TimestampDecodeDefault {
+   public:
+    // Restore numValues encoded nanoseconds in place
+    static void decodeNanos(int64_t* nanos, uint64_t numValues);
+  };
+
+  class TimestampDecodeAVX2 {
+   public:
+    static void decodeNanos(int64_t* nanos, uint64_t numValues);
+  };
+
+  // The factor restoring the dropped zeros for each value of the low 3 bits
+  constexpr int64_t NANOS_SCALE[8] = {1, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+
+  // Restore one encoded value, in unsigned math so that corrupt values wrap
+  inline int64_t decodeNano(int64_t encoded) {
+    uint64_t value = static_cast<uint64_t>(encoded);
+    return static_cast<int64_t>((value >> 3) * static_cast<uint64_t>(NANOS_SCALE[value & 0x7]));
+  }
+
+}  // namespace orc
+
+#endif
@@ -0,0 +1,68 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#include "Dispatch.hh"
+#include "TimestampKernels.hh"
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#else
+#include <immintrin.h>
+#endif
+
+namespace orc {
+
+  namespace {
+    ORC_TARGET_AVX2 void decodeNanosAvx2(int64_t* nanos, uint64_t numValues) {
+      // Valid nanoseconds have less than 30 significant bits and the scale
+      // fits 32 bits, so a 32x32->64 bit multiplication is enough.
+      const __m256i scales =
+          _mm256_setr_epi32(static_cast<int>(NANOS_SCALE[0]), static_cast<int>(NANOS_SCALE[1]),
+                            static_cast<int>(NANOS_SCALE[2]), static_cast<int>(NANOS_SCALE[3]),
+                            static_cast<int>(NANOS_SCALE[4]), static_cast<int>(NANOS_SCALE[5]),
+                            static_cast<int>(NANOS_SCALE[6]), static_cast<int>(NANOS_SCALE[7]));
+      const __m256i zerosMask = _mm256_set1_epi64x(0x7);
+      const __m256i highBits = _mm256_set1_epi64x(static_cast<int64_t>(0xffffffff00000000ULL));
+      uint64_t i = 0;
+      for (; i + 4 <= numValues; i += 4) {
+        __m256i value = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(nanos + i));
+        // the low 32 bits of each lane pick its scale
+        __m256i scale = _mm256_permutevar8x32_epi32(scales, _mm256_and_si256(value, zerosMask));
+        __m256i digits = _mm256_srli_epi64(value, 3);
+        __m256i result = _mm256_mul_epu32(digits, scale);
+        // fall back to 64-bit math for corrupt values that don't fit
+        if (!_mm256_testz_si256(digits, highBits)) {
+          for (uint64_t j = i; j < i + 4; ++j) {
+            nanos[j] = decodeNano(nanos[j]);
+          }
+          continue;
+        }
+        _mm256_storeu_si256(reinterpret_cast<__m256i*>(nanos + i), result);
+      }
+      for (; i < numValues; ++i) {
+        nanos[i] = decodeNano(nanos[i]);
+      }
+    }
+  }  // namespace
+
+  void TimestampDecodeAVX2::decodeNanos(int64_t* nanos, uint64_t numValues) {
+    decodeNanosAvx2(nanos, numValues);
+  }
+
+}  // namespace orc
@@ -24,6 +24,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <time.h>
+#include <algorithm>
 #include <atomic>
 #include <map>
 #include <sstream>
@@ -255,6 +256,8 @@ namespace orc {
     virtual ~FutureRuleImpl() override;
     bool isDefined() const override;
     const TimezoneVariant& getVariant(int64_t clk) const override;
+    const TimezoneVariant& getVariantRange(int64_t clk, int64_t* start,
+                                           int64_t* end) const override;
     void print(std::ostream& out) const override;
 
     friend class FutureRuleParser;
@@ -289,6 +292,37 @@ namespace orc {
     }
   }
 
+  const TimezoneVariant& FutureRuleImpl::getVariantRange(int64_t clk, int64_t* start,
+                                                         int64_t* end) const {
+    if (!hasDst_) {
+      *start = INT64_MIN;
+      *end = INT64_MAX;
+      return standard_;
+    }
+    int64_t adjusted = clk % SECONDS_PER_400_YEARS;
+    if (adjusted < 0) {
+      adjusted += SECONDS_PER_400_YEARS;
+    }
+    int64_t idx = binarySearch(offsets_, adjusted);
+    if (clk < INT64_MIN + SECONDS_PER_400_YEARS || clk > INT64_MAX - SECONDS_PER_400_YEARS) {
+      // an empty range rather than overflowing
+      *start = clk;
+      *end = clk;
+    } else {
+      // the range ends at the next transition or, conservatively, at the end
+      // of the 400 year cycle
+      size_t next = static_cast<size_t>(idx + 1);
+      int64_t nextOffset = next < offsets_.size() ? offsets_[next] : SECONDS_PER_400_YEARS;
+      *start = clk - (adjusted - offsets_[static_cast<size_t>(idx)]);
+      *end = clk + (nextOffset - adjusted);
+    }
+    if (startInStd_ == (idx % 2 == 0)) {
+      return standard_;
+    } else {
+      return dst_;
+    }
+  }
+
   void FutureRuleImpl::print(std::ostream& out) const {
     if (isDefined()) {
       out << "  Future rule: " << ruleString_ << "\n";
@@ -595,6 +629,9 @@ namespace orc {
      */
     const TimezoneVariant& getVariant(int64_t clk) const override;
 
+    const TimezoneVariant& getVariantRange(int64_t clk, int64_t* start,
+                                           int64_t* end) const override;
+
     void print(std::ostream&) const override;
 
     uint64_t getVersion() const override {
@@ -661,6 +698,22 @@ namespace orc {
     // PASS
   }
 
+  void Timezone::convertToUTC(const int64_t* clk, int64_t* result, uint64_t numValues,
+                              const char* notNull) const {
+    TimezoneVariantCache variants(*this);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      result[i] = notNull == nullptr || notNull[i] ? variants.convertToUTC(clk[i]) : clk[i];
+    }
+  }
+
+  void Timezone::convertFromUTC(const int64_t* clk, int64_t* result, uint64_t numValues,
+                                const char* notNull) const {
+    TimezoneVariantCache variants(*this);
+    for (uint64_t i = 0; i < numValues; ++i) {
+      result[i] = notNull == nullptr || notNull[i] ? variants.convertFromUTC(clk[i]) : clk[i];
+    }
+  }
+
   TimezoneImpl::TimezoneImpl(const std::string& filename, const std::vector<unsigned char>& buffer)
       : filename_(filename) {
     parseZoneFile(&buffer[0], 0, buffer.size(), Version1Parser());
@@ -733,6 +786,10 @@ namespace orc {
     const TimezoneVariant& getVariant(int64_t clk) const override {
       return getImpl()->getVariant(clk);
     }
+    const TimezoneVariant& getVariantRange(int64_t clk, int64_t* start,
+                                           int64_t* end) const override {
+      return getImpl()->getVariantRange(clk, start, end);
+    }
     int64_t getEpoch() const override {
       return getImpl()->getEpoch();
     }
@@ -962,6 +1019,25 @@ namespace orc {
     }
   }
 
+  const TimezoneVariant& TimezoneImpl::getVariantRange(int64_t clk, int64_t* start,
+                                                       int64_t* end) const {
+    if (clk > lastTransition_) {
+      const TimezoneVariant& variant = futureRule_->getVariantRange(clk, start, end);
+      *start = std::max(*start, lastTransition_ + 1);
+      return variant;
+    }
+    int64_t transition = binarySearch(transitions_, clk);
+    size_t next = static_cast<size_t>(transition + 1);
+    *start = transition < 0 ? INT64_MIN : transitions_[static_cast<size_t>(transition)];
+    *end = next < transitions_.size() ? transitions_[next] : INT64_MAX;
+    // times after the last explicit transition follow the future rule
+    if (lastTransition_ != INT64_MAX) {
+      *end = std::min(*end, lastTransition_ + 1);
+    }
+    return variants_[transition < 0 ? ancientVariant_
+                                    : currentVariant_[static_cast<size_t>(transition)]];
+  }
+
   void TimezoneImpl::print(std::ostream& out) const {
     out << "Timezone file: " << filename_ << "\n";
     out << "  Version: " << version_ << "\n";
@@ -63,6 +63,13 @@ namespace orc {
      */
     virtual const TimezoneVariant& getVariant(int64_t clk) const = 0;
 
+    /**
+     * Get the variant for the given time (time_t) along with a range of
+     * times [*start, *end) around it that all have the same variant.
+     */
+    virtual const TimezoneVariant& getVariantRange(int64_t clk, int64_t* start,
+                                                   int64_t* end) const = 0;
+
     /**
      * Get the number of seconds between the ORC epoch in this timezone
      * and Unix epoch.
@@ -90,6 +97,60 @@ namespace orc {
      * Convert UTC timezone to wall clock time of current timezone
      */
     virtual int64_t convertFromUTC(int64_t clk) const = 0;
+
+    /**
+     * Convert numValues wall clock times of current timezone to UTC timezone.
+     * Runs of times sharing the same rules take a single lookup.
+     * @param clk the times to convert
+     * @param result the converted times, which may be the same array as clk
+     * @param notNull if not null, the times whose entry is 0 are copied as is
+     */
+    void convertToUTC(const int64_t* clk, int64_t* result, uint64_t numValues,
+                      const char* notNull = nullptr) const;
+
+    /**
+     * Convert numValues UTC times to wall clock times of current timezone.
+     * The parameters are the same as convertToUTC() above.
+     */
+    void convertFromUTC(const int64_t* clk, int64_t* result, uint64_t numValues,
+                        const char* notNull = nullptr) const;
+  };
+
+  /**
+   * Remembers the range of times covered by the last variant looked up, so
+   * that converting a run of close times takes one lookup per range instead
+   * of one per time.
+   */
+  class TimezoneVariantCache {
+   public:
+    explicit TimezoneVariantCache(const Timezone& timezone)
+        : timezone_(&timezone), variant_(nullptr), start_(0), end_(0) {}
+
+    const TimezoneVariant& getVariant(int64_t clk) {
+      if (variant_ == nullptr || clk < start_ || clk >= end_) {
+        variant_ = &timezone_->getVariantRange(clk, &start_, &end_);
+      }
+      return *variant_;
+    }
+
+    int64_t convertToUTC(int64_t clk) {
+      return clk + getVariant(clk).gmtOffset;
+    }
+
+    int64_t convertFromUTC(int64_t clk) {
+      int64_t adjustedTime = clk - getVariant(clk).gmtOffset;
+      return clk - getVariant(adjustedTime).gmtOffset;
+    }
+
+    const Timezone& getTimezone() const {
+      return *timezone_;
+    }
+
+   private:
+    const Timezone* timezone_;
+    const TimezoneVariant* variant_;
+    int64_t start_;
+    int64_t end_;
   };
 
   /**
@@ -127,6 +188,8 @@ namespace orc {
     virtual ~FutureRule();
     virtual bool isDefined() const = 0;
     virtual const TimezoneVariant& getVariant(int64_t clk) const = 0;
+    virtual const TimezoneVariant& getVariantRange(int64_t clk, int64_t* start,
+                                                   int64_t* end) const = 0;
     virtual void print(std::ostream& out) const = 0;
   };
 
@@ -23,8 +23,13 @@
 #include "Timezone.hh"
 #include "Utils.hh"
 
+#include <deque>
+#include <future>
+#include <map>
 #include <memory>
 #include <stdexcept>
+#include <utility>
+#include <vector>
 
 namespace orc {
 
@@ -49,6 +54,10 @@ namespace orc {
     uint64_t outputBufferCapacity;
     uint64_t memoryBlockSize;
     bool alignBlockBoundToRowGroup;
+    uint32_t compressionThreads;
+    uint32_t maxPendingStripes;
+    std::map<uint64_t, ColumnCompression> columnCompression;
+    std::map<std::pair<uint64_t, StreamKind>, ColumnCompression> streamCompression;
 
     WriterOptionsPrivate() : fileVersion(FileVersion::v_0_12()) {  // default to Hive_0_12
       stripeSize = 64 * 1024 * 1024;                               // 64M
@@ -72,6 +81,8 @@ namespace orc {
       outputBufferCapacity = 1024 * 1024;
       memoryBlockSize = 64 * 1024;  // 64K
       alignBlockBoundToRowGroup = false;
+      compressionThreads = 1;
+      maxPendingStripes = 0;
     }
   };
 
@@ -246,8 +257,14 @@ namespace orc {
     return privateBits_->bloomFilterFalsePositiveProb;
   }
 
-  // delibrately not provide setter to write bloom filter version because
-  // we only support UTF8 for now.
+  WriterOptions& WriterOptions::setBloomFilterVersion(BloomFilterVersion version) {
+    if (version != BloomFilterVersion::UTF8 && version != BloomFilterVersion::SPLIT_BLOCK) {
+      throw std::invalid_argument("Unsupported bloom filter version: " + std::to_string(version));
+    }
+    privateBits_->bloomFilterVersion = version;
+    return *this;
+  }
+
   BloomFilterVersion WriterOptions::getBloomFilterVersion() const {
     return privateBits_->bloomFilterVersion;
   }
@@ -310,6 +327,48 @@ namespace orc {
     return privateBits_->alignBlockBoundToRowGroup;
   }
 
+  WriterOptions& WriterOptions::setCompressionThreads(uint32_t numThreads) {
+    privateBits_->compressionThreads = numThreads;
+    return *this;
+  }
+
+  uint32_t WriterOptions::getCompressionThreads() const {
+    return privateBits_->compressionThreads;
+  }
+
+  WriterOptions& WriterOptions::setMaxPendingStripes(uint32_t numStripes) {
+    privateBits_->maxPendingStripes = numStripes;
+    return *this;
+  }
+
+  uint32_t WriterOptions::getMaxPendingStripes() const {
+    return privateBits_->maxPendingStripes;
+  }
+
+  WriterOptions& WriterOptions::setColumnCompression(uint64_t column,
+                                                     const ColumnCompression& compression) {
+    privateBits_->columnCompression[column] = compression;
+    return *this;
+  }
+
+  WriterOptions& WriterOptions::setColumnCompression(uint64_t column, StreamKind kind,
+                                                     const ColumnCompression& compression) {
+    privateBits_->streamCompression[std::make_pair(column, kind)] = compression;
+    return *this;
+  }
+
+  ColumnCompression WriterOptions::getColumnCompression(uint64_t column, StreamKind kind) const {
+    auto stream = privateBits_->streamCompression.find(std::make_pair(column, kind));
+    if (stream != privateBits_->streamCompression.end()) {
+      return stream->second;
+    }
+    auto col = privateBits_->columnCompression.find(column);
+    if (col != privateBits_->columnCompression.end()) {
+      return col->second;
+    }
+    return ColumnCompression();
+  }
+
   Writer::~Writer() {
     // PASS
   }
@@ -319,6 +378,12 @@ namespace orc {
     std::unique_ptr<ColumnWriter> columnWriter_;
     std::unique_ptr<BufferedOutputStream> compressionStream_;
     std::unique_ptr<BufferedOutputStream> bufferedStream_;
+    // compression contexts and buffers shared by all streams
+    std::shared_ptr<CompressorPool> compressorPool_;
+    // compresses the blocks of the column streams if there are several
+    // compression threads; declared after columnWriter_ so that it finishes
+    // the pending blocks before the streams are destroyed
+    std::unique_ptr<IOExecutor> compressionExecutor_;
     std::unique_ptr<StreamsFactory> streamsFactory_;
     OutputStream* outStream_;
     WriterOptions options_;
@@ -327,9 +392,21 @@ namespace orc {
     uint64_t currentOffset_;
     proto::Footer fileFooter_;
     proto::PostScript postScript_;
-    proto::StripeInformation stripeInfo_;
     proto::Metadata metadata_;
 
+    // writes full stripes in the background if there may be pending stripes
+    std::unique_ptr<IOExecutor> stripeExecutor_;
+    struct PendingStripe {
+      std::unique_ptr<ColumnWriter> columnWriter;
+      std::future<void> done;
+    };
+    // stripes handed to stripeExecutor_, oldest first
+    std::deque<PendingStripe> pendingStripes_;
+    // column writers whose stripes have been written, ready for the next one
+    std::vector<std::unique_ptr<ColumnWriter>> idleColumnWriters_;
+    // the column writer holding the file statistics of all stripes
+    ColumnWriter* fileStatsWriter_;
+
     static const char* magicId;
     static const WriterId writerId;
     bool useTightNumericVector_;
@@ -339,6 +416,8 @@ namespace orc {
    public:
     WriterImpl(const Type& type, OutputStream* stream, const WriterOptions& options);
 
+    ~WriterImpl() override;
+
     std::unique_ptr<ColumnVectorBatch> createRowBatch(uint64_t size) const override;
 
     void add(ColumnVectorBatch& rowsToAdd) override;
@@ -353,6 +432,10 @@ namespace orc {
     void init();
     void initStripe();
     void writeStripe();
+    void writeStripeInBackground();
+    void flushStripe(ColumnWriter& columnWriter, uint64_t stripeRows, uint64_t indexRows);
+    void finishOldestStripe();
+    void finishPendingStripes();
     void writeMetadata();
     void writeFileFooter();
     void writePostscript();
@@ -366,8 +449,24 @@ namespace orc {
 
   WriterImpl::WriterImpl(const Type& t, OutputStream* stream, const WriterOptions& opts)
       : outStream_(stream), options_(opts), type_(t) {
-    streamsFactory_ = createStreamsFactory(options_, outStream_);
+    compressorPool_ = createCompressorPool(*options_.getMemoryPool());
+    if (options_.getCompression() != CompressionKind_NONE && options_.getCompressionThreads() > 1) {
+      IOExecutorOptions executorOptions;
+      executorOptions.numThreads = options_.getCompressionThreads();
+      // bounds the blocks waiting for a thread and thus their memory
+      executorOptions.maxQueueSize = 2 * options_.getCompressionThreads();
+      compressionExecutor_ = createIOExecutor(executorOptions);
+    }
+    streamsFactory_ =
+        createStreamsFactory(options_, outStream_, compressorPool_, compressionExecutor_.get());
     columnWriter_ = buildWriter(type_, *streamsFactory_, options_);
+    fileStatsWriter_ = columnWriter_.get();
+    if (options_.getMaxPendingStripes() > 0) {
+      IOExecutorOptions executorOptions;
+      executorOptions.numThreads = 1;
+      executorOptions.maxQueueSize = options_.getMaxPendingStripes();
+      stripeExecutor_ = createIOExecutor(executorOptions);
+    }
     stripeRows_ = totalRows_ = indexRows_ = 0;
     currentOffset_ = 0;
     stripesAtLastFlush_ = 0;
@@ -384,7 +483,8 @@ namespace orc {
     compressionStream_ = createCompressor(
         options_.getCompression(), outStream_, options_.getCompressionStrategy(),
         options_.getOutputBufferCapacity(), options_.getCompressionBlockSize(),
-        options_.getMemoryBlockSize(), *options_.getMemoryPool(), options_.getWriterMetrics());
+        options_.getMemoryBlockSize(), *options_.getMemoryPool(), options_.getWriterMetrics(),
+        compressorPool_);
 
     // uncompressed stream for post script
     bufferedStream_.reset(new BufferedOutputStream(*options_.getMemoryPool(), outStream_,
@@ -395,6 +495,13 @@ namespace orc {
     init();
   }
 
+  WriterImpl::~WriterImpl() {
+    // stripes still being written use the members of the writer
+    for (auto& stripe : pendingStripes_) {
+      stripe.done.wait();
+    }
+  }
+
   std::unique_ptr<ColumnVectorBatch> WriterImpl::createRowBatch(uint64_t size) const {
     return type_.createRowBatch(size, *options_.getMemoryPool(), false, useTightNumericVector_);
   }
@@ -426,11 +533,16 @@ namespace orc {
     }
 
     if (columnWriter_->getEstimatedSize() >= options_.getStripeSize()) {
-      writeStripe();
+      if (stripeExecutor_) {
+        writeStripeInBackground();
+      } else {
+        writeStripe();
+      }
     }
   }
 
   void WriterImpl::close() {
+    finishPendingStripes();
     if (stripeRows_ > 0) {
       writeStripe();
     }
@@ -441,6 +553,7 @@ namespace orc {
   }
 
   uint64_t WriterImpl::writeIntermediateFooter() {
+    finishPendingStripes();
     if (stripeRows_ > 0) {
       writeStripe();
     }
@@ -451,14 +564,15 @@ namespace orc {
       stripesAtLastFlush_ = fileFooter_.stripes_size();
       outStream_->flush();
       lastFlushOffset_ = outStream_->getLength();
+      // the next stripe starts after the footer
       currentOffset_ = lastFlushOffset_;
-      // init stripe now that we adjusted the currentOffset
-      initStripe();
     }
     return lastFlushOffset_;
   }
 
   void WriterImpl::addUserMetadata(const std::string& name, const std::string& value) {
+    // pending stripes add themselves to the footer
+    finishPendingStripes();
     proto::UserMetadataItem* userMetadataItem = fileFooter_.add_metadata();
     userMetadataItem->set_name(name);
     userMetadataItem->set_value(value);
@@ -500,33 +614,74 @@ namespace orc {
   }
 
   void WriterImpl::initStripe() {
-    stripeInfo_.set_offset(currentOffset_);
-    stripeInfo_.set_index_length(0);
-    stripeInfo_.set_data_length(0);
-    stripeInfo_.set_footer_length(0);
-    stripeInfo_.set_number_of_rows(0);
-
     stripeRows_ = indexRows_ = 0;
   }
 
   void WriterImpl::writeStripe() {
-    if (options_.getEnableIndex() && indexRows_ != 0) {
-      columnWriter_->createRowIndexEntry();
-      indexRows_ = 0;
+    flushStripe(*columnWriter_, stripeRows_, indexRows_);
+    initStripe();
+  }
+
+  void WriterImpl::writeStripeInBackground() {
+    if (pendingStripes_.size() >= options_.getMaxPendingStripes()) {
+      finishOldestStripe();
+    }
+    // the encodings are decided on the first stripe, as when writing on
+    // this thread, and the other column writers take them over
+    columnWriter_->finishDictionaryCheck(nullptr);
+    ColumnWriter* columnWriter = columnWriter_.get();
+    uint64_t stripeRows = stripeRows_;
+    uint64_t indexRows = indexRows_;
+    PendingStripe stripe;
+    stripe.done = stripeExecutor_->submit(this, [this, columnWriter, stripeRows, indexRows] {
+      flushStripe(*columnWriter, stripeRows, indexRows);
+    });
+    stripe.columnWriter = std::move(columnWriter_);
+    pendingStripes_.push_back(std::move(stripe));
+
+    // continue with a column writer whose stripe has been written
+    if (idleColumnWriters_.empty()) {
+      columnWriter_ = buildWriter(type_, *streamsFactory_, options_);
+      columnWriter_->finishDictionaryCheck(fileStatsWriter_);
     } else {
-      columnWriter_->mergeRowGroupStatsIntoStripeStats();
+      columnWriter_ = std::move(idleColumnWriters_.back());
+      idleColumnWriters_.pop_back();
+    }
+    initStripe();
+  }
+
+  void WriterImpl::finishOldestStripe() {
+    PendingStripe stripe = std::move(pendingStripes_.front());
+    pendingStripes_.pop_front();
+    // rethrows the error of a failed stripe
+    stripe.done.get();
+    idleColumnWriters_.push_back(std::move(stripe.columnWriter));
+  }
+
+  void WriterImpl::finishPendingStripes() {
+    while (!pendingStripes_.empty()) {
+      finishOldestStripe();
+    }
+  }
+
+  void WriterImpl::flushStripe(ColumnWriter& columnWriter, uint64_t stripeRows,
+                               uint64_t indexRows) {
+    if (options_.getEnableIndex() && indexRows != 0) {
+      columnWriter.createRowIndexEntry();
+    } else {
+      columnWriter.mergeRowGroupStatsIntoStripeStats();
     }
 
     // dictionary should be written before any stream is flushed
-    columnWriter_->writeDictionary();
+    columnWriter.writeDictionary();
 
     std::vector<proto::Stream> streams;
     // write ROW_INDEX streams
     if (options_.getEnableIndex()) {
-      columnWriter_->writeIndex(streams);
+      columnWriter.writeIndex(streams);
     }
     // write streams like PRESENT, DATA, etc.
-    columnWriter_->flush(streams);
+    columnWriter.flush(streams);
 
     // generate and write stripe footer
     proto::StripeFooter stripeFooter;
@@ -535,7 +690,7 @@ namespace orc {
     }
 
     std::vector<proto::ColumnEncoding> encodings;
-    columnWriter_->getColumnEncoding(encodings);
+    columnWriter.getColumnEncoding(encodings);
 
     for (uint32_t i = 0; i < encodings.size(); ++i) {
       *stripeFooter.add_columns() = encodings[i];
@@ -546,12 +701,12 @@ namespace orc {
     // add stripe statistics to metadata
     proto::StripeStatistics* stripeStats = metadata_.add_stripe_stats();
     std::vector<proto::ColumnStatistics> colStats;
-    columnWriter_->getStripeStatistics(colStats);
+    columnWriter.getStripeStatistics(colStats);
     for (uint32_t i = 0; i != colStats.size(); ++i) {
       *stripeStats->add_col_stats() = colStats[i];
     }
     // merge stripe stats into file stats and clear stripe stats
-    columnWriter_->mergeStripeStatsIntoFileStats();
+    columnWriter.mergeStripeStatsIntoFileStats(*fileStatsWriter_);
 
     if (!stripeFooter.SerializeToZeroCopyStream(compressionStream_.get())) {
       throw std::logic_error("Failed to write stripe footer.");
@@ -571,19 +726,17 @@ namespace orc {
     }
 
     // update stripe info
-    stripeInfo_.set_index_length(indexLength);
-    stripeInfo_.set_data_length(dataLength);
-    stripeInfo_.set_footer_length(footerLength);
-    stripeInfo_.set_number_of_rows(stripeRows_);
-
-    *fileFooter_.add_stripes() = stripeInfo_;
+    proto::StripeInformation* stripeInfo = fileFooter_.add_stripes();
+    stripeInfo->set_offset(currentOffset_);
+    stripeInfo->set_index_length(indexLength);
+    stripeInfo->set_data_length(dataLength);
+    stripeInfo->set_footer_length(footerLength);
+    stripeInfo->set_number_of_rows(stripeRows);
 
     currentOffset_ = currentOffset_ + indexLength + dataLength + footerLength;
-    totalRows_ += stripeRows_;
-
-    columnWriter_->reset();
+    totalRows_ += stripeRows;
 
-    initStripe();
+    columnWriter.reset();
   }
 
   void WriterImpl::writeMetadata() {
@@ -599,7 +752,7 @@ namespace orc {
 
     // update file statistics
     std::vector<proto::ColumnStatistics> colStats;
-    columnWriter_->getFileStatistics(colStats);
+    fileStatsWriter_->getFileStatistics(colStats);
     fileFooter_.clear_statistics();
     for (uint32_t i = 0; i != colStats.size(); ++i) {
       *fileFooter_.add_statistics() = colStats[i];
@@ -0,0 +1,366 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "AsyncFileReader.hh"
+#include "Adaptor.hh"
+#include "orc/Exceptions.hh"
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+#ifdef HAS_IO_URING
+#include <errno.h>
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#endif
+
+#ifndef _MSC_VER
+#include <unistd.h>
+#endif
+
+namespace orc {
+
+#ifdef HAS_IO_URING
+
+  /**
+   * A minimal io_uring driver built directly on the kernel interface so that
+   * no extra library is required. Reads are submitted by the calling thread
+   * and reaped by a single completion thread that fulfills the promises.
+   */
+  class IoUringFileReader : public AsyncFileReader {
+   private:
+    struct Request {
+      struct iovec iov;
+      uint64_t offset;
+      std::promise<void> promise;
+    };
+
+    int fd_;
+    std::string name_;
+    ReaderMetrics* metrics_;
+    int ringFd_;
+
+    void* sqRing_;
+    size_t sqRingSize_;
+    void* cqRing_;
+    size_t cqRingSize_;
+    struct io_uring_sqe* sqes_;
+    size_t sqesSize_;
+
+    unsigned* sqTail_;
+    unsigned* sqMask_;
+    unsigned* sqArray_;
+    unsigned sqEntries_;
+    unsigned* cqHead_;
+    unsigned* cqTail_;
+    unsigned* cqMask_;
+    struct io_uring_cqe* cqes_;
+
+    // protects the submission queue and the in-flight accounting
+    std::mutex mutex_;
+    std::condition_variable slotAvailable_;
+    uint32_t inflight_;
+    // the requests owned by the ring until they complete
+    std::unordered_set<Request*> requests_;
+    bool stopping_;
+    // set once the completion thread gave up on the ring
+    bool failed_;
+    std::thread completionThread_;
+
+    IoUringFileReader(int fd, std::string name, ReaderMetrics* metrics)
+        : fd_(fd),
+          name_(std::move(name)),
+          metrics_(metrics),
+          ringFd_(-1),
+          sqRing_(MAP_FAILED),
+          sqRingSize_(0),
+          cqRing_(MAP_FAILED),
+          cqRingSize_(0),
+          sqes_(static_cast<struct io_uring_sqe*>(MAP_FAILED)),
+          sqesSize_(0),
+          inflight_(0),
+          stopping_(false),
+          failed_(false) {}
+
+    bool setup(uint32_t queueDepth) {
+      struct io_uring_params params;
+      memset(&params, 0, sizeof(params));
+      ringFd_ = static_cast<int>(syscall(__NR_io_uring_setup, std::max(queueDepth, 1u), &params));
+      if (ringFd_ < 0) {
+        return false;
+      }
+      sqRingSize_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+      cqRingSize_ = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+      bool singleMmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+      if (singleMmap) {
+        sqRingSize_ = cqRingSize_ = std::max(sqRingSize_, cqRingSize_);
+      }
+      sqRing_ = mmap(nullptr, sqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                     ringFd_, IORING_OFF_SQ_RING);
+      if (sqRing_ == MAP_FAILED) {
+        return false;
+      }
+      if (singleMmap) {
+        cqRing_ = sqRing_;
+      } else {
+        cqRing_ = mmap(nullptr, cqRingSize_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE,
+                       ringFd_, IORING_OFF_CQ_RING);
+        if (cqRing_ == MAP_FAILED) {
+          return false;
+        }
+      }
+      sqesSize_ = params.sq_entries * sizeof(struct io_uring_sqe);
+      sqes_ = static_cast<struct io_uring_sqe*>(mmap(nullptr, sqesSize_, PROT_READ | PROT_WRITE,
+                                                     MAP_SHARED | MAP_POPULATE, ringFd_,
+                                                     IORING_OFF_SQES));
+      if (sqes_ == MAP_FAILED) {
+        return false;
+      }
+
+      char* sq = static_cast<char*>(sqRing_);
+      sqTail_ = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+      sqMask_ = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+      sqArray_ = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+      sqEntries_ = params.sq_entries;
+      char* cq = static_cast<char*>(cqRing_);
+      cqHead_ = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+      cqTail_ = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+      cqMask_ = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+      cqes_ = reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+
+      completionThread_ = std::thread([this] { reap(); });
+      return true;
+    }
+
+    // Push one entry into the submission queue. Caller holds mutex_. If the
+    // kernel rejects it, the entry is taken back and ParseError is thrown.
+    void push(uint8_t opcode, Request* request) {
+      unsigned tail = *sqTail_;
+      unsigned index = tail & *sqMask_;
+      struct io_uring_sqe* sqe = &sqes_[index];
+      memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = opcode;
+      sqe->user_data = reinterpret_cast<uint64_t>(request);
+      if (request != nullptr) {
+        sqe->fd = fd_;
+        sqe->off = request->offset;
+        sqe->addr = reinterpret_cast<uint64_t>(&request->iov);
+        sqe->len = 1;
+      }
+      sqArray_[index] = index;
+      __atomic_store_n(sqTail_, tail + 1, __ATOMIC_RELEASE);
+      int ret;
+      do {
+        ret = static_cast<int>(syscall(__NR_io_uring_enter, ringFd_, 1, 0, 0, nullptr, 0));
+      } while (ret < 0 && (errno == EINTR || errno == EAGAIN));
+      if (ret < 0) {
+        // nothing was consumed, so the entry must not be submitted later
+        __atomic_store_n(sqTail_, tail, __ATOMIC_RELEASE);
+        throw ParseError("Failed to submit read of " + name_);
+      }
+    }
+
+    // Fulfill the promise of a request and free its slot.
+    void finish(Request* request, std::exception_ptr error) {
+      if (error) {
+        request->promise.set_exception(error);
+      } else {
+        if (metrics_) {
+          metrics_->IOCount.fetch_add(1);
+        }
+        request->promise.set_value();
+      }
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        requests_.erase(request);
+        --inflight_;
+      }
+      delete request;
+      slotAvailable_.notify_all();
+    }
+
+    // Submit the rest of a request again. It runs on the completion thread,
+    // so a rejected submission fails the request instead of throwing.
+    void resubmit(Request* request) {
+      try {
+        std::lock_guard<std::mutex> lock(mutex_);
+        push(IORING_OP_READV, request);
+      } catch (const ParseError&) {
+        finish(request, std::current_exception());
+      }
+    }
+
+    void complete(Request* request, int result) {
+      if (result == -EINTR || result == -EAGAIN) {
+        resubmit(request);
+      } else if (result > 0 && static_cast<size_t>(result) < request->iov.iov_len) {
+        // short read: resubmit the remainder
+        request->iov.iov_base = static_cast<char*>(request->iov.iov_base) + result;
+        request->iov.iov_len -= static_cast<size_t>(result);
+        request->offset += static_cast<uint64_t>(result);
+        resubmit(request);
+      } else if (result < 0) {
+        finish(request, std::make_exception_ptr(ParseError("Bad read of " + name_)));
+      } else if (result == 0 && request->iov.iov_len > 0) {
+        finish(request, std::make_exception_ptr(ParseError("Short read of " + name_)));
+      } else {
+        finish(request, nullptr);
+      }
+    }
+
+    // Fail every outstanding request once no completion can be reaped
+    // anymore, so that neither the readers nor the destructor wait forever.
+    void failAll() {
+      std::unordered_set<Request*> requests;
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        failed_ = true;
+        requests.swap(requests_);
+        inflight_ = 0;
+      }
+      for (Request* request : requests) {
+        request->promise.set_exception(
+            std::make_exception_ptr(ParseError("Failed to wait for reads of " + name_)));
+        delete request;
+      }
+      slotAvailable_.notify_all();
+    }
+
+    void reap() {
+      while (true) {
+        int ret = static_cast<int>(
+            syscall(__NR_io_uring_enter, ringFd_, 0, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (ret < 0 && errno != EINTR) {
+          failAll();
+          return;
+        }
+        unsigned head = *cqHead_;
+        unsigned tail = __atomic_load_n(cqTail_, __ATOMIC_ACQUIRE);
+        bool wakeup = false;
+        for (; head != tail; ++head) {
+          const struct io_uring_cqe& cqe = cqes_[head & *cqMask_];
+          if (cqe.user_data == 0) {
+            wakeup = true;
+          } else {
+            complete(reinterpret_cast<Request*>(cqe.user_data), cqe.res);
+          }
+        }
+        __atomic_store_n(cqHead_, head, __ATOMIC_RELEASE);
+        if (wakeup) {
+          std::lock_guard<std::mutex> lock(mutex_);
+          if (stopping_ && inflight_ == 0) {
+            return;
+          }
+        }
+      }
+    }
+
+   public:
+    static std::unique_ptr<AsyncFileReader> create(int fd, const std::string& name,
+                                                   uint32_t queueDepth, ReaderMetrics* metrics) {
+      std::unique_ptr<IoUringFileReader> reader(new IoUringFileReader(fd, name, metrics));
+      if (!reader->setup(queueDepth)) {
+        return nullptr;
+      }
+      return reader;
+    }
+
+    ~IoUringFileReader() override {
+      if (completionThread_.joinable()) {
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          stopping_ = true;
+          slotAvailable_.wait(lock, [this] { return inflight_ == 0; });
+          if (!failed_) {
+            // a NOP without request wakes the completion thread up for exit
+            try {
+              push(IORING_OP_NOP, nullptr);
+            } catch (const ParseError&) {
+              // the thread stays blocked in the kernel and never touches the
+              // ring again, so leave it behind rather than hang here
+              completionThread_.detach();
+            }
+          }
+        }
+        if (completionThread_.joinable()) {
+          completionThread_.join();
+        }
+      }
+      if (sqes_ != MAP_FAILED) {
+        munmap(sqes_, sqesSize_);
+      }
+      if (cqRing_ != MAP_FAILED && cqRing_ != sqRing_) {
+        munmap(cqRing_, cqRingSize_);
+      }
+      if (sqRing_ != MAP_FAILED) {
+        munmap(sqRing_, sqRingSize_);
+      }
+      if (ringFd_ >= 0) {
+        close(ringFd_);
+      }
+    }
+
+    std::future<void> submit(void* buf, uint64_t length, uint64_t offset) override {
+      auto request = std::make_unique<Request>();
+      request->iov.iov_base = buf;
+      request->iov.iov_len = length;
+      request->offset = offset;
+      std::future<void> future = request->promise.get_future();
+      if (length == 0) {
+        request->promise.set_value();
+        return future;
+      }
+      std::unique_lock<std::mutex> lock(mutex_);
+      // The completion queue is twice as large as the submission queue, so
+      // bounding in-flight reads by the latter never overflows completions.
+      slotAvailable_.wait(lock, [this] { return failed_ || inflight_ < sqEntries_; });
+      if (failed_) {
+        request->promise.set_exception(
+            std::make_exception_ptr(ParseError("Failed to wait for reads of " + name_)));
+        return future;
+      }
+      // the ring only owns the request once the kernel accepted it
+      push(IORING_OP_READV, request.get());
+      ++inflight_;
+      requests_.insert(request.release());
+      return future;
+    }
+  };
+
+  std::unique_ptr<AsyncFileReader> createIoUringFileReader(int fd, const std::string& name,
+                                                           uint32_t queueDepth,
+                                                           ReaderMetrics* metrics) {
+    return IoUringFileReader::create(fd, name, queueDepth, metrics);
+  }
+
+#else
+
+  std::unique_ptr<AsyncFileReader> createIoUringFileReader(int, const std::string&, uint32_t,
+                                                           ReaderMetrics*) {
+    return nullptr;
+  }
+
+#endif
+
+}  // namespace orc
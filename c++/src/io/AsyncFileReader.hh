@@ -0,0 +1,52 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "orc/OrcFile.hh"
+
+#include <future>
+#include <memory>
+#include <string>
+
+namespace orc {
+
+  /**
+   * Services asynchronous positional reads against an open file descriptor.
+   * The descriptor is owned by the caller and must outlive the reader.
+   */
+  class AsyncFileReader {
+   public:
+    virtual ~AsyncFileReader() = default;
+
+    /**
+     * Read length bytes at offset into buf. The returned future is set once
+     * all bytes have been read, or holds a ParseError if the read failed.
+     */
+    virtual std::future<void> submit(void* buf, uint64_t length, uint64_t offset) = 0;
+  };
+
+  /**
+   * Create a reader backed by an io_uring instance.
+   * @return nullptr if io_uring is not supported by the build or the kernel
+   */
+  std::unique_ptr<AsyncFileReader> createIoUringFileReader(int fd, const std::string& name,
+                                                           uint32_t queueDepth,
+                                                           ReaderMetrics* metrics);
+
+}  // namespace orc
@@ -17,6 +17,7 @@
  */
 
 #include <cassert>
+#include <iterator>
 
 #include "Cache.hh"
 
@@ -114,7 +115,9 @@ namespace orc {
     ranges = ReadRangeCombiner::coalesceReadRanges(std::move(ranges), options_.holeSizeLimit,
                                                    options_.rangeSizeLimit);
 
+    // issuing the reads may block on a full I/O queue, so do it before locking
     std::vector<RangeCacheEntry> newEntries = makeCacheEntries(ranges);
+    std::lock_guard<std::mutex> lock(mutex_);
     // Add new entries, themselves ordered by offset
     if (entries_.size() > 0) {
       std::vector<RangeCacheEntry> merged(entries_.size() + newEntries.size());
@@ -126,23 +129,62 @@ namespace orc {
     }
   }
 
-  BufferSlice ReadRangeCache::read(const ReadRange& range) {
+  BufferSlice ReadRangeCache::read(const ReadRange& range, bool countMiss) {
     if (range.length == 0) {
       return {std::make_shared<Buffer>(*memoryPool_, 0), 0, 0};
     }
 
-    const auto it = std::lower_bound(entries_.begin(), entries_.end(), range,
-                                     [](const RangeCacheEntry& entry, const ReadRange& range) {
-                                       return entry.range.offset + entry.range.length <
-                                              range.offset + range.length;
-                                     });
+    RangeCacheEntry entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = std::lower_bound(entries_.begin(), entries_.end(), range,
+                                       [](const RangeCacheEntry& entry, const ReadRange& range) {
+                                         return entry.range.offset + entry.range.length <
+                                                range.offset + range.length;
+                                       });
+      if (it != entries_.end() && it->range.contains(range)) {
+        entry = *it;
+      }
+    }
+
+    BufferSlice result{};
+    bool hit_cache = false;
+    if (entry.buffer) {
+      hit_cache = entry.future.valid();
+      entry.future.get();
+      result = BufferSlice{entry.buffer, range.offset - entry.range.offset, range.length};
+    }
+
+    if (metrics_) {
+      if (hit_cache)
+        metrics_->ReadRangeCacheHits.fetch_add(1);
+      else if (countMiss)
+        metrics_->ReadRangeCacheMisses.fetch_add(1);
+    }
+    return result;
+  }
+
+  BufferSlice ReadRangeCache::readFrom(uint64_t offset, uint64_t maxLength) {
+    RangeCacheEntry entry;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      const auto it = std::upper_bound(entries_.begin(), entries_.end(), offset,
+                                       [](uint64_t offset, const RangeCacheEntry& entry) {
+                                         return offset < entry.range.offset + entry.range.length;
+                                       });
+      if (it != entries_.end() && it->range.offset <= offset && maxLength > 0) {
+        entry = *it;
+      }
+    }
 
     BufferSlice result{};
     bool hit_cache = false;
-    if (it != entries_.end() && it->range.contains(range)) {
-      hit_cache = it->future.valid();
-      it->future.get();
-      result = BufferSlice{it->buffer, range.offset - it->range.offset, range.length};
+    if (entry.buffer) {
+      hit_cache = entry.future.valid();
+      entry.future.get();
+      uint64_t sliceOffset = offset - entry.range.offset;
+      result = BufferSlice{entry.buffer, sliceOffset,
+                           std::min(maxLength, entry.range.length - sliceOffset)};
     }
 
     if (metrics_) {
@@ -155,14 +197,20 @@ namespace orc {
   }
 
   void ReadRangeCache::evictEntriesBefore(uint64_t boundary) {
-    auto it = std::lower_bound(entries_.begin(), entries_.end(), boundary,
-                               [](const RangeCacheEntry& entry, uint64_t offset) {
-                                 return entry.range.offset + entry.range.length <= offset;
-                               });
-    for (auto iter = entries_.begin(); iter != it; ++iter) {
-      iter->future.wait();
-    }
-    entries_.erase(entries_.begin(), it);
+    std::vector<RangeCacheEntry> evicted;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto it = std::lower_bound(entries_.begin(), entries_.end(), boundary,
+                                 [](const RangeCacheEntry& entry, uint64_t offset) {
+                                   return entry.range.offset + entry.range.length <= offset;
+                                 });
+      evicted.assign(std::make_move_iterator(entries_.begin()), std::make_move_iterator(it));
+      entries_.erase(entries_.begin(), it);
+    }
+    // pending reads still write into the evicted buffers
+    for (auto& entry : evicted) {
+      entry.future.wait();
+    }
   }
 
   std::vector<RangeCacheEntry> ReadRangeCache::makeCacheEntries(
@@ -171,7 +219,8 @@ namespace orc {
     newEntries.reserve(ranges.size());
     for (const auto& range : ranges) {
       BufferPtr buffer = std::make_shared<Buffer>(*memoryPool_, range.length);
-      std::future<void> future = stream_->readAsync(buffer->data(), buffer->size(), range.offset);
+      std::future<void> future =
+          stream_->readAsync(buffer->data(), buffer->size(), range.offset, metrics_);
       newEntries.emplace_back(range, std::move(buffer), std::move(future));
     }
     return newEntries;
@@ -25,6 +25,7 @@
 #include <cassert>
 #include <cstdint>
 #include <future>
+#include <mutex>
 #include <utility>
 #include <vector>
 
@@ -84,6 +85,7 @@ namespace orc {
   };
 
   /// A read cache designed to hide IO latencies when reading.
+  /// It may be shared by readers running on different threads.
   class ReadRangeCache {
    public:
     /// Construct a read cache with given options
@@ -103,7 +105,13 @@ namespace orc {
     void cache(std::vector<ReadRange> ranges);
 
     /// Read a range previously given to Cache().
-    BufferSlice read(const ReadRange& range);
+    /// Set countMiss to false if the caller falls back to readFrom(), which
+    /// counts the misses of the parts it does not find.
+    BufferSlice read(const ReadRange& range, bool countMiss = true);
+
+    /// Read up to maxLength bytes starting at offset out of the cached range
+    /// that contains offset. Returns an empty slice if no cached range does.
+    BufferSlice readFrom(uint64_t offset, uint64_t maxLength);
 
     /// Evict cache entries with its range before given boundary.
     void evictEntriesBefore(uint64_t boundary);
@@ -113,6 +121,8 @@ namespace orc {
 
     InputStream* stream_;
     CacheOptions options_;
+    // protects entries_; never held while waiting for a read
+    std::mutex mutex_;
     // Ordered by offset (so as to find a matching region by binary search)
     std::vector<RangeCacheEntry> entries_;
     MemoryPool* memoryPool_;
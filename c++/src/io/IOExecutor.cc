@@ -0,0 +1,174 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "orc/IOExecutor.hh"
+#include "orc/Reader.hh"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace orc {
+
+  IOExecutor::~IOExecutor() {
+    // PASS
+  }
+
+  class IOExecutorImpl : public IOExecutor {
+   private:
+    struct Task {
+      std::packaged_task<void()> task;
+      ReaderMetrics* metrics;
+      std::chrono::steady_clock::time_point enqueueTime;
+    };
+
+    uint64_t maxQueueSize_;
+    std::mutex mutex_;
+    std::condition_variable taskAvailable_;
+    std::condition_variable spaceAvailable_;
+    // pending tasks of each client
+    std::unordered_map<const void*, std::deque<Task>> queues_;
+    // clients with pending tasks in the order they are served
+    std::deque<const void*> clients_;
+    uint64_t queueSize_;
+    bool stopping_;
+    std::vector<std::thread> workers_;
+
+    void run() {
+      while (true) {
+        Task task;
+        {
+          std::unique_lock<std::mutex> lock(mutex_);
+          taskAvailable_.wait(lock, [this] { return stopping_ || !clients_.empty(); });
+          if (clients_.empty()) {
+            return;
+          }
+          const void* client = clients_.front();
+          clients_.pop_front();
+          auto queue = queues_.find(client);
+          task = std::move(queue->second.front());
+          queue->second.pop_front();
+          if (queue->second.empty()) {
+            queues_.erase(queue);
+          } else {
+            // move the client to the back so that others get their turn
+            clients_.push_back(client);
+          }
+          --queueSize_;
+        }
+        spaceAvailable_.notify_one();
+        if (task.metrics) {
+          auto waitTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                              std::chrono::steady_clock::now() - task.enqueueTime)
+                              .count();
+          task.metrics->IOQueueWaitCount.fetch_add(1);
+          task.metrics->IOQueueWaitLatencyUs.fetch_add(static_cast<uint64_t>(waitTime));
+        }
+        task.task();
+      }
+    }
+
+   public:
+    explicit IOExecutorImpl(const IOExecutorOptions& options)
+        : maxQueueSize_(std::max<uint64_t>(options.maxQueueSize, 1)),
+          queueSize_(0),
+          stopping_(false) {
+      uint32_t numThreads = std::max(options.numThreads, 1u);
+      workers_.reserve(numThreads);
+      for (uint32_t i = 0; i < numThreads; ++i) {
+        workers_.emplace_back([this] { run(); });
+      }
+    }
+
+    ~IOExecutorImpl() override {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+      }
+      taskAvailable_.notify_all();
+      for (auto& worker : workers_) {
+        worker.join();
+      }
+    }
+
+    std::future<void> submit(const void* client, std::function<void()> task,
+                             ReaderMetrics* metrics) override {
+      std::packaged_task<void()> packagedTask(std::move(task));
+      std::future<void> future = packagedTask.get_future();
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        spaceAvailable_.wait(lock, [this] { return queueSize_ < maxQueueSize_; });
+        std::deque<Task>& queue = queues_[client];
+        if (queue.empty()) {
+          clients_.push_back(client);
+        }
+        queue.push_back(Task{std::move(packagedTask), metrics, std::chrono::steady_clock::now()});
+        ++queueSize_;
+      }
+      taskAvailable_.notify_one();
+      return future;
+    }
+  };
+
+  std::unique_ptr<IOExecutor> createIOExecutor(const IOExecutorOptions& options) {
+    return std::make_unique<IOExecutorImpl>(options);
+  }
+
+#ifdef __clang__
+#pragma clang diagnostic ignored "-Wexit-time-destructors"
+#endif
+
+  namespace {
+    struct DefaultIOExecutorState {
+      std::mutex mutex;
+      IOExecutorOptions options;
+      bool created = false;
+    };
+
+    DefaultIOExecutorState& getDefaultIOExecutorState() {
+      static DefaultIOExecutorState state;
+      return state;
+    }
+  }  // namespace
+
+  void setDefaultIOExecutorOptions(const IOExecutorOptions& options) {
+    DefaultIOExecutorState& state = getDefaultIOExecutorState();
+    std::lock_guard<std::mutex> lock(state.mutex);
+    if (state.created) {
+      throw std::logic_error("The default IOExecutor has already been created");
+    }
+    state.options = options;
+  }
+
+  IOExecutor* getDefaultIOExecutor() {
+    static std::unique_ptr<IOExecutor> internal = [] {
+      DefaultIOExecutorState& state = getDefaultIOExecutorState();
+      std::lock_guard<std::mutex> lock(state.mutex);
+      state.created = true;
+      return createIOExecutor(state.options);
+    }();
+    return internal.get();
+  }
+
+}  // namespace orc
@@ -17,6 +17,7 @@
  */
 
 #include "InputStream.hh"
+#include "Cache.hh"
 #include "orc/Exceptions.hh"
 
 #include <algorithm>
@@ -56,6 +57,10 @@ namespace orc {
     // PASS
   }
 
+  bool SeekableInputStream::hasStableBuffers() const {
+    return false;
+  }
+
   SeekableArrayInputStream::~SeekableArrayInputStream() {
     // PASS
   }
@@ -132,15 +137,26 @@ namespace orc {
 
   SeekableFileInputStream::SeekableFileInputStream(InputStream* stream, uint64_t offset,
                                                    uint64_t byteCount, MemoryPool& pool,
-                                                   uint64_t blockSize)
+                                                   uint64_t blockSize,
+                                                   std::shared_ptr<ReadRangeCache> cache)
       : pool_(pool),
         input_(stream),
         start_(offset),
         length_(byteCount),
-        blockSize_(computeBlock(blockSize, length_)) {
+        blockSize_(computeBlock(blockSize, length_)),
+        cache_(std::move(cache)) {
+    block_ = nullptr;
+    blockLength_ = 0;
     position_ = 0;
     buffer_.reset(new DataBuffer<char>(pool_));
     pushBack_ = 0;
+    mapped_ = input_->getMappedData();
+    if (mapped_) {
+      if (start_ > input_->getLength() || length_ > input_->getLength() - start_) {
+        throw ParseError("Short read of " + input_->getName());
+      }
+      mapped_ += start_;
+    }
   }
 
   SeekableFileInputStream::~SeekableFileInputStream() {
@@ -150,15 +166,30 @@ namespace orc {
   bool SeekableFileInputStream::Next(const void** data, int* size) {
     uint64_t bytesRead;
     if (pushBack_ != 0) {
-      *data = buffer_->data() + (buffer_->size() - pushBack_);
+      *data = block_ + (blockLength_ - pushBack_);
       bytesRead = pushBack_;
     } else {
       bytesRead = std::min(length_ - position_, blockSize_);
-      buffer_->resize(bytesRead);
       if (bytesRead > 0) {
-        input_->read(buffer_->data(), bytesRead, start_ + position_);
-        *data = static_cast<void*>(buffer_->data());
+        BufferSlice slice;
+        if (!mapped_ && cache_) {
+          slice = cache_->readFrom(start_ + position_, bytesRead);
+        }
+        if (mapped_) {
+          block_ = mapped_ + position_;
+        } else if (slice.buffer) {
+          // prefetched ranges may end before the block does
+          cachedBuffer_ = slice.buffer;
+          block_ = slice.buffer->data() + slice.offset;
+          bytesRead = slice.length;
+        } else {
+          buffer_->resize(bytesRead);
+          input_->read(buffer_->data(), bytesRead, start_ + position_);
+          block_ = buffer_->data();
+        }
+        *data = static_cast<const void*>(block_);
       }
+      blockLength_ = bytesRead;
     }
     position_ += bytesRead;
     pushBack_ = 0;
@@ -174,7 +205,7 @@ namespace orc {
     if (pushBack_ > 0) {
       throw std::logic_error("can't backup unless we just called Next");
     }
-    if (count > blockSize_ || count > position_) {
+    if (count > blockLength_ || count > position_) {
       throw std::logic_error("can't backup that far");
     }
     pushBack_ = static_cast<uint64_t>(count);
@@ -208,6 +239,10 @@ namespace orc {
     pushBack_ = 0;
   }
 
+  bool SeekableFileInputStream::hasStableBuffers() const {
+    return mapped_ != nullptr;
+  }
+
   std::string SeekableFileInputStream::getName() const {
     std::ostringstream result;
     result << input_->getName() << " from " << start_ << " for " << length_;
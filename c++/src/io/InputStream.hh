@@ -31,6 +31,8 @@
 
 namespace orc {
 
+  class ReadRangeCache;
+
   void printBuffer(std::ostream& out, const char* buffer, uint64_t length);
 
   class PositionProvider {
@@ -53,6 +55,12 @@ namespace orc {
     ~SeekableInputStream() override;
     virtual void seek(PositionProvider& position) = 0;
     virtual std::string getName() const = 0;
+
+    /**
+     * Whether the buffers returned by Next() stay valid until the reader is
+     * destroyed, so that values can point into them instead of being copied.
+     */
+    virtual bool hasStableBuffers() const;
   };
 
   /**
@@ -88,12 +96,21 @@ namespace orc {
     const uint64_t length_;
     const uint64_t blockSize_;
     std::unique_ptr<DataBuffer<char> > buffer_;
+    // the range of a memory-mapped input, which is used in place of buffer_
+    const char* mapped_;
+    // prefetched parts of the input, which are used in place of buffer_
+    std::shared_ptr<ReadRangeCache> cache_;
+    std::shared_ptr<DataBuffer<char> > cachedBuffer_;
+    // the block returned by the last call to Next()
+    const char* block_;
+    uint64_t blockLength_;
     uint64_t position_;
     uint64_t pushBack_;
 
    public:
     SeekableFileInputStream(InputStream* input, uint64_t offset, uint64_t byteCount,
-                            MemoryPool& pool, uint64_t blockSize = 0);
+                            MemoryPool& pool, uint64_t blockSize = 0,
+                            std::shared_ptr<ReadRangeCache> cache = nullptr);
     virtual ~SeekableFileInputStream() override;
 
     virtual bool Next(const void** data, int* size) override;
@@ -102,6 +119,7 @@ namespace orc {
     virtual int64_t ByteCount() const override;
     virtual void seek(PositionProvider& position) override;
     virtual std::string getName() const override;
+    virtual bool hasStableBuffers() const override;
   };
 
 }  // namespace orc
@@ -87,6 +87,10 @@ namespace orc {
     return dataBuffer_->size();
   }
 
+  uint64_t BufferedOutputStream::getExactSize() {
+    return getSize();
+  }
+
   uint64_t BufferedOutputStream::flush() {
     uint64_t dataSize = dataBuffer_->size();
     // flush data buffer into outputStream
@@ -133,7 +137,7 @@ namespace orc {
   }
 
   void AppendOnlyBufferedStream::recordPosition(PositionRecorder* recorder) const {
-    uint64_t flushedSize = outStream_->getSize();
+    uint64_t flushedSize = outStream_->getExactSize();
     uint64_t unusedBufferSize = static_cast<uint64_t>(bufferLength_ - bufferOffset_);
     if (outStream_->isCompressed()) {
       // start of the compression chunk in the stream
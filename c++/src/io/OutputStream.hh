@@ -67,6 +67,10 @@ namespace orc {
 
     virtual std::string getName() const;
     virtual uint64_t getSize() const;
+    // Same as getSize(), except that it first waits for the blocks that are
+    // still being compressed by other threads, so the result can be recorded
+    // as a position. getSize() counts them by their uncompressed size.
+    virtual uint64_t getExactSize();
     virtual uint64_t flush();
     virtual void suppress();
     virtual uint64_t getRawInputBufferSize() const;
@@ -17,6 +17,7 @@
  */
 
 #include "PredicateLeaf.hh"
+#include "BloomFilter.hh"
 #include "orc/BloomFilter.hh"
 #include "orc/Common.hh"
 #include "orc/Type.hh"
@@ -34,6 +35,7 @@ namespace orc {
     literals_.emplace_back(literal);
     hashCode_ = hashCode();
     validate();
+    convertLiterals();
   }
 
   PredicateLeaf::PredicateLeaf(Operator op, PredicateDataType type, uint64_t columnId,
@@ -42,6 +44,7 @@ namespace orc {
     literals_.emplace_back(literal);
     hashCode_ = hashCode();
     validate();
+    convertLiterals();
   }
 
   PredicateLeaf::PredicateLeaf(Operator op, PredicateDataType type, const std::string& colName,
@@ -53,6 +56,7 @@ namespace orc {
         literals_(literals.begin(), literals.end()) {
     hashCode_ = hashCode();
     validate();
+    convertLiterals();
   }
 
   PredicateLeaf::PredicateLeaf(Operator op, PredicateDataType type, uint64_t columnId,
@@ -64,6 +68,7 @@ namespace orc {
         literals_(literals.begin(), literals.end()) {
     hashCode_ = hashCode();
     validate();
+    convertLiterals();
   }
 
   PredicateLeaf::PredicateLeaf(Operator op, PredicateDataType type, const std::string& colName,
@@ -75,6 +80,7 @@ namespace orc {
         literals_(literals.begin(), literals.end()) {
     hashCode_ = hashCode();
     validate();
+    convertLiterals();
   }
 
   PredicateLeaf::PredicateLeaf(Operator op, PredicateDataType type, uint64_t columnId,
@@ -86,6 +92,7 @@ namespace orc {
         literals_(literals.begin(), literals.end()) {
     hashCode_ = hashCode();
     validate();
+    convertLiterals();
   }
 
   void PredicateLeaf::validateColumn() const {
@@ -177,6 +184,10 @@ namespace orc {
     return literals_;
   }
 
+  const std::vector<int64_t>& PredicateLeaf::getBloomHashes() const {
+    return bloomHashes_;
+  }
+
   static std::string getLiteralString(const std::vector<Literal>& literals) {
     return literals.at(0).toString();
   }
@@ -445,64 +456,49 @@ namespace orc {
     }
   }
 
-  static std::vector<int64_t> literal2Long(const std::vector<Literal>& values) {
-    std::vector<int64_t> result;
-    std::for_each(values.cbegin(), values.cend(), [&](const Literal& val) {
-      if (!val.isNull()) {
-        result.emplace_back(val.getLong());
-      }
-    });
-    return result;
-  }
-
-  static std::vector<int32_t> literal2Date(const std::vector<Literal>& values) {
-    std::vector<int32_t> result;
-    std::for_each(values.cbegin(), values.cend(), [&](const Literal& val) {
-      if (!val.isNull()) {
-        result.emplace_back(val.getDate());
+  void PredicateLeaf::convertLiterals() {
+    for (const auto& literal : literals_) {
+      if (literal.isNull()) {
+        hasNullLiteral_ = true;
+        continue;
       }
-    });
-    return result;
-  }
-
-  static std::vector<Literal::Timestamp> literal2Timestamp(const std::vector<Literal>& values) {
-    std::vector<Literal::Timestamp> result;
-    std::for_each(values.cbegin(), values.cend(), [&](const Literal& val) {
-      if (!val.isNull()) {
-        result.emplace_back(val.getTimestamp());
-      }
-    });
-    return result;
-  }
-
-  static std::vector<Decimal> literal2Decimal(const std::vector<Literal>& values) {
-    std::vector<Decimal> result;
-    std::for_each(values.cbegin(), values.cend(), [&](const Literal& val) {
-      if (!val.isNull()) {
-        result.emplace_back(val.getDecimal());
-      }
-    });
-    return result;
-  }
-
-  static std::vector<double> literal2Double(const std::vector<Literal>& values) {
-    std::vector<double> result;
-    std::for_each(values.cbegin(), values.cend(), [&](const Literal& val) {
-      if (!val.isNull()) {
-        result.emplace_back(val.getFloat());
-      }
-    });
-    return result;
-  }
-
-  static std::vector<std::string> literal2String(const std::vector<Literal>& values) {
-    std::vector<std::string> result;
-    std::for_each(values.cbegin(), values.cend(), [&](const Literal& val) {
-      if (!val.isNull()) {
-        result.emplace_back(val.getString());
+      switch (type_) {
+        case PredicateDataType::LONG:
+          longLiterals_.emplace_back(literal.getLong());
+          bloomHashes_.emplace_back(BloomFilterImpl::hashLong(longLiterals_.back()));
+          break;
+        case PredicateDataType::FLOAT:
+          doubleLiterals_.emplace_back(literal.getFloat());
+          bloomHashes_.emplace_back(BloomFilterImpl::hashDouble(doubleLiterals_.back()));
+          break;
+        case PredicateDataType::STRING: {
+          stringLiterals_.emplace_back(literal.getString());
+          const std::string& str = stringLiterals_.back();
+          bloomHashes_.emplace_back(
+              BloomFilterImpl::hashBytes(str.c_str(), static_cast<int64_t>(str.size())));
+          break;
+        }
+        case PredicateDataType::DATE:
+          dateLiterals_.emplace_back(literal.getDate());
+          bloomHashes_.emplace_back(BloomFilterImpl::hashLong(dateLiterals_.back()));
+          break;
+        case PredicateDataType::TIMESTAMP:
+          timestampLiterals_.emplace_back(literal.getTimestamp());
+          bloomHashes_.emplace_back(
+              BloomFilterImpl::hashLong(timestampLiterals_.back().getMillis()));
+          break;
+        case PredicateDataType::DECIMAL: {
+          decimalLiterals_.emplace_back(literal.getDecimal());
+          std::string decimal = decimalLiterals_.back().toString(true);
+          bloomHashes_.emplace_back(
+              BloomFilterImpl::hashBytes(decimal.c_str(), static_cast<int64_t>(decimal.size())));
+          break;
+        }
+        case PredicateDataType::BOOLEAN:
+        default:
+          break;
       }
-    });
-    return result;
+    }
   }
 
   TruthValue PredicateLeaf::evaluatePredicateMinMax(const proto::ColumnStatistics& colStats) const {
@@ -512,7 +508,7 @@ namespace orc {
         if (colStats.has_int_statistics() && colStats.int_statistics().has_minimum() &&
             colStats.int_statistics().has_maximum()) {
           const auto& stats = colStats.int_statistics();
-          result = evaluatePredicateRange(operator_, literal2Long(literals_), stats.minimum(),
+          result = evaluatePredicateRange(operator_, longLiterals_, stats.minimum(),
                                           stats.maximum(), colStats.has_null());
         }
         break;
@@ -524,7 +520,7 @@ namespace orc {
           if (!std::isfinite(stats.sum())) {
             result = colStats.has_null() ? TruthValue::YES_NO_NULL : TruthValue::YES_NO;
           } else {
-            result = evaluatePredicateRange(operator_, literal2Double(literals_), stats.minimum(),
+            result = evaluatePredicateRange(operator_, doubleLiterals_, stats.minimum(),
                                             stats.maximum(), colStats.has_null());
           }
         }
@@ -535,7 +531,7 @@ namespace orc {
         if (colStats.has_string_statistics() && colStats.string_statistics().has_minimum() &&
             colStats.string_statistics().has_maximum()) {
           const auto& stats = colStats.string_statistics();
-          result = evaluatePredicateRange(operator_, literal2String(literals_), stats.minimum(),
+          result = evaluatePredicateRange(operator_, stringLiterals_, stats.minimum(),
                                           stats.maximum(), colStats.has_null());
         }
         break;
@@ -544,7 +540,7 @@ namespace orc {
         if (colStats.has_date_statistics() && colStats.date_statistics().has_minimum() &&
             colStats.date_statistics().has_maximum()) {
           const auto& stats = colStats.date_statistics();
-          result = evaluatePredicateRange(operator_, literal2Date(literals_), stats.minimum(),
+          result = evaluatePredicateRange(operator_, dateLiterals_, stats.minimum(),
                                           stats.maximum(), colStats.has_null());
         }
         break;
@@ -566,8 +562,8 @@ namespace orc {
           Literal::Timestamp maxTimestamp(
               stats.maximum_utc() / 1000,
               static_cast<int32_t>((stats.maximum_utc() % 1000) * 1000000) + maxNano);
-          result = evaluatePredicateRange(operator_, literal2Timestamp(literals_), minTimestamp,
-                                          maxTimestamp, colStats.has_null());
+          result = evaluatePredicateRange(operator_, timestampLiterals_, minTimestamp, maxTimestamp,
+                                          colStats.has_null());
         }
         break;
       }
@@ -575,9 +571,8 @@ namespace orc {
         if (colStats.has_decimal_statistics() && colStats.decimal_statistics().has_minimum() &&
             colStats.decimal_statistics().has_maximum()) {
           const auto& stats = colStats.decimal_statistics();
-          result = evaluatePredicateRange(operator_, literal2Decimal(literals_),
-                                          Decimal(stats.minimum()), Decimal(stats.maximum()),
-                                          colStats.has_null());
+          result = evaluatePredicateRange(operator_, decimalLiterals_, Decimal(stats.minimum()),
+                                          Decimal(stats.maximum()), colStats.has_null());
         }
         break;
       }
@@ -592,13 +587,8 @@ namespace orc {
     }
 
     // make sure null literal is respected for IN operator
-    if (operator_ == Operator::IN && colStats.has_null()) {
-      for (const auto& literal : literals_) {
-        if (literal.isNull()) {
-          result = TruthValue::YES_NO_NULL;
-          break;
-        }
-      }
+    if (operator_ == Operator::IN && colStats.has_null() && hasNullLiteral_) {
+      result = TruthValue::YES_NO_NULL;
     }
 
     return result;
@@ -663,7 +653,30 @@ namespace orc {
     return result;
   }
 
-  TruthValue PredicateLeaf::evaluatePredicateBloomFiter(const BloomFilter* bf, bool hasNull) const {
+  TruthValue PredicateLeaf::evaluatePredicateBloomFiter(const BloomFilter* bf, bool hasNull,
+                                                       BloomFilterProbes* probes) const {
+    const auto* filter = dynamic_cast<const BloomFilterImpl*>(bf);
+    if (filter != nullptr && type_ != PredicateDataType::BOOLEAN &&
+        (operator_ == Operator::EQUALS || operator_ == Operator::NULL_SAFE_EQUALS ||
+         operator_ == Operator::IN)) {
+      // null safe equals does not return *_NULL variant.
+      if (operator_ == Operator::NULL_SAFE_EQUALS) {
+        hasNull = false;
+      }
+      // a null literal matches the nulls of the column, as in checkInBloomFilter()
+      if (hasNull && hasNullLiteral_) {
+        return TruthValue::YES_NO_NULL;
+      }
+      // test the hashes of all literals at once
+      bool mayContain = probes != nullptr
+                            ? probes->testAny(*filter)
+                            : filter->testAnyHash(bloomHashes_.data(), bloomHashes_.size());
+      if (mayContain) {
+        return hasNull ? TruthValue::YES_NO_NULL : TruthValue::YES_NO;
+      }
+      return hasNull ? TruthValue::NO_NULL : TruthValue::NO;
+    }
+
     switch (operator_) {
       case Operator::NULL_SAFE_EQUALS:
         // null safe equals does not return *_NULL variant.
@@ -692,7 +705,8 @@ namespace orc {
 
   TruthValue PredicateLeaf::evaluate(const WriterVersion writerVersion,
                                      const proto::ColumnStatistics& colStats,
-                                     const BloomFilter* bloomFilter) const {
+                                     const BloomFilter* bloomFilter,
+                                     BloomFilterProbes* probes) const {
     // files written before ORC-135 stores timestamp wrt to local timezone
     // causing issues with PPD. disable PPD for timestamp for all old files
     if (type_ == PredicateDataType::TIMESTAMP) {
@@ -718,7 +732,7 @@ namespace orc {
 
     TruthValue result = evaluatePredicateMinMax(colStats);
     if (shouldEvaluateBloomFilter(operator_, result, bloomFilter)) {
-      return evaluatePredicateBloomFiter(bloomFilter, colStats.has_null());
+      return evaluatePredicateBloomFiter(bloomFilter, colStats.has_null(), probes);
     } else {
       return result;
     }
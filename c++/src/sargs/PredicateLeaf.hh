@@ -32,6 +32,7 @@ namespace orc {
   static constexpr uint64_t INVALID_COLUMN_ID = std::numeric_limits<uint64_t>::max();
 
   class BloomFilter;
+  class BloomFilterProbes;
 
   /**
    * The primitive predicates that form a SearchArgument.
@@ -116,11 +117,19 @@ namespace orc {
      */
     const std::vector<Literal>& getLiteralList() const;
 
+    /**
+     * Get the bloom filter hashes of the non-null literals.
+     */
+    const std::vector<int64_t>& getBloomHashes() const;
+
     /**
      * Evaluate current PredicateLeaf based on ColumnStatistics and BloomFilter
+     * @param probes if not null, the probes of getBloomHashes() reused to test
+     *        the bloom filters of many row groups
      */
     TruthValue evaluate(const WriterVersion writerVersion, const proto::ColumnStatistics& colStats,
-                        const BloomFilter* bloomFilter) const;
+                        const BloomFilter* bloomFilter,
+                        BloomFilterProbes* probes = nullptr) const;
 
     std::string toString() const;
 
@@ -135,12 +144,14 @@ namespace orc {
 
     void validate() const;
     void validateColumn() const;
+    void convertLiterals();
 
     std::string columnDebugString() const;
 
     TruthValue evaluatePredicateMinMax(const proto::ColumnStatistics& colStats) const;
 
-    TruthValue evaluatePredicateBloomFiter(const BloomFilter* bloomFilter, bool hasNull) const;
+    TruthValue evaluatePredicateBloomFiter(const BloomFilter* bloomFilter, bool hasNull,
+                                           BloomFilterProbes* probes) const;
 
    private:
     Operator operator_;
@@ -150,6 +161,20 @@ namespace orc {
     uint64_t columnId_;
     std::vector<Literal> literals_;
     size_t hashCode_;
+
+    // The non-null literals converted to the type of the leaf when it is
+    // built, so that statistics of every row group, stripe and file are
+    // compared without converting them again. Only the vector matching
+    // type_ is filled.
+    std::vector<int64_t> longLiterals_;
+    std::vector<double> doubleLiterals_;
+    std::vector<std::string> stringLiterals_;
+    std::vector<int32_t> dateLiterals_;
+    std::vector<Literal::Timestamp> timestampLiterals_;
+    std::vector<Decimal> decimalLiterals_;
+    bool hasNullLiteral_ = false;
+    // the hashes probed in bloom filters, empty for BOOLEAN leaves
+    std::vector<int64_t> bloomHashes_;
   };
 
   struct PredicateLeafHash {
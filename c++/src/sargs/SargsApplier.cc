@@ -61,12 +61,14 @@ namespace orc {
     // find the mapping from predicate leaves to columns
     const std::vector<PredicateLeaf>& leaves = sargs->getLeaves();
     filterColumns_.resize(leaves.size(), INVALID_COLUMN_ID);
+    bloomProbes_.reserve(leaves.size());
     for (size_t i = 0; i != filterColumns_.size(); ++i) {
       if (leaves[i].hasColumnName()) {
         filterColumns_[i] = findColumn(type, leaves[i].getColumnName());
       } else {
         filterColumns_[i] = leaves[i].getColumnId();
       }
+      bloomProbes_.emplace_back(leaves[i].getBloomHashes());
 
       if (leaves[i].getOperator() == PredicateLeaf::Operator::IN) {
         uint64_t columnId = filterColumns_[i];
@@ -79,9 +81,10 @@ namespace orc {
     columnsWithInExpr_.assign(columnsWithInExpr.begin(), columnsWithInExpr.end());
   }
 
-  bool SargsApplier::pickRowGroups(uint64_t rowsInStripe,
-                                   const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
-                                   const std::map<uint32_t, BloomFilterIndex>& bloomFilters) {
+  bool SargsApplier::pickRowGroups(
+      uint64_t rowsInStripe,
+      const std::unordered_map<uint64_t, std::shared_ptr<const proto::RowIndex>>& rowIndexes,
+      const std::map<uint32_t, BloomFilterIndex>& bloomFilters) {
     // init state of each row group
     uint64_t groupsInStripe = (rowsInStripe + rowIndexStride_ - 1) / rowIndexStride_;
     nextSkippedRows_.resize(groupsInStripe);
@@ -94,6 +97,27 @@ namespace orc {
 
     const auto& leaves = dynamic_cast<const SearchArgumentImpl*>(searchArgument_)->getLeaves();
     std::vector<TruthValue> leafValues(leaves.size(), TruthValue::YES_NO_NULL);
+
+    // bind each leaf to the indexes of its column once for all row groups
+    leafIndexes_.assign(leaves.size(), LeafIndex{nullptr, nullptr});
+    for (size_t pred = 0; pred != leaves.size(); ++pred) {
+      uint64_t columnIdx = filterColumns_[pred];
+      auto rowIndexIter = rowIndexes.find(columnIdx);
+      if (columnIdx == INVALID_COLUMN_ID || rowIndexIter == rowIndexes.cend()) {
+        // this column does not exist in current file
+        continue;
+      }
+      if (schemaEvolution_ && !schemaEvolution_->isSafePPDConversion(columnIdx)) {
+        // cannot evaluate predicate when ppd is not safe
+        continue;
+      }
+      leafIndexes_[pred].rowIndex = rowIndexIter->second.get();
+      auto iter = bloomFilters.find(static_cast<uint32_t>(columnIdx));
+      if (iter != bloomFilters.cend()) {
+        leafIndexes_[pred].bloomFilters = &iter->second;
+      }
+    }
+
     hasSelected_ = false;
     hasSkipped_ = false;
     uint64_t nextSkippedRowGroup = groupsInStripe;
@@ -101,27 +125,22 @@ namespace orc {
     do {
       --rowGroup;
       for (size_t pred = 0; pred != leaves.size(); ++pred) {
-        uint64_t columnIdx = filterColumns_[pred];
-        auto rowIndexIter = rowIndexes.find(columnIdx);
-        if (columnIdx == INVALID_COLUMN_ID || rowIndexIter == rowIndexes.cend()) {
-          // this column does not exist in current file
-          leafValues[pred] = TruthValue::YES_NO_NULL;
-        } else if (schemaEvolution_ && !schemaEvolution_->isSafePPDConversion(columnIdx)) {
-          // cannot evaluate predicate when ppd is not safe
+        const LeafIndex& index = leafIndexes_[pred];
+        if (index.rowIndex == nullptr) {
           leafValues[pred] = TruthValue::YES_NO_NULL;
         } else {
           // get column statistics
           const proto::ColumnStatistics& statistics =
-              rowIndexIter->second.entry(static_cast<int>(rowGroup)).statistics();
+              index.rowIndex->entry(static_cast<int>(rowGroup)).statistics();
 
           // get bloom filter
-          std::shared_ptr<BloomFilter> bloomFilter;
-          auto iter = bloomFilters.find(static_cast<uint32_t>(columnIdx));
-          if (iter != bloomFilters.cend()) {
-            bloomFilter = iter->second.entries.at(rowGroup);
+          const BloomFilter* bloomFilter = nullptr;
+          if (index.bloomFilters != nullptr) {
+            bloomFilter = index.bloomFilters->entries.at(rowGroup).get();
           }
 
-          leafValues[pred] = leaves[pred].evaluate(writerVersion_, statistics, bloomFilter.get());
+          leafValues[pred] =
+              leaves[pred].evaluate(writerVersion_, statistics, bloomFilter, &bloomProbes_[pred]);
         }
       }
 
@@ -151,6 +170,14 @@ namespace orc {
   }
 
   bool SargsApplier::evaluateColumnStatistics(const PbColumnStatistics& colStats) const {
+    auto getStats = [&colStats](uint64_t columnId) -> const proto::ColumnStatistics& {
+      return colStats.Get(static_cast<int>(columnId));
+    };
+    return evaluateColumnStatistics(static_cast<uint64_t>(colStats.size()), getStats);
+  }
+
+  template <typename GetStats>
+  bool SargsApplier::evaluateColumnStatistics(uint64_t numColumns, GetStats getStats) const {
     const SearchArgumentImpl* sargs = dynamic_cast<const SearchArgumentImpl*>(searchArgument_);
     if (sargs == nullptr) {
       throw InvalidArgument("Failed to cast to SearchArgumentImpl");
@@ -161,9 +188,8 @@ namespace orc {
 
     for (size_t pred = 0; pred != leaves.size(); ++pred) {
       uint64_t columnId = filterColumns_[pred];
-      if (columnId != INVALID_COLUMN_ID && colStats.size() > static_cast<int>(columnId)) {
-        leafValues[pred] = leaves[pred].evaluate(writerVersion_,
-                                                 colStats.Get(static_cast<int>(columnId)), nullptr);
+      if (columnId != INVALID_COLUMN_ID && numColumns > columnId) {
+        leafValues[pred] = leaves[pred].evaluate(writerVersion_, getStats(columnId), nullptr);
       }
     }
 
@@ -176,15 +202,36 @@ namespace orc {
       return true;
     }
 
-    bool ret = evaluateColumnStatistics(stripeStats.col_stats());
+    return onStripeStatisticsEvaluated(evaluateColumnStatistics(stripeStats.col_stats()),
+                                       stripeRowGroupCount);
+  }
+
+  bool SargsApplier::evaluateStripeStatistics(const LazyMetadata& metadata, uint64_t stripe,
+                                              uint64_t stripeRowGroupCount) {
+    if (metadata.getNumberOfColumns(stripe) == 0) {
+      return true;
+    }
+
+    return onStripeStatisticsEvaluated(mayMatchStripe(metadata, stripe), stripeRowGroupCount);
+  }
+
+  bool SargsApplier::onStripeStatisticsEvaluated(bool result, uint64_t stripeRowGroupCount) {
     if (metrics_ != nullptr) {
       metrics_->EvaluatedRowGroupCount.fetch_add(stripeRowGroupCount);
     }
-    if (!ret) {
+    if (!result) {
       // reset mNextSkippedRows when the current stripe does not satisfy the PPD
       nextSkippedRows_.clear();
     }
-    return ret;
+    return result;
+  }
+
+  bool SargsApplier::mayMatchStripe(const LazyMetadata& metadata, uint64_t stripe) const {
+    uint64_t numColumns = metadata.getNumberOfColumns(stripe);
+    auto getStats = [&metadata, stripe](uint64_t columnId) -> const proto::ColumnStatistics& {
+      return metadata.getColumnStatistics(stripe, columnId);
+    };
+    return numColumns == 0 || evaluateColumnStatistics(numColumns, getStats);
   }
 
   bool SargsApplier::evaluateFileStatistics(const proto::Footer& footer,
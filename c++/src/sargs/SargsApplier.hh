@@ -19,6 +19,8 @@
 #ifndef ORC_SARGSAPPLIER_HH
 #define ORC_SARGSAPPLIER_HH
 
+#include "BloomFilter.hh"
+#include "LazyMetadata.hh"
 #include "SchemaEvolution.hh"
 #include "orc/BloomFilter.hh"
 #include "orc/Common.hh"
@@ -59,6 +61,20 @@ namespace orc {
     bool evaluateStripeStatistics(const proto::StripeStatistics& stripeStats,
                                   uint64_t stripeRowGroupCount);
 
+    /**
+     * Same as above, but only the statistics of the columns in the sargs
+     * are decoded from the metadata.
+     */
+    bool evaluateStripeStatistics(const LazyMetadata& metadata, uint64_t stripe,
+                                  uint64_t stripeRowGroupCount);
+
+    /**
+     * Check whether stripe statistics may satisfy the sargs without updating
+     * Reader Metrics or the row groups picked for the current stripe.
+     * @return true if the stripe may contain matching rows
+     */
+    bool mayMatchStripe(const LazyMetadata& metadata, uint64_t stripe) const;
+
     /**
      * Evaluate search argument on column dictionaries (only IN expressions)
      * If dictionary entries don't satisfy the sargs,
@@ -76,9 +92,10 @@ namespace orc {
      * Pick the row groups that we need to load from the current stripe.
      * @return true if any row group is selected
      */
-    bool pickRowGroups(uint64_t rowsInStripe,
-                       const std::unordered_map<uint64_t, proto::RowIndex>& rowIndexes,
-                       const std::map<uint32_t, BloomFilterIndex>& bloomFilters);
+    bool pickRowGroups(
+        uint64_t rowsInStripe,
+        const std::unordered_map<uint64_t, std::shared_ptr<const proto::RowIndex>>& rowIndexes,
+        const std::map<uint32_t, BloomFilterIndex>& bloomFilters);
 
     /**
      * Return a vector of the next skipped row for each RowGroup. Each value is the row id
@@ -144,6 +161,14 @@ namespace orc {
     typedef ::google::protobuf::RepeatedPtrField<proto::ColumnStatistics> PbColumnStatistics;
     bool evaluateColumnStatistics(const PbColumnStatistics& colStats) const;
 
+    // evaluate the statistics of numColumns columns, which getStats(columnId)
+    // returns for the columns in the sargs only
+    template <typename GetStats>
+    bool evaluateColumnStatistics(uint64_t numColumns, GetStats getStats) const;
+
+    // update the metrics and row groups after evaluating stripe statistics
+    bool onStripeStatisticsEvaluated(bool result, uint64_t stripeRowGroupCount);
+
     // Helper method to evaluate IN expression against a dictionary
     TruthValue evaluateDictionaryForColumn(const StringDictionary& dictionary,
                                            const PredicateLeaf& leaf) const;
@@ -165,6 +190,17 @@ namespace orc {
     // column ids that have IN expressions for dictionary filtering
     std::vector<uint64_t> columnsWithInExpr_;
 
+    // the indexes of the column of each predicate leaf in the current stripe,
+    // resolved once per stripe in pickRowGroups(). A null rowIndex means the
+    // leaf can't be evaluated.
+    struct LeafIndex {
+      const proto::RowIndex* rowIndex;
+      const BloomFilterIndex* bloomFilters;
+    };
+    std::vector<LeafIndex> leafIndexes_;
+    // bloom filter probes of each predicate leaf, reused by all row groups
+    std::vector<BloomFilterProbes> bloomProbes_;
+
     // Map from RowGroup index to the next skipped row of the selected range it
     // locates. If the RowGroup is not selected, set the value to 0.
     // Calculated in pickRowGroups().
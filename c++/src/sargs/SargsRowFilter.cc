@@ -0,0 +1,405 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "SargsRowFilter.hh"
+#include "orc/Exceptions.hh"
+#include "sargs/PredicateLeaf.hh"
+
+#include <algorithm>
+#include <limits>
+#include <string_view>
+
+namespace orc {
+
+  namespace {
+
+    constexpr size_t INVALID_FIELD = std::numeric_limits<size_t>::max();
+
+    struct DecimalValue {
+      Int128 value;
+      int32_t scale;
+    };
+
+    // Compare decimals by scaling the one with the smaller scale up.
+    bool operator<(const DecimalValue& left, const DecimalValue& right) {
+      if (left.scale == right.scale) {
+        return left.value < right.value;
+      }
+      bool overflow = false;
+      if (left.scale < right.scale) {
+        Int128 scaled = scaleUpInt128ByPowerOfTen(left.value, right.scale - left.scale, overflow);
+        return overflow ? left.value < 0 : scaled < right.value;
+      }
+      Int128 scaled = scaleUpInt128ByPowerOfTen(right.value, left.scale - right.scale, overflow);
+      return overflow ? right.value > 0 : left.value < scaled;
+    }
+
+    template <typename T>
+    bool isEqual(const T& left, const T& right) {
+      return !(left < right) && !(right < left);
+    }
+
+    template <typename T>
+    bool isLessOrEqual(const T& left, const T& right) {
+      return !(right < left);
+    }
+
+    // NaN is neither equal to nor ordered with any value, so every comparison
+    // with it is false
+    bool isEqual(double left, double right) {
+      return left == right;
+    }
+
+    bool isLessOrEqual(double left, double right) {
+      return left <= right;
+    }
+
+    /**
+     * Evaluates a leaf on the values of a column, with the literals converted
+     * to the type of the values.
+     */
+    template <typename T>
+    class LeafEvaluator {
+     public:
+      template <typename GetLiteral>
+      LeafEvaluator(const PredicateLeaf& leaf, GetLiteral getLiteral)
+          : op_(leaf.getOperator()), anyNullLiteral_(false) {
+        for (const Literal& literal : leaf.getLiteralList()) {
+          literalIsNull_.push_back(literal.isNull());
+          literals_.push_back(literal.isNull() ? T() : getLiteral(literal));
+          anyNullLiteral_ = anyNullLiteral_ || literal.isNull();
+        }
+      }
+
+      // Get the value of the leaf for a null row.
+      TruthValue evaluateNull() const {
+        if (op_ == PredicateLeaf::Operator::NULL_SAFE_EQUALS) {
+          return literalIsNull_[0] ? TruthValue::YES : TruthValue::NO;
+        }
+        return TruthValue::IS_NULL;
+      }
+
+      TruthValue evaluate(const T& value) const {
+        if (anyNullLiteral_ && op_ != PredicateLeaf::Operator::IN &&
+            op_ != PredicateLeaf::Operator::NULL_SAFE_EQUALS) {
+          // comparisons with a null literal are unknown
+          return TruthValue::IS_NULL;
+        }
+        switch (op_) {
+          case PredicateLeaf::Operator::EQUALS:
+          case PredicateLeaf::Operator::NULL_SAFE_EQUALS:
+            return !literalIsNull_[0] && isEqual(value, literals_[0]) ? TruthValue::YES
+                                                                      : TruthValue::NO;
+          case PredicateLeaf::Operator::LESS_THAN:
+            return value < literals_[0] ? TruthValue::YES : TruthValue::NO;
+          case PredicateLeaf::Operator::LESS_THAN_EQUALS:
+            return isLessOrEqual(value, literals_[0]) ? TruthValue::YES : TruthValue::NO;
+          case PredicateLeaf::Operator::BETWEEN:
+            return isLessOrEqual(literals_[0], value) && isLessOrEqual(value, literals_[1])
+                       ? TruthValue::YES
+                       : TruthValue::NO;
+          case PredicateLeaf::Operator::IN:
+            for (size_t i = 0; i < literals_.size(); ++i) {
+              if (!literalIsNull_[i] && isEqual(value, literals_[i])) {
+                return TruthValue::YES;
+              }
+            }
+            return anyNullLiteral_ ? TruthValue::IS_NULL : TruthValue::NO;
+          case PredicateLeaf::Operator::IS_NULL:
+          default:
+            return TruthValue::NO;
+        }
+      }
+
+      /**
+       * Evaluate the leaf on the rows of a column.
+       * @param getValue returns the value of a non-null row
+       */
+      template <typename GetValue>
+      void evaluateRows(const char* notNull, uint64_t numRows, GetValue getValue,
+                        TruthValue* result) const {
+        TruthValue nullValue = evaluateNull();
+        for (uint64_t row = 0; row < numRows; ++row) {
+          result[row] = notNull && !notNull[row] ? nullValue : evaluate(getValue(row));
+        }
+      }
+
+     private:
+      PredicateLeaf::Operator op_;
+      std::vector<T> literals_;
+      std::vector<bool> literalIsNull_;
+      bool anyNullLiteral_;
+    };
+
+    template <typename BatchType>
+    bool evaluateIntegers(const PredicateLeaf& leaf, const ColumnVectorBatch& field,
+                          const char* notNull, uint64_t numRows, TruthValue* result) {
+      auto* batch = dynamic_cast<const BatchType*>(&field);
+      if (batch == nullptr) {
+        return false;
+      }
+      auto getLiteral = [&leaf](const Literal& literal) {
+        switch (leaf.getType()) {
+          case PredicateDataType::BOOLEAN:
+            return static_cast<int64_t>(literal.getBool());
+          case PredicateDataType::DATE:
+            return literal.getDate();
+          default:
+            return literal.getLong();
+        }
+      };
+      const auto* data = batch->data.data();
+      LeafEvaluator<int64_t>(leaf, getLiteral)
+          .evaluateRows(
+              notNull, numRows, [data](uint64_t row) { return static_cast<int64_t>(data[row]); },
+              result);
+      return true;
+    }
+
+    template <typename BatchType>
+    bool evaluateFloats(const PredicateLeaf& leaf, const ColumnVectorBatch& field,
+                        const char* notNull, uint64_t numRows, TruthValue* result) {
+      auto* batch = dynamic_cast<const BatchType*>(&field);
+      if (batch == nullptr) {
+        return false;
+      }
+      const auto* data = batch->data.data();
+      LeafEvaluator<double>(leaf, [](const Literal& literal) { return literal.getFloat(); })
+          .evaluateRows(
+              notNull, numRows, [data](uint64_t row) { return static_cast<double>(data[row]); },
+              result);
+      return true;
+    }
+
+    template <typename BatchType>
+    bool evaluateDecimals(const PredicateLeaf& leaf, const ColumnVectorBatch& field,
+                          const char* notNull, uint64_t numRows, TruthValue* result) {
+      auto* batch = dynamic_cast<const BatchType*>(&field);
+      if (batch == nullptr) {
+        return false;
+      }
+      const auto* values = batch->values.data();
+      int32_t scale = batch->scale;
+      LeafEvaluator<DecimalValue> evaluator(leaf, [](const Literal& literal) {
+        Decimal decimal = literal.getDecimal();
+        return DecimalValue{decimal.value, decimal.scale};
+      });
+      evaluator.evaluateRows(
+          notNull, numRows,
+          [values, scale](uint64_t row) { return DecimalValue{Int128(values[row]), scale}; },
+          result);
+      return true;
+    }
+
+  }  // namespace
+
+  SargsRowFilter::SargsRowFilter(std::shared_ptr<SearchArgument> searchArgument,
+                                 const std::vector<std::string>& fieldNames,
+                                 const std::vector<uint64_t>& fieldColumnIds)
+      : searchArgument_(std::move(searchArgument)),
+        sargs_(dynamic_cast<const SearchArgumentImpl*>(searchArgument_.get())) {
+    const std::vector<PredicateLeaf>& leaves = sargs_->getLeaves();
+    leafFields_.assign(leaves.size(), INVALID_FIELD);
+    leafValues_.resize(leaves.size());
+    dictionaryValues_.resize(leaves.size());
+    for (size_t i = 0; i < leaves.size(); ++i) {
+      for (size_t field = 0; field < fieldNames.size(); ++field) {
+        if (leaves[i].hasColumnName() ? leaves[i].getColumnName() == fieldNames[field]
+                                      : leaves[i].getColumnId() == fieldColumnIds[field]) {
+          leafFields_[i] = field;
+          if (std::find(fields_.begin(), fields_.end(), field) == fields_.end()) {
+            fields_.push_back(field);
+          }
+          break;
+        }
+      }
+    }
+  }
+
+  void SargsRowFilter::filter(const ColumnVectorBatch& batch, char* selected) {
+    const auto& root = dynamic_cast<const StructVectorBatch&>(batch);
+    uint64_t numRows = batch.numElements;
+    for (size_t leaf = 0; leaf < leafFields_.size(); ++leaf) {
+      leafValues_[leaf].resize(numRows);
+      if (leafFields_[leaf] == INVALID_FIELD) {
+        std::fill(leafValues_[leaf].begin(), leafValues_[leaf].end(), TruthValue::YES_NO_NULL);
+      } else {
+        evaluateLeaf(leaf, *root.fields[leafFields_[leaf]], numRows, leafValues_[leaf].data());
+      }
+    }
+    std::vector<TruthValue> result(numRows);
+    evaluate(*sargs_->getExpression(), numRows, result.data());
+    const char* notNull = batch.hasNulls ? batch.notNull.data() : nullptr;
+    for (uint64_t row = 0; row < numRows; ++row) {
+      // the fields of null structs don't hold values of the row
+      if (!isNeeded(result[row]) && (!notNull || notNull[row])) {
+        selected[row] = 0;
+      }
+    }
+  }
+
+  void SargsRowFilter::evaluate(const ExpressionTree& node, uint64_t numRows,
+                                TruthValue* result) {
+    switch (node.getOperator()) {
+      case ExpressionTree::Operator::CONSTANT:
+        std::fill(result, result + numRows, node.getConstant());
+        break;
+      case ExpressionTree::Operator::LEAF:
+        std::copy(leafValues_[node.getLeaf()].begin(), leafValues_[node.getLeaf()].end(), result);
+        break;
+      case ExpressionTree::Operator::NOT:
+        evaluate(*node.getChild(0), numRows, result);
+        for (uint64_t row = 0; row < numRows; ++row) {
+          result[row] = !result[row];
+        }
+        break;
+      case ExpressionTree::Operator::AND:
+      case ExpressionTree::Operator::OR: {
+        bool isAnd = node.getOperator() == ExpressionTree::Operator::AND;
+        const auto& children = node.getChildren();
+        evaluate(*children[0], numRows, result);
+        std::vector<TruthValue> childResult(numRows);
+        for (size_t i = 1; i < children.size(); ++i) {
+          evaluate(*children[i], numRows, childResult.data());
+          for (uint64_t row = 0; row < numRows; ++row) {
+            result[row] =
+                isAnd ? result[row] && childResult[row] : result[row] || childResult[row];
+          }
+        }
+        break;
+      }
+    }
+  }
+
+  bool SargsRowFilter::evaluateStrings(size_t leaf, const ColumnVectorBatch& field,
+                                       const char* notNull, uint64_t numRows,
+                                       TruthValue* result) {
+    auto* strings = dynamic_cast<const StringVectorBatch*>(&field);
+    if (strings == nullptr) {
+      return false;
+    }
+    LeafEvaluator<std::string_view> evaluator(
+        sargs_->getLeaves()[leaf], [](const Literal& literal) { return literal.getStringView(); });
+    if (!strings->isEncoded) {
+      const char* const* data = strings->data.data();
+      const int64_t* length = strings->length.data();
+      evaluator.evaluateRows(
+          notNull, numRows,
+          [data, length](uint64_t row) {
+            return std::string_view(data[row], static_cast<size_t>(length[row]));
+          },
+          result);
+      return true;
+    }
+
+    // Lazily decoded batches only hold the ids of dictionary entries, so the
+    // leaf is evaluated once per entry the first time the entry is seen and
+    // rows just look their entry up.
+    const auto& encoded = dynamic_cast<const EncodedStringVectorBatch&>(field);
+    DictionaryValues& entries = dictionaryValues_[leaf];
+    const StringDictionary& dictionary = *encoded.dictionary;
+    uint64_t numEntries = dictionary.dictionaryOffset.size() - 1;
+    if (entries.dictionary != encoded.dictionary) {
+      entries.dictionary = encoded.dictionary;
+      entries.values.assign(numEntries, TruthValue::YES_NO_NULL);
+      entries.evaluated.assign(numEntries, false);
+    }
+    const char* blob = dictionary.dictionaryBlob.data();
+    const int64_t* offsets = dictionary.dictionaryOffset.data();
+    const int64_t* index = encoded.index.data();
+    TruthValue nullValue = evaluator.evaluateNull();
+    for (uint64_t row = 0; row < numRows; ++row) {
+      if (notNull && !notNull[row]) {
+        result[row] = nullValue;
+        continue;
+      }
+      int64_t entry = index[row];
+      if (entry < 0 || static_cast<uint64_t>(entry) >= numEntries) {
+        throw ParseError("Entry index out of range in StringDictionaryColumn");
+      }
+      if (!entries.evaluated[static_cast<size_t>(entry)]) {
+        entries.values[static_cast<size_t>(entry)] = evaluator.evaluate(std::string_view(
+            blob + offsets[entry], static_cast<size_t>(offsets[entry + 1] - offsets[entry])));
+        entries.evaluated[static_cast<size_t>(entry)] = true;
+      }
+      result[row] = entries.values[static_cast<size_t>(entry)];
+    }
+    return true;
+  }
+
+  void SargsRowFilter::evaluateLeaf(size_t leaf, const ColumnVectorBatch& field,
+                                    uint64_t numRows, TruthValue* result) {
+    const PredicateLeaf& predicate = sargs_->getLeaves()[leaf];
+    const char* notNull = field.hasNulls ? field.notNull.data() : nullptr;
+    if (predicate.getOperator() == PredicateLeaf::Operator::IS_NULL) {
+      for (uint64_t row = 0; row < numRows; ++row) {
+        result[row] = notNull && !notNull[row] ? TruthValue::YES : TruthValue::NO;
+      }
+      return;
+    }
+
+    bool evaluated = false;
+    switch (predicate.getType()) {
+      case PredicateDataType::LONG:
+      case PredicateDataType::DATE:
+      case PredicateDataType::BOOLEAN:
+        evaluated =
+            evaluateIntegers<LongVectorBatch>(predicate, field, notNull, numRows, result) ||
+            evaluateIntegers<IntVectorBatch>(predicate, field, notNull, numRows, result) ||
+            evaluateIntegers<ShortVectorBatch>(predicate, field, notNull, numRows, result) ||
+            evaluateIntegers<ByteVectorBatch>(predicate, field, notNull, numRows, result);
+        break;
+      case PredicateDataType::FLOAT:
+        evaluated =
+            evaluateFloats<DoubleVectorBatch>(predicate, field, notNull, numRows, result) ||
+            evaluateFloats<FloatVectorBatch>(predicate, field, notNull, numRows, result);
+        break;
+      case PredicateDataType::DECIMAL:
+        evaluated =
+            evaluateDecimals<Decimal64VectorBatch>(predicate, field, notNull, numRows, result) ||
+            evaluateDecimals<Decimal128VectorBatch>(predicate, field, notNull, numRows, result);
+        break;
+      case PredicateDataType::STRING:
+        evaluated = evaluateStrings(leaf, field, notNull, numRows, result);
+        break;
+      case PredicateDataType::TIMESTAMP: {
+        auto* timestamps = dynamic_cast<const TimestampVectorBatch*>(&field);
+        if (timestamps == nullptr) {
+          break;
+        }
+        const int64_t* seconds = timestamps->data.data();
+        const int64_t* nanos = timestamps->nanoseconds.data();
+        LeafEvaluator<Literal::Timestamp>(
+            predicate, [](const Literal& literal) { return literal.getTimestamp(); })
+            .evaluateRows(
+                notNull, numRows,
+                [seconds, nanos](uint64_t row) {
+                  return Literal::Timestamp(seconds[row], static_cast<int32_t>(nanos[row]));
+                },
+                result);
+        evaluated = true;
+        break;
+      }
+    }
+    if (!evaluated) {
+      // the column type doesn't match the leaf, so it can't filter rows
+      std::fill(result, result + numRows, TruthValue::YES_NO_NULL);
+    }
+  }
+
+}  // namespace orc
@@ -0,0 +1,90 @@
+/**
+ * Licensed to the Apache Software Foundation (ASF) under one
+ * or more contributor license agreements.  See the NOTICE file
+ * distributed with this work for additional information
+ * regarding copyright ownership.  The ASF licenses this file
+ * to you under the Apache License, Version 2.0 (the
+ * "License"); you may not use this file except in compliance
+ * with the License.  You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef ORC_SARGSROWFILTER_HH
+#define ORC_SARGSROWFILTER_HH
+
+#include "orc/Vector.hh"
+#include "orc/sargs/TruthValue.hh"
+#include "sargs/SearchArgument.hh"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace orc {
+
+  /**
+   * Evaluates a SearchArgument on the rows of decoded batches. Each leaf is
+   * evaluated a column at a time into a vector of truth values, which are
+   * then combined bottom up along the expression tree.
+   */
+  class SargsRowFilter {
+   public:
+    /**
+     * @param searchArgument the search argument to evaluate
+     * @param fieldNames the names of the top-level fields of the batches
+     * @param fieldColumnIds the column ids of the top-level fields
+     */
+    SargsRowFilter(std::shared_ptr<SearchArgument> searchArgument,
+                   const std::vector<std::string>& fieldNames,
+                   const std::vector<uint64_t>& fieldColumnIds);
+
+    /**
+     * Get the positions of the top-level fields that the leaves read.
+     */
+    const std::vector<size_t>& getFields() const {
+      return fields_;
+    }
+
+    /**
+     * Clear the selection of the rows for which the search argument can't be
+     * true. Leaves on nested or unselected columns don't filter any rows.
+     * @param batch a struct batch with the top-level fields
+     * @param selected one flag per row of the batch
+     */
+    void filter(const ColumnVectorBatch& batch, char* selected);
+
+   private:
+    void evaluate(const ExpressionTree& node, uint64_t numRows, TruthValue* result);
+    void evaluateLeaf(size_t leaf, const ColumnVectorBatch& field, uint64_t numRows,
+                      TruthValue* result);
+    bool evaluateStrings(size_t leaf, const ColumnVectorBatch& field, const char* notNull,
+                         uint64_t numRows, TruthValue* result);
+
+    // values of a string leaf for the entries of a dictionary
+    struct DictionaryValues {
+      std::shared_ptr<StringDictionary> dictionary;
+      std::vector<TruthValue> values;
+      std::vector<bool> evaluated;
+    };
+
+    std::shared_ptr<SearchArgument> searchArgument_;
+    const SearchArgumentImpl* sargs_;
+    // position of the field read by each leaf or INVALID_FIELD
+    std::vector<size_t> leafFields_;
+    std::vector<size_t> fields_;
+    // truth values of each leaf for the current batch
+    std::vector<std::vector<TruthValue>> leafValues_;
+    // values of each string leaf for the dictionary of the current stripe
+    std::vector<DictionaryValues> dictionaryValues_;
+  };
+
+}  // namespace orc
+
+#endif  // ORC_SARGSROWFILTER_HH
@@ -42,7 +42,8 @@ namespace orc {
       memcpy(buf, buffer_ + offset, length);
     }
 
-    std::future<void> readAsync(void* buf, uint64_t length, uint64_t offset) override {
+    std::future<void> readAsync(void* buf, uint64_t length, uint64_t offset,
+                                ReaderMetrics*) override {
       return std::async(std::launch::async,
                         [this, buf, length, offset] { this->read(buf, length, offset); });
     }
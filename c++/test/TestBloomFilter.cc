@@ -17,6 +17,8 @@
  */
 
 #include "BloomFilter.hh"
+#include "BloomFilterKernels.hh"
+#include "CpuInfoUtil.hh"
 #include "orc/OrcFile.hh"
 #include "wrap/gtest-wrapper.h"
 
@@ -263,4 +265,137 @@ namespace orc {
     EXPECT_TRUE(dstBloomFilter->testLong(-1111));
   }
 
+  TEST(TestBloomFilter, testProbeHashes) {
+    std::vector<int64_t> hashes;
+    for (int64_t i = 0; i < 1000; i += 7) {
+      hashes.push_back(BloomFilterImpl::hashLong(i));
+    }
+    hashes.push_back(BloomFilterImpl::hashDouble(3.5));
+    hashes.push_back(BloomFilterImpl::hashBytes("str", 3));
+
+    BloomFilterProbes probes(hashes);
+    // filters of different sizes, as the probed positions depend on them
+    for (uint64_t expectedEntries : {100, 100, 5000, 100}) {
+      BloomFilterImpl filter(expectedEntries);
+      for (int64_t i = 1000; i < 1100; ++i) {
+        filter.addLong(i);
+      }
+      bool expected = false;
+      for (int64_t i = 0; i < 1000; i += 7) {
+        expected |= filter.testLong(i);
+      }
+      expected |= filter.testDouble(3.5) || filter.testBytes("str", 3);
+      EXPECT_EQ(expected, filter.testAnyHash(hashes.data(), hashes.size()));
+      EXPECT_EQ(expected, probes.testAny(filter));
+
+      filter.addBytes("str", 3);
+      EXPECT_TRUE(filter.testAnyHash(hashes.data(), hashes.size()));
+      EXPECT_TRUE(probes.testAny(filter));
+      EXPECT_FALSE(filter.testAnyHash(hashes.data(), 0));
+    }
+  }
+
+  TEST(TestBloomFilter, testSplitBlockBloomFilter) {
+    BloomFilterImpl filter(1000, 0.01, BloomFilterVersion::SPLIT_BLOCK);
+    EXPECT_EQ(BloomFilterVersion::SPLIT_BLOCK, filter.getVersion());
+    EXPECT_EQ(0, filter.getBitSize() % SPLIT_BLOCK_BITS);
+    EXPECT_EQ(8, filter.getNumHashFunctions());
+    EXPECT_FALSE(filter == BloomFilterImpl(1000, 0.01));
+
+    for (int64_t i = 0; i < 1000; ++i) {
+      filter.addLong(i * 3);
+    }
+    filter.addDouble(3.5);
+    filter.addBytes("str", 3);
+    uint64_t falsePositives = 0;
+    for (int64_t i = 0; i < 3000; ++i) {
+      if (i % 3 == 0) {
+        EXPECT_TRUE(filter.testLong(i));
+      } else {
+        falsePositives += filter.testLong(i);
+      }
+    }
+    EXPECT_LT(falsePositives, 100);
+    EXPECT_TRUE(filter.testDouble(3.5));
+    EXPECT_TRUE(filter.testBytes("str", 3));
+
+    // serialized like the UTF8 version, but only readable as split-block
+    proto::BloomFilter pbBloomFilter;
+    BloomFilterUTF8Utils::serialize(filter, pbBloomFilter);
+    proto::ColumnEncoding encoding;
+    encoding.set_bloom_encoding(BloomFilterVersion::SPLIT_BLOCK);
+    std::unique_ptr<BloomFilter> dstBloomFilter = BloomFilterUTF8Utils::deserialize(
+        proto::Stream_Kind_BLOOM_FILTER_UTF8, encoding, pbBloomFilter);
+    EXPECT_TRUE(filter == dynamic_cast<BloomFilterImpl&>(*dstBloomFilter));
+    encoding.set_bloom_encoding(BloomFilterVersion::SPLIT_BLOCK + 1);
+    EXPECT_EQ(nullptr, BloomFilterUTF8Utils::deserialize(proto::Stream_Kind_BLOOM_FILTER_UTF8,
+                                                         encoding, pbBloomFilter));
+    encoding.set_bloom_encoding(BloomFilterVersion::SPLIT_BLOCK);
+    pbBloomFilter.set_utf8bitset(std::string(40, '\0'));
+    EXPECT_EQ(nullptr, BloomFilterUTF8Utils::deserialize(proto::Stream_Kind_BLOOM_FILTER_UTF8,
+                                                         encoding, pbBloomFilter));
+
+    std::vector<int64_t> hashes;
+    for (int64_t i = 1; i < 3000; i += 3) {
+      hashes.push_back(BloomFilterImpl::hashLong(i));
+    }
+    BloomFilterProbes probes(hashes);
+    bool expected = false;
+    for (int64_t i = 1; i < 3000; i += 3) {
+      expected |= filter.testLong(i);
+    }
+    EXPECT_EQ(expected, probes.testAny(filter));
+    hashes.push_back(BloomFilterImpl::hashBytes("str", 3));
+    BloomFilterProbes moreProbes(hashes);
+    EXPECT_TRUE(moreProbes.testAny(filter));
+    EXPECT_TRUE(filter.testAnyHash(hashes.data(), hashes.size()));
+
+    BloomFilterImpl classic(1000, 0.01);
+    EXPECT_THROW(filter.merge(classic), std::logic_error);
+  }
+
+  TEST(TestBloomFilter, testSplitBlockFalsePositiveRate) {
+    for (double fpp : {0.01, 0.05}) {
+      SCOPED_TRACE(fpp);
+      const int64_t entries = 100000;
+      BloomFilterImpl filter(entries, fpp, BloomFilterVersion::SPLIT_BLOCK);
+      for (int64_t i = 0; i < entries; ++i) {
+        filter.addLong(i * 2);
+      }
+      const int64_t probes = 1000000;
+      int64_t falsePositives = 0;
+      for (int64_t i = 0; i < probes; ++i) {
+        falsePositives += filter.testLong(i * 2 + 1);
+      }
+      // the filter reaches the fpp, but isn't much larger than it needs to be
+      double observed = static_cast<double>(falsePositives) / probes;
+      EXPECT_LT(observed, fpp * 1.05);
+      EXPECT_GT(observed, fpp * 0.7);
+    }
+  }
+
+  TEST(TestBloomFilter, testSplitBlockKernels) {
+    std::srand(17);
+    std::vector<uint64_t> block(SPLIT_BLOCK_BITS / 64);
+    for (int i = 0; i < 10000; ++i) {
+      // dense blocks, so that some keys find all their bits set
+      for (auto& word : block) {
+        word = static_cast<uint64_t>(std::rand()) << 40 | static_cast<uint64_t>(std::rand());
+        word |= static_cast<uint64_t>(std::rand()) << 20;
+      }
+      uint32_t key = static_cast<uint32_t>(std::rand()) * 2654435761U;
+      bool expected = true;
+      for (uint32_t w = 0; w < SPLIT_BLOCK_WORDS; ++w) {
+        uint64_t bit = (w % 2) * 32 + splitBlockBit(key, w);
+        expected &= ((block[w / 2] >> bit) & 1) != 0;
+      }
+      EXPECT_EQ(expected, SplitBlockDefault::testBlock(block.data(), key));
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+      if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX2)) {
+        EXPECT_EQ(expected, SplitBlockAVX2::testBlock(block.data(), key));
+      }
+#endif
+    }
+  }
+
 }  // namespace orc
@@ -17,9 +17,12 @@
  */
 
 #include <cstring>
+#include <thread>
 
 #include "MemoryInputStream.hh"
 #include "io/Cache.hh"
+#include "orc/Exceptions.hh"
+#include "orc/IOExecutor.hh"
 
 #include "wrap/gmock.h"
 #include "wrap/gtest-wrapper.h"
@@ -176,4 +179,81 @@ namespace orc {
     // external.
     EXPECT_EQ(freeCountAfterSetData, pool.freeCount);
   }
+
+  TEST(TestIOExecutor, testFairness) {
+    IOExecutorOptions options;
+    options.numThreads = 1;
+    auto executor = createIOExecutor(options);
+
+    // occupy the only worker until all tasks are queued
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    auto blocker = executor->submit(nullptr, [&started, released] {
+      started.set_value();
+      released.wait();
+    });
+    started.get_future().wait();
+
+    int clientA = 0;
+    int clientB = 0;
+    ReaderMetrics metrics;
+    std::string order;
+    std::vector<std::future<void>> futures;
+    for (int i = 0; i < 3; ++i) {
+      futures.push_back(executor->submit(&clientA, [&order] { order += 'a'; }));
+    }
+    for (int i = 0; i < 3; ++i) {
+      futures.push_back(executor->submit(&clientB, [&order] { order += 'b'; }, &metrics));
+    }
+    release.set_value();
+    blocker.get();
+    for (auto& future : futures) {
+      future.get();
+    }
+
+    EXPECT_EQ("ababab", order);
+    EXPECT_EQ(3, metrics.IOQueueWaitCount.load());
+  }
+
+  TEST(TestIOExecutor, testBoundedQueue) {
+    IOExecutorOptions options;
+    options.numThreads = 1;
+    options.maxQueueSize = 1;
+    auto executor = createIOExecutor(options);
+
+    std::promise<void> started;
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    auto blocker = executor->submit(nullptr, [&started, released] {
+      started.set_value();
+      released.wait();
+    });
+    started.get_future().wait();
+    auto queued = executor->submit(nullptr, [] {});
+
+    // the queue is full, so the next submit waits for the worker
+    std::atomic<bool> submitted{false};
+    std::thread submitter([&executor, &submitted] {
+      executor->submit(nullptr, [] {}).get();
+      submitted = true;
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    EXPECT_FALSE(submitted.load());
+
+    release.set_value();
+    submitter.join();
+    EXPECT_TRUE(submitted.load());
+    blocker.get();
+    queued.get();
+  }
+
+  TEST(TestIOExecutor, testException) {
+    auto executor = createIOExecutor(IOExecutorOptions());
+    auto future = executor->submit(nullptr, [] { throw ParseError("bad read"); });
+    EXPECT_THROW(future.get(), ParseError);
+
+    getDefaultIOExecutor();
+    EXPECT_THROW(setDefaultIOExecutorOptions(IOExecutorOptions()), std::logic_error);
+  }
 }  // namespace orc
@@ -18,8 +18,10 @@
 
 #include "Adaptor.hh"
 #include "ColumnReader.hh"
+#include "CpuInfoUtil.hh"
 #include "MockStripeStreams.hh"
 #include "OrcTest.hh"
+#include "TimestampKernels.hh"
 #include "orc/Exceptions.hh"
 
 #include <cmath>
@@ -2643,6 +2645,39 @@ namespace orc {
     }
   }
 
+  TEST(TestColumnReader, testTimestampNanosDecode) {
+    std::vector<int64_t> encoded;
+    std::vector<int64_t> expected;
+    std::srand(13);
+    for (int64_t i = 0; i < 1003; ++i) {
+      int64_t zeros = i % 9;
+      int64_t nanos = std::rand() % 1000000000;
+      if (zeros > 1) {
+        // a value with trailing zeros is stored without them
+        int64_t scale = NANOS_SCALE[zeros - 1];
+        nanos = nanos / scale * scale;
+        encoded.push_back((nanos / scale) << 3 | (zeros - 1));
+      } else {
+        encoded.push_back(nanos << 3);
+      }
+      expected.push_back(nanos);
+    }
+    // a corrupt value too large for 32 bits of digits
+    encoded[502] = (INT64_C(1) << 40) << 3 | 1;
+    expected[502] = (INT64_C(1) << 40) * 100;
+
+    std::vector<int64_t> values = encoded;
+    TimestampDecodeDefault::decodeNanos(values.data(), values.size());
+    EXPECT_EQ(expected, values);
+#if defined(ORC_HAVE_RUNTIME_AVX2)
+    if (CpuInfo::getInstance()->isDetected(CpuInfo::AVX2)) {
+      values = encoded;
+      TimestampDecodeAVX2::decodeNanos(values.data(), values.size());
+      EXPECT_EQ(expected, values);
+    }
+#endif
+  }
+
   TEST(DecimalColumnReader, testDecimal64) {
     MockStripeStreams streams;
 
@@ -371,6 +371,54 @@ namespace orc {
     testSeekDecompressionStream(CompressionKind_SNAPPY);
   }
 
+  namespace {
+    class AllocationCountingPool : public MemoryPool {
+     public:
+      uint64_t allocCount = 0;
+
+      char* malloc(uint64_t size) override {
+        ++allocCount;
+        return static_cast<char*>(std::malloc(size));
+      }
+
+      void free(char* p) override {
+        std::free(p);
+      }
+    };
+  }  // namespace
+
+  TEST(Compression, pooledCompressors) {
+    AllocationCountingPool memoryPool;
+    std::shared_ptr<CompressorPool> compressorPool = createCompressorPool(memoryPool);
+    const size_t dataSize = 4096;
+    char testData[dataSize];
+    generateRandomData(testData, dataSize, true);
+
+    // every stream but the first reuses the scratch buffer returned by its predecessor
+    uint64_t allocations[3];
+    for (int i = 0; i < 3; ++i) {
+      MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+      uint64_t before = memoryPool.allocCount;
+      {
+        std::unique_ptr<BufferedOutputStream> compressStream =
+            createCompressor(CompressionKind_LZ4, &memStream, CompressionStrategy_SPEED, 1024,
+                             256, 256, memoryPool, nullptr, compressorPool);
+        char* buffer;
+        int size;
+        ASSERT_TRUE(compressStream->Next(reinterpret_cast<void**>(&buffer), &size));
+        ASSERT_EQ(256, size);
+        memcpy(buffer, testData, 256);
+        ASSERT_TRUE(compressStream->Next(reinterpret_cast<void**>(&buffer), &size));
+        memcpy(buffer, testData + 256, 256);
+        compressStream->flush();
+      }
+      allocations[i] = memoryPool.allocCount - before;
+      decompressAndVerify(memStream, CompressionKind_LZ4, testData, 512, memoryPool, 1024);
+    }
+    EXPECT_LT(allocations[1], allocations[0]);
+    EXPECT_EQ(allocations[1], allocations[2]);
+  }
+
   TEST(Compression, ZstdDecompressStreamCorrupted) {
     MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
     MemoryPool* pool = getDefaultPool();
@@ -311,6 +311,70 @@ namespace orc {
     }
   }
 
+  TEST_F(TestDecompression, testFileReadAsync) {
+    SCOPED_TRACE("testFileReadAsync");
+    IOExecutorOptions executorOptions;
+    executorOptions.numThreads = 2;
+    executorOptions.maxQueueSize = 2;
+    auto executor = createIOExecutor(executorOptions);
+    for (auto mode : {LocalFileAsyncMode::DEFAULT, LocalFileAsyncMode::IO_URING}) {
+      LocalFileOptions options;
+      options.asyncMode = mode;
+      options.queueDepth = 2;
+      options.executor = executor.get();
+      std::unique_ptr<InputStream> file = readLocalFile(simpleFile, nullptr, options);
+
+      // issue more reads than the queue depth to exercise back pressure
+      std::vector<std::vector<char>> buffers(20, std::vector<char>(10));
+      std::vector<std::future<void>> futures;
+      for (size_t i = 0; i < buffers.size(); ++i) {
+        futures.push_back(file->readAsync(buffers[i].data(), 10, i * 10));
+      }
+      for (size_t i = 0; i < buffers.size(); ++i) {
+        futures[i].get();
+        checkBytes(buffers[i].data(), 10, static_cast<unsigned int>(i * 10));
+      }
+
+      char tail[10];
+      EXPECT_THROW(file->readAsync(tail, 10, 195).get(), ParseError);
+    }
+  }
+
+  TEST_F(TestDecompression, testFileMemoryMap) {
+    SCOPED_TRACE("testFileMemoryMap");
+    LocalFileOptions options;
+    options.memoryMap = true;
+    std::unique_ptr<InputStream> file = readLocalFile(simpleFile, nullptr, options);
+    ASSERT_NE(nullptr, file->getMappedData());
+    file->adviseWillNeed(10, 100);
+
+    // the stream hands out the mapping itself
+    SeekableFileInputStream stream(file.get(), 10, 100, *getDefaultPool(), 40);
+    EXPECT_TRUE(stream.hasStableBuffers());
+    const void* ptr;
+    int len;
+    EXPECT_TRUE(stream.Next(&ptr, &len));
+    EXPECT_EQ(40, len);
+    EXPECT_EQ(file->getMappedData() + 10, ptr);
+    stream.BackUp(15);
+    EXPECT_TRUE(stream.Next(&ptr, &len));
+    EXPECT_EQ(15, len);
+    checkBytes(static_cast<const char*>(ptr), len, 35);
+    EXPECT_TRUE(stream.Skip(50));
+    EXPECT_TRUE(stream.Next(&ptr, &len));
+    EXPECT_EQ(10, len);
+    checkBytes(static_cast<const char*>(ptr), len, 100);
+    EXPECT_FALSE(stream.Next(&ptr, &len));
+
+    char buffer[10];
+    file->read(buffer, 10, 190);
+    checkBytes(buffer, 10, 190);
+    file->readAsync(buffer, 10, 50).get();
+    checkBytes(buffer, 10, 50);
+    EXPECT_THROW(file->read(buffer, 10, 195), ParseError);
+    EXPECT_THROW(SeekableFileInputStream(file.get(), 150, 100, *getDefaultPool()), ParseError);
+  }
+
   TEST_F(TestDecompression, testCreateNone) {
     std::vector<char> bytes(10);
     for (unsigned int i = 0; i < bytes.size(); ++i) {
@@ -666,6 +730,91 @@ namespace orc {
     EXPECT_EQ(16, static_cast<const char*>(ptr)[1]);
   }
 
+  namespace {
+    class AllocationCountingPool : public MemoryPool {
+     public:
+      uint64_t allocCount = 0;
+      uint64_t freeCount = 0;
+
+      char* malloc(uint64_t size) override {
+        ++allocCount;
+        return static_cast<char*>(std::malloc(size));
+      }
+
+      void free(char* p) override {
+        ++freeCount;
+        std::free(p);
+      }
+    };
+  }  // namespace
+
+  TEST(Zlib, testPooledDecompressors) {
+    const unsigned char compressed[] = {0xe, 0x0, 0x0, 0x63, 0x60, 0x64, 0x62, 0xc0, 0x8d, 0x0};
+    const unsigned char original[] = {0xb, 0x0, 0x0, 0x1, 0x2, 0x3, 0x4, 0x5};
+    AllocationCountingPool memoryPool;
+    {
+      std::shared_ptr<DecompressorPool> decompressorPool = createDecompressorPool(memoryPool);
+      auto createStream = [&](const unsigned char* buffer, uint64_t length) {
+        return createDecompressor(CompressionKind_ZLIB,
+                                  std::make_unique<SeekableArrayInputStream>(buffer, length), 1000,
+                                  memoryPool, nullptr, decompressorPool);
+      };
+      const void* ptr;
+      int length;
+
+      // a stream reading uncompressed chunks never borrows a buffer
+      auto stream = createStream(original, ARRAY_SIZE(original));
+      ASSERT_TRUE(stream->Next(&ptr, &length));
+      ASSERT_EQ(5, length);
+      EXPECT_EQ(0, memoryPool.allocCount);
+
+      for (int i = 0; i < 3; ++i) {
+        stream = createStream(compressed, ARRAY_SIZE(compressed));
+        ASSERT_TRUE(stream->Next(&ptr, &length));
+        ASSERT_EQ(30, length);
+        EXPECT_EQ(2, static_cast<const char*>(ptr)[29]);
+        // the buffer of the previous stream is reused
+        EXPECT_EQ(1, memoryPool.allocCount);
+      }
+
+      // streams alive at the same time get their own buffers
+      auto other = createStream(compressed, ARRAY_SIZE(compressed));
+      ASSERT_TRUE(other->Next(&ptr, &length));
+      EXPECT_EQ(2, memoryPool.allocCount);
+    }
+    EXPECT_EQ(memoryPool.allocCount, memoryPool.freeCount);
+  }
+
+  TEST(Zlib, testReleaseIdleDecompressors) {
+    const unsigned char compressed[] = {0xe, 0x0, 0x0, 0x63, 0x60, 0x64, 0x62, 0xc0, 0x8d, 0x0};
+    AllocationCountingPool memoryPool;
+    std::shared_ptr<DecompressorPool> decompressorPool = createDecompressorPool(memoryPool);
+    auto createStream = [&](uint64_t blockSize) {
+      return createDecompressor(
+          CompressionKind_ZLIB,
+          std::make_unique<SeekableArrayInputStream>(compressed, ARRAY_SIZE(compressed)),
+          blockSize, memoryPool, nullptr, decompressorPool);
+    };
+    const void* ptr;
+    int length;
+
+    auto stream = createStream(1000);
+    ASSERT_TRUE(stream->Next(&ptr, &length));
+    ASSERT_EQ(30, length);
+    stream.reset();
+    EXPECT_EQ(1, memoryPool.allocCount);
+    EXPECT_EQ(0, memoryPool.freeCount);
+
+    // the idle buffer of a larger block size isn't used for the 30 bytes
+    stream = createStream(20);
+    EXPECT_THROW(stream->Next(&ptr, &length), CompressionError);
+    stream.reset();
+    EXPECT_EQ(2, memoryPool.allocCount);
+
+    releaseIdleDecompressors(*decompressorPool);
+    EXPECT_EQ(2, memoryPool.freeCount);
+  }
+
 #define HEADER_SIZE 3
 
   class CompressBuffer {
@@ -437,6 +437,25 @@ namespace orc {
     EXPECT_EQ(TruthValue::YES_NO_NULL, evaluate(pred, createIntStats(10, 100, true), &bf));
   }
 
+  TEST(TestPredicateLeaf, testNullEqualsBloomFilter) {
+    BloomFilterImpl bf(10000);
+    for (int64_t i = 20; i < 1000; i++) {
+      bf.addLong(i);
+    }
+    // a null literal is never probed, so the bloom filter doesn't change the result
+    for (auto op : {PredicateLeaf::Operator::EQUALS, PredicateLeaf::Operator::NULL_SAFE_EQUALS}) {
+      PredicateLeaf pred(op, PredicateDataType::LONG, "x", Literal(PredicateDataType::LONG));
+      for (bool hasNull : {true, false}) {
+        EXPECT_EQ(evaluate(pred, createIntStats(10, 100, hasNull)),
+                  evaluate(pred, createIntStats(10, 100, hasNull), &bf));
+      }
+    }
+    PredicateLeaf pred(PredicateLeaf::Operator::EQUALS, PredicateDataType::LONG, "x",
+                       Literal(PredicateDataType::LONG));
+    EXPECT_EQ(TruthValue::YES_NO, evaluate(pred, createIntStats(10, 100, true), &bf));
+    EXPECT_EQ(TruthValue::NO, evaluate(pred, createIntStats(10, 100), &bf));
+  }
+
   TEST(TestPredicateLeaf, testIntInBloomFilter) {
     PredicateLeaf pred(PredicateLeaf::Operator::IN, PredicateDataType::LONG, "x",
                        {Literal(static_cast<int64_t>(15)), Literal(static_cast<int64_t>(19))});
@@ -450,6 +469,34 @@ namespace orc {
     EXPECT_EQ(TruthValue::YES_NO_NULL, evaluate(pred, createIntStats(10, 100, true), &bf));
   }
 
+  TEST(TestPredicateLeaf, testLargeInBloomFilter) {
+    std::vector<Literal> literals;
+    for (int64_t i = 0; i < 2000; ++i) {
+      literals.emplace_back(i * 3);
+    }
+    literals.emplace_back(PredicateDataType::LONG);
+    PredicateLeaf pred(PredicateLeaf::Operator::IN, PredicateDataType::LONG, "x", literals);
+    BloomFilterProbes probes(pred.getBloomHashes());
+
+    // the bloom filters of two row groups, sized so that none of the 2000
+    // literals is a false positive
+    BloomFilterImpl miss(100000, 0.001), hit(100000, 0.001);
+    for (int64_t i = 0; i < 1000; ++i) {
+      miss.addLong(i * 3 + 1);
+      hit.addLong(i * 3 + 1);
+    }
+    hit.addLong(2997);
+    for (auto* probe : {static_cast<BloomFilterProbes*>(nullptr), &probes}) {
+      EXPECT_EQ(TruthValue::NO,
+                pred.evaluate(WriterVersion_ORC_135, createIntStats(0, 6000), &miss, probe));
+      EXPECT_EQ(TruthValue::YES_NO,
+                pred.evaluate(WriterVersion_ORC_135, createIntStats(0, 6000), &hit, probe));
+      // the null literal matches the nulls of the row group
+      EXPECT_EQ(TruthValue::YES_NO_NULL,
+                pred.evaluate(WriterVersion_ORC_135, createIntStats(0, 6000, true), &miss, probe));
+    }
+  }
+
   TEST(TestPredicateLeaf, testDoubleNullSafeEqualsBloomFilter) {
     PredicateLeaf pred(PredicateLeaf::Operator::NULL_SAFE_EQUALS, PredicateDataType::FLOAT, "x",
                        Literal(15.0));
@@ -22,6 +22,8 @@
 #include "orc/sargs/SearchArgument.hh"
 #include "wrap/gtest-wrapper.h"
 
+#include <limits>
+
 namespace orc {
 
   static const int DEFAULT_MEM_STREAM_SIZE = 10 * 1024 * 1024;  // 10M
@@ -667,4 +669,248 @@ namespace orc {
     }
   }
 
+  void createRowFilterTestFile(MemoryOutputStream& memStream, uint64_t numRows) {
+    auto type = Type::buildTypeFromString(
+        "struct<id:bigint,name:string,price:decimal(10,2),ts:timestamp,score:double>");
+    WriterOptions options;
+    options.setStripeSize(16 * 1024)
+        .setRowIndexStride(1000)
+        .setDictionaryKeySizeThreshold(1.0)
+        .setMemoryPool(getDefaultPool());
+    auto writer = createWriter(*type, &memStream, options);
+    auto batch = writer->createRowBatch(numRows);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& ids = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& names = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    auto& prices = dynamic_cast<Decimal64VectorBatch&>(*structBatch.fields[2]);
+    auto& timestamps = dynamic_cast<TimestampVectorBatch&>(*structBatch.fields[3]);
+    auto& scores = dynamic_cast<DoubleVectorBatch&>(*structBatch.fields[4]);
+    static const char* NAMES[] = {"apple", "banana", "cherry", "date"};
+    for (uint64_t i = 0; i < numRows; ++i) {
+      // every 7th id and every 13th name is null
+      ids.notNull[i] = i % 7 != 0;
+      names.notNull[i] = i % 13 != 0;
+      ids.data[i] = static_cast<int64_t>(i);
+      names.data[i] = const_cast<char*>(NAMES[i % 4]);
+      names.length[i] = static_cast<int64_t>(strlen(NAMES[i % 4]));
+      prices.values[i] = static_cast<int64_t>(i % 1000);
+      timestamps.data[i] = static_cast<int64_t>(i / 10);
+      timestamps.nanoseconds[i] = static_cast<int64_t>(i % 10) * 100000000;
+      scores.data[i] = static_cast<double>(i) / 2;
+    }
+    ids.hasNulls = names.hasNulls = true;
+    for (auto* field : structBatch.fields) {
+      field->numElements = numRows;
+    }
+    structBatch.numElements = numRows;
+    writer->add(*batch);
+    writer->close();
+  }
+
+  TEST(TestPredicatePushdown, testFilterRowsBySearchArgument) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t numRows = 5000;
+    createRowFilterTestFile(memStream, numRows);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+
+    struct Param {
+      std::string name;
+      std::function<std::unique_ptr<SearchArgument>()> sarg;
+      std::function<bool(uint64_t)> expected;
+    };
+    const std::vector<Param> params = {
+        {"between or equals",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->startOr()
+               .between("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(100)),
+                        Literal(static_cast<int64_t>(120)))
+               .equals("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(4321)))
+               .end()
+               .build();
+         },
+         [](uint64_t i) { return i % 7 != 0 && ((i >= 100 && i <= 120) || i == 4321); }},
+        {"not less than",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->startNot()
+               .lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(4990)))
+               .end()
+               .build();
+         },
+         [](uint64_t i) { return i % 7 != 0 && i >= 4990; }},
+        {"is null and string in",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->startAnd()
+               .isNull("id", PredicateDataType::LONG)
+               .in("name", PredicateDataType::STRING, {Literal("apple", 5), Literal("date", 4)})
+               .end()
+               .build();
+         },
+         [](uint64_t i) { return i % 7 == 0 && i % 13 != 0 && (i % 4 == 0 || i % 4 == 3); }},
+        {"string range",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->startAnd()
+               .between("name", PredicateDataType::STRING, Literal("b", 1), Literal("cherry", 6))
+               .startNot()
+               .equals("name", PredicateDataType::STRING, Literal("banana", 6))
+               .end()
+               .end()
+               .build();
+         },
+         [](uint64_t i) { return i % 13 != 0 && i % 4 == 2; }},
+        {"null safe equals null",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->nullSafeEquals("name", PredicateDataType::STRING,
+                                Literal(PredicateDataType::STRING))
+               .build();
+         },
+         [](uint64_t i) { return i % 13 == 0; }},
+        {"decimal and timestamp",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->startAnd()
+               .lessThanEquals("price", PredicateDataType::DECIMAL, Literal(Int128(25), 10, 1))
+               .lessThan("ts", PredicateDataType::TIMESTAMP, Literal(int64_t(300), 500000000))
+               .end()
+               .build();
+         },
+         [](uint64_t i) { return i % 1000 <= 250 && i < 3005; }},
+        {"double",
+         [] {
+           return SearchArgumentFactory::newBuilder()
+               ->startNot()
+               .lessThanEquals("score", PredicateDataType::FLOAT, Literal(2400.0))
+               .end()
+               .build();
+         },
+         [](uint64_t i) { return i > 4800; }},
+    };
+
+    for (const auto& param : params) {
+      for (bool lazy : {false, true}) {
+        SCOPED_TRACE(param.name + (lazy ? " lazy" : ""));
+        RowReaderOptions options;
+        options.searchArgument(param.sarg())
+            .setFilterRowsBySearchArgument(true)
+            .setEnableLazyDecoding(lazy);
+        auto rowReader = reader->createRowReader(options);
+        auto batch = rowReader->createRowBatch(1000);
+        std::vector<int64_t> expected;
+        for (uint64_t i = 0; i < numRows; ++i) {
+          if (param.expected(i)) {
+            expected.push_back(static_cast<int64_t>(i));
+          }
+        }
+        std::vector<int64_t> rows;
+        while (rowReader->next(*batch)) {
+          auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+          auto& scores = dynamic_cast<DoubleVectorBatch&>(*structBatch.fields[4]);
+          // lazily decoded names are filtered on their dictionary ids
+          EXPECT_EQ(lazy, structBatch.fields[1]->isEncoded);
+          for (uint64_t i = 0; i < batch->numElements; ++i) {
+            rows.push_back(static_cast<int64_t>(scores.data[i] * 2));
+          }
+        }
+        EXPECT_EQ(expected, rows);
+      }
+    }
+
+    // leaves on unselected columns don't drop rows
+    RowReaderOptions options;
+    options.include(std::list<std::string>{"name"})
+        .searchArgument(
+            SearchArgumentFactory::newBuilder()
+                ->lessThan("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(10)))
+                .build())
+        .setFilterRowsBySearchArgument(true);
+    auto rowReader = reader->createRowReader(options);
+    auto batch = rowReader->createRowBatch(numRows);
+    uint64_t rowsRead = 0;
+    while (rowReader->next(*batch)) {
+      rowsRead += batch->numElements;
+    }
+    EXPECT_EQ(numRows, rowsRead);
+  }
+
+  TEST(TestPredicatePushdown, testFilterRowsWithNaN) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t numRows = 100;
+    {
+      auto type = std::unique_ptr<Type>(Type::buildTypeFromString("struct<x:double>"));
+      WriterOptions options;
+      options.setRowIndexStride(0).setMemoryPool(getDefaultPool());
+      auto writer = createWriter(*type, &memStream, options);
+      auto batch = writer->createRowBatch(numRows);
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& xBatch = dynamic_cast<DoubleVectorBatch&>(*structBatch.fields[0]);
+      for (uint64_t i = 0; i < numRows; ++i) {
+        xBatch.data[i] =
+            i % 4 == 0 ? std::numeric_limits<double>::quiet_NaN() : static_cast<double>(i);
+      }
+      structBatch.numElements = xBatch.numElements = numRows;
+      writer->add(*batch);
+      writer->close();
+    }
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+
+    auto literal = [](double value) { return Literal(value); };
+    struct Param {
+      std::string name;
+      std::unique_ptr<SearchArgument> sarg;
+      std::vector<double> expected;
+    };
+    std::vector<Param> params;
+    params.push_back({"equals", SearchArgumentFactory::newBuilder()
+                                    ->equals("x", PredicateDataType::FLOAT, literal(5))
+                                    .build(),
+                      {5}});
+    params.push_back({"null safe equals",
+                      SearchArgumentFactory::newBuilder()
+                          ->nullSafeEquals("x", PredicateDataType::FLOAT, literal(5))
+                          .build(),
+                      {5}});
+    params.push_back(
+        {"in",
+         SearchArgumentFactory::newBuilder()
+             ->in("x", PredicateDataType::FLOAT, {literal(5), literal(8), literal(9)})
+             .build(),
+         {5, 9}});
+    params.push_back({"less than", SearchArgumentFactory::newBuilder()
+                                       ->lessThan("x", PredicateDataType::FLOAT, literal(5))
+                                       .build(),
+                      {1, 2, 3}});
+    params.push_back({"less than equals",
+                      SearchArgumentFactory::newBuilder()
+                          ->lessThanEquals("x", PredicateDataType::FLOAT, literal(5))
+                          .build(),
+                      {1, 2, 3, 5}});
+    params.push_back(
+        {"between",
+         SearchArgumentFactory::newBuilder()
+             ->between("x", PredicateDataType::FLOAT, literal(3), literal(10))
+             .build(),
+         {3, 5, 6, 7, 9, 10}});
+
+    for (auto& param : params) {
+      SCOPED_TRACE(param.name);
+      RowReaderOptions options;
+      options.searchArgument(std::move(param.sarg)).setFilterRowsBySearchArgument(true);
+      auto rowReader = reader->createRowReader(options);
+      auto batch = rowReader->createRowBatch(numRows);
+      std::vector<double> values;
+      while (rowReader->next(*batch)) {
+        auto& xBatch =
+            dynamic_cast<DoubleVectorBatch&>(*dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+        values.insert(values.end(), xBatch.data.data(), xBatch.data.data() + batch->numElements);
+      }
+      EXPECT_EQ(param.expected, values);
+    }
+  }
+
 }  // namespace orc
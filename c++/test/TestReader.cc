@@ -16,9 +16,14 @@
  * limitations under the License.
  */
 
+#include <cstdio>
 #include <cstring>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
 
 #include "Reader.hh"
+#include "orc/ColumnPrinter.hh"
 #include "orc/Reader.hh"
 
 #include "Adaptor.hh"
@@ -1103,14 +1108,52 @@ namespace orc {
     }
   }
 
+  TEST(TestMemoryMap, testReadMappedFile) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t totalRows = writeSampleData(memStream);
+    const char* fileName = "memory-map-test.orc";
+    {
+      std::unique_ptr<OutputStream> file = writeLocalFile(fileName);
+      file->write(memStream.getData(), memStream.getLength());
+      file->close();
+    }
+
+    LocalFileOptions fileOptions;
+    fileOptions.memoryMap = true;
+    std::unique_ptr<InputStream> file = readLocalFile(fileName, nullptr, fileOptions);
+    const char* mapped = file->getMappedData();
+    ASSERT_NE(nullptr, mapped);
+    auto reader = createReader(std::move(file), {});
+    ASSERT_GE(reader->getNumberOfStripes(), 2UL);
+
+    auto rowReader = reader->createRowReader(RowReaderOptions{}.setEnableAsyncPrefetch(true));
+    auto batch = rowReader->createRowBatch(1000);
+    uint64_t row = 0;
+    while (rowReader->next(*batch)) {
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++row) {
+        std::string expected = "name_" + std::to_string(row);
+        ASSERT_EQ(expected,
+                  std::string(nameBatch.data[i], static_cast<size_t>(nameBatch.length[i])));
+        // uncompressed strings are not copied out of the mapping
+        EXPECT_GE(nameBatch.data[i], mapped);
+        EXPECT_LT(nameBatch.data[i], mapped + memStream.getLength());
+      }
+    }
+    EXPECT_EQ(totalRows, row);
+    std::remove(fileName);
+  }
+
   class IOCountingInputStream : public InputStream {
    private:
     std::unique_ptr<InputStream> wrapped_;
     mutable std::atomic<uint64_t> readCount_;
+    std::atomic<uint64_t> readBytes_;
 
    public:
     IOCountingInputStream(std::unique_ptr<InputStream> wrapped)
-        : wrapped_(std::move(wrapped)), readCount_(0) {}
+        : wrapped_(std::move(wrapped)), readCount_(0), readBytes_(0) {}
 
     uint64_t getLength() const override {
       return wrapped_->getLength();
@@ -1122,6 +1165,7 @@ namespace orc {
 
     void read(void* buf, uint64_t length, uint64_t offset) override {
       readCount_.fetch_add(1, std::memory_order_relaxed);
+      readBytes_.fetch_add(length, std::memory_order_relaxed);
       wrapped_->read(buf, length, offset);
     }
 
@@ -1135,6 +1179,11 @@ namespace orc {
 
     void resetReadCount() {
       readCount_.store(0, std::memory_order_relaxed);
+      readBytes_.store(0, std::memory_order_relaxed);
+    }
+
+    uint64_t getReadBytes() const {
+      return readBytes_.load(std::memory_order_relaxed);
     }
   };
 
@@ -1240,6 +1289,865 @@ namespace orc {
     EXPECT_LT(largeLimitIOCount, smallLimitIOCount);
   }
 
+  TEST(TestAsyncPrefetch, testDefaultReadAsyncRecordsMetrics) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t totalRows = writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+
+    // the stream only implements read(), so prefetching goes through the
+    // default readAsync()
+    auto countingStream = std::make_unique<IOCountingInputStream>(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()));
+    auto* countingPtr = countingStream.get();
+    ReaderMetrics metrics;
+    ReaderOptions readerOptions;
+    readerOptions.setReaderMetrics(&metrics);
+    auto reader = createReader(std::move(countingStream), readerOptions);
+
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.setEnableAsyncPrefetch(true);
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+    countingPtr->resetReadCount();
+    metrics.IOCount.store(0);
+    EXPECT_EQ(totalRows, readAllRows(*rowReader));
+
+    EXPECT_LT(0, countingPtr->getReadCount());
+#if ENABLE_METRICS
+    // the stream records no metrics itself, so these are the prefetched reads
+    EXPECT_LT(0, metrics.IOCount.load());
+#endif
+  }
+
+  TEST(TestFileTailCache, testReaderUsesCachedTail) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t totalRows = writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+
+    std::shared_ptr<FileTailCache> cache = createFileTailCache(1024 * 1024);
+    ReaderMetrics metrics;
+    ReaderOptions readerOptions;
+    readerOptions.setFileTailCache(cache, "v1").setReaderMetrics(&metrics);
+    uint64_t numStripeStatistics = 0;
+
+    // the first reader reads the tail and caches it with the stripe statistics
+    {
+      auto countingStream = std::make_unique<IOCountingInputStream>(
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()));
+      auto* countingPtr = countingStream.get();
+      auto reader = createReader(std::move(countingStream), readerOptions);
+      EXPECT_GT(countingPtr->getReadCount(), 0UL);
+      numStripeStatistics = reader->getNumberOfStripeStatistics();
+      EXPECT_GT(numStripeStatistics, 1UL);
+    }
+    EXPECT_EQ(0, metrics.FileTailCacheHits.load());
+    EXPECT_EQ(1, metrics.FileTailCacheMisses.load());
+
+    // the next ones only read the stripes
+    {
+      auto countingStream = std::make_unique<IOCountingInputStream>(
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()));
+      auto* countingPtr = countingStream.get();
+      auto reader = createReader(std::move(countingStream), readerOptions);
+      EXPECT_EQ(numStripeStatistics, reader->getNumberOfStripeStatistics());
+      EXPECT_EQ(0UL, countingPtr->getReadCount());
+      EXPECT_EQ(totalRows, reader->getNumberOfRows());
+      auto rowReader = reader->createRowReader(RowReaderOptions());
+      EXPECT_EQ(totalRows, readAllRows(*rowReader));
+    }
+    EXPECT_EQ(1, metrics.FileTailCacheHits.load());
+    EXPECT_EQ(1, metrics.FileTailCacheMisses.load());
+
+    // another version of the file doesn't match
+    readerOptions.setFileTailCache(cache, "v2");
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    EXPECT_EQ(totalRows, reader->getNumberOfRows());
+    EXPECT_EQ(1, metrics.FileTailCacheHits.load());
+    EXPECT_EQ(2, metrics.FileTailCacheMisses.load());
+  }
+
+  namespace {
+    class FakeFileTail : public CachedFileTail {
+     public:
+      explicit FakeFileTail(uint64_t memoryUsage) : memoryUsage_(memoryUsage) {}
+
+      uint64_t getMemoryUsage() const override {
+        return memoryUsage_;
+      }
+
+      void setMemoryUsage(uint64_t memoryUsage) {
+        memoryUsage_ = memoryUsage;
+      }
+
+     private:
+      std::atomic<uint64_t> memoryUsage_;
+    };
+
+    // keeps the last tail that was put
+    class LastTailCache : public FileTailCache {
+     public:
+      std::shared_ptr<const CachedFileTail> lastTail;
+
+      std::shared_ptr<const CachedFileTail> get(const std::string&) override {
+        return nullptr;
+      }
+
+      void put(const std::string&, std::shared_ptr<const CachedFileTail> tail) override {
+        lastTail = std::move(tail);
+      }
+    };
+  }  // namespace
+
+  TEST(TestFileTailCache, testEvictLeastRecentlyUsed) {
+    std::shared_ptr<FileTailCache> cache = createFileTailCache(100);
+    auto a = std::make_shared<FakeFileTail>(40);
+    auto b = std::make_shared<FakeFileTail>(40);
+    cache->put("a", a);
+    cache->put("b", b);
+    EXPECT_EQ(a, cache->get("a"));
+    cache->put("c", std::make_shared<FakeFileTail>(40));
+    EXPECT_EQ(nullptr, cache->get("b"));
+    EXPECT_EQ(a, cache->get("a"));
+    EXPECT_NE(nullptr, cache->get("c"));
+
+    // replacing a tail releases its memory
+    cache->put("a", b);
+    EXPECT_EQ(b, cache->get("a"));
+    EXPECT_NE(nullptr, cache->get("c"));
+
+    // a tail larger than the cache isn't kept
+    cache->put("d", std::make_shared<FakeFileTail>(101));
+    EXPECT_EQ(nullptr, cache->get("d"));
+    EXPECT_NE(nullptr, cache->get("c"));
+  }
+
+  TEST(TestFileTailCache, testEvictGrowingTails) {
+    std::shared_ptr<FileTailCache> cache = createFileTailCache(100);
+    auto a = std::make_shared<FakeFileTail>(30);
+    auto b = std::make_shared<FakeFileTail>(30);
+    auto c = std::make_shared<FakeFileTail>(30);
+    cache->put("a", a);
+    cache->put("b", b);
+    cache->put("c", c);
+
+    // a tail that grows is measured again when it is looked up
+    a->setMemoryUsage(60);
+    EXPECT_EQ(a, cache->get("a"));
+    EXPECT_EQ(nullptr, cache->get("b"));
+    EXPECT_EQ(c, cache->get("c"));
+
+    // and all of them when another one is added
+    a->setMemoryUsage(70);
+    cache->put("d", std::make_shared<FakeFileTail>(10));
+    EXPECT_EQ(nullptr, cache->get("a"));
+    EXPECT_EQ(c, cache->get("c"));
+    EXPECT_NE(nullptr, cache->get("d"));
+  }
+
+  TEST(TestFileTailCache, testCountDecodedStatistics) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+
+    auto cache = std::make_shared<LastTailCache>();
+    ReaderOptions readerOptions;
+    readerOptions.setFileTailCache(cache, "v1");
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        readerOptions);
+    // loading the metadata caches a tail with it
+    EXPECT_GT(reader->getNumberOfStripeStatistics(), 1UL);
+    std::shared_ptr<const CachedFileTail> tail = cache->lastTail;
+    ASSERT_NE(nullptr, tail);
+    uint64_t memoryUsage = tail->getMemoryUsage();
+
+    auto sarg = SearchArgumentFactory::newBuilder()
+                    ->lessThan(1, PredicateDataType::LONG, Literal(static_cast<int64_t>(10)))
+                    .build();
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.searchArgument(std::move(sarg));
+    auto rowReader = reader->createRowReader(rowReaderOptions);
+    // the stripe statistics of id are decoded to skip all but the first row group
+    EXPECT_EQ(100UL, readAllRows(*rowReader));
+    EXPECT_GT(tail->getMemoryUsage(), memoryUsage);
+  }
+
+  TEST(TestIndexCache, testRowReadersShareIndexes) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      auto type = Type::buildTypeFromString("struct<id:bigint,name:string>");
+      WriterOptions options;
+      options.setRowIndexStride(1000).setColumnsUseBloomFilter({1}).setMemoryBlockSize(64);
+      auto writer = createWriter(*type, &memStream, options);
+      auto batch = writer->createRowBatch(10000);
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+      auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+      std::string name = "name";
+      for (uint64_t i = 0; i < 10000; ++i) {
+        idBatch.data[i] = static_cast<int64_t>(i);
+        nameBatch.data[i] = const_cast<char*>(name.c_str());
+        nameBatch.length[i] = static_cast<int64_t>(name.size());
+      }
+      structBatch.numElements = idBatch.numElements = nameBatch.numElements = 10000;
+      writer->add(*batch);
+      writer->close();
+    }
+
+    ReaderMetrics metrics;
+    ReaderOptions readerOptions;
+    readerOptions.setIndexCacheMemory(1024 * 1024).setReaderMetrics(&metrics);
+    auto countingStream = std::make_unique<IOCountingInputStream>(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()));
+    auto* countingPtr = countingStream.get();
+    auto reader = createReader(std::move(countingStream), readerOptions);
+
+    auto lookup = [&](int64_t id) {
+      RowReaderOptions rowReaderOptions;
+      rowReaderOptions.searchArgument(
+          SearchArgumentFactory::newBuilder()
+              ->equals("id", PredicateDataType::LONG, Literal(id))
+              .build());
+      auto rowReader = reader->createRowReader(rowReaderOptions);
+      auto batch = rowReader->createRowBatch(1000);
+      EXPECT_TRUE(rowReader->next(*batch));
+      auto& ids = dynamic_cast<LongVectorBatch&>(
+          *dynamic_cast<StructVectorBatch&>(*batch).fields[0]);
+      EXPECT_EQ(id / 1000 * 1000, ids.data[0]);
+    };
+
+    // the first lookup parses the row indexes of the 3 columns and the bloom filters of id
+    countingPtr->resetReadCount();
+    lookup(1234);
+    uint64_t uncachedReads = countingPtr->getReadCount();
+    EXPECT_EQ(0, metrics.IndexCacheHits.load());
+    EXPECT_EQ(4, metrics.IndexCacheMisses.load());
+
+    countingPtr->resetReadCount();
+    lookup(5678);
+    EXPECT_EQ(4, metrics.IndexCacheHits.load());
+    EXPECT_EQ(4, metrics.IndexCacheMisses.load());
+    EXPECT_LT(countingPtr->getReadCount(), uncachedReads);
+
+    // the cache is shared with the index accessors of the reader
+    auto rowGroupIndex = reader->getRowGroupIndex(0, {1});
+    auto bloomFilters = reader->getBloomFilters(0, {1});
+    EXPECT_EQ(6, metrics.IndexCacheHits.load());
+    EXPECT_EQ(4, metrics.IndexCacheMisses.load());
+    ASSERT_EQ(10, rowGroupIndex[1].positions.size());
+    ASSERT_EQ(10, bloomFilters[1].entries.size());
+    EXPECT_TRUE(bloomFilters[1].entries[3]->testLong(3456));
+
+    auto uncachedReader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+        ReaderOptions());
+    EXPECT_EQ(uncachedReader->getRowGroupIndex(0, {1})[1].positions, rowGroupIndex[1].positions);
+  }
+
+  TEST(TestIndexCache, testPrefetchMissingIndexes) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    {
+      auto type = Type::buildTypeFromString("struct<id:bigint,name:string>");
+      WriterOptions options;
+      options.setRowIndexStride(1000).setColumnsUseBloomFilter({1}).setMemoryBlockSize(64);
+      auto writer = createWriter(*type, &memStream, options);
+      auto batch = writer->createRowBatch(10000);
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+      auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+      std::string name = "name";
+      for (uint64_t i = 0; i < 10000; ++i) {
+        idBatch.data[i] = static_cast<int64_t>(i);
+        nameBatch.data[i] = const_cast<char*>(name.c_str());
+        nameBatch.length[i] = static_cast<int64_t>(name.size());
+      }
+      structBatch.numElements = idBatch.numElements = nameBatch.numElements = 10000;
+      writer->add(*batch);
+      writer->close();
+    }
+
+    auto countingStream = std::make_unique<IOCountingInputStream>(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()));
+    auto* countingPtr = countingStream.get();
+    ReaderOptions readerOptions;
+    readerOptions.setIndexCacheMemory(1024 * 1024);
+    auto reader = createReader(std::move(countingStream), readerOptions);
+    uint64_t nameRowIndexLength = 0;
+    auto stripe = reader->getStripe(0);
+    for (uint64_t i = 0; i < stripe->getNumberOfStreams(); ++i) {
+      auto stream = stripe->getStreamInformation(i);
+      if (stream->getColumnId() == 2 && stream->getKind() == StreamKind_ROW_INDEX) {
+        nameRowIndexLength = stream->getLength();
+      }
+    }
+    ASSERT_GT(nameRowIndexLength, 0);
+
+    auto lookup = [&](const std::list<std::string>& columns) {
+      RowReaderOptions rowReaderOptions;
+      rowReaderOptions.include(columns).setEnableAsyncPrefetch(true).searchArgument(
+          SearchArgumentFactory::newBuilder()
+              ->equals("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(1234)))
+              .build());
+      countingPtr->resetReadCount();
+      auto rowReader = reader->createRowReader(rowReaderOptions);
+      auto batch = rowReader->createRowBatch(1000);
+      EXPECT_TRUE(rowReader->next(*batch));
+      return countingPtr->getReadBytes();
+    };
+
+    // with the indexes of id cached, only the row index of name is fetched
+    lookup({"id"});
+    uint64_t partlyCachedBytes = lookup({"id", "name"});
+    uint64_t cachedBytes = lookup({"id", "name"});
+    EXPECT_EQ(cachedBytes + nameRowIndexLength, partlyCachedBytes);
+  }
+
+  TEST(TestIndexCache, testEvictLeastRecentlyUsed) {
+    auto bloomFilters = std::make_shared<BloomFilterIndex>();
+    IndexCache cache(100, nullptr);
+    cache.putBloomFilters(0, 1, bloomFilters, 40);
+    cache.putBloomFilters(0, 2, bloomFilters, 40);
+    EXPECT_EQ(bloomFilters, cache.getBloomFilters(0, 1));
+    EXPECT_EQ(nullptr, cache.getRowIndex(0, 1));
+    cache.putBloomFilters(1, 1, bloomFilters, 40);
+    EXPECT_EQ(nullptr, cache.getBloomFilters(0, 2));
+    EXPECT_EQ(80, cache.getMemoryUsage());
+
+    // indexes larger than the cache aren't kept
+    cache.putBloomFilters(2, 1, bloomFilters, 101);
+    EXPECT_EQ(nullptr, cache.getBloomFilters(2, 1));
+    EXPECT_EQ(80, cache.getMemoryUsage());
+  }
+
+  TEST(TestAsyncPrefetch, testPrefetchSelectedRowGroups) {
+    for (auto compression : {CompressionKind_NONE, CompressionKind_ZLIB}) {
+      SCOPED_TRACE(compressionKindToString(compression));
+      MemoryOutputStream memStream(16 * DEFAULT_MEM_STREAM_SIZE);
+      {
+        auto type = Type::buildTypeFromString("struct<id:bigint,name:string,flag:boolean>");
+        WriterOptions options;
+        options.setCompression(compression)
+            .setRowIndexStride(1000)
+            .setCompressionBlockSize(4096)
+            .setMemoryBlockSize(64);
+        auto writer = createWriter(*type, &memStream, options);
+        auto batch = writer->createRowBatch(20000);
+        auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+        auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+        auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+        auto& flagBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[2]);
+        std::vector<std::string> names(20000);
+        for (uint64_t i = 0; i < 20000; ++i) {
+          idBatch.data[i] = static_cast<int64_t>(i);
+          names[i] = "name_" + std::to_string(i * 7919 % 100003) + std::string(i % 40, 'x');
+          nameBatch.data[i] = const_cast<char*>(names[i].c_str());
+          nameBatch.length[i] = static_cast<int64_t>(names[i].size());
+          flagBatch.data[i] = i % 3 == 0;
+          flagBatch.notNull[i] = i % 5 != 0;
+        }
+        flagBatch.hasNulls = true;
+        structBatch.numElements = idBatch.numElements = nameBatch.numElements =
+            flagBatch.numElements = 20000;
+        writer->add(*batch);
+        writer->close();
+      }
+
+      auto readSelected = [&memStream](bool usePredicate, uint64_t& readBytes,
+                                       ReaderMetrics& metrics) {
+        auto countingStream = std::make_unique<IOCountingInputStream>(
+            std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()));
+        auto* countingPtr = countingStream.get();
+        ReaderOptions readerOptions;
+        readerOptions.setReaderMetrics(&metrics);
+        auto reader = createReader(std::move(countingStream), readerOptions);
+        RowReaderOptions rowReaderOptions;
+        // don't read the small stripe as a whole
+        rowReaderOptions.setEnableAsyncPrefetch(true).setSmallStripeLookAheadLimit(0);
+        if (usePredicate) {
+          rowReaderOptions.searchArgument(
+              SearchArgumentFactory::newBuilder()
+                  ->between("id", PredicateDataType::LONG, Literal(static_cast<int64_t>(12100)),
+                            Literal(static_cast<int64_t>(12200)))
+                  .build());
+        }
+        auto rowReader = reader->createRowReader(rowReaderOptions);
+        countingPtr->resetReadCount();
+        auto batch = rowReader->createRowBatch(1000);
+        std::vector<int64_t> ids;
+        while (rowReader->next(*batch)) {
+          auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+          auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+          auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+          auto& flagBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[2]);
+          for (uint64_t i = 0; i < batch->numElements; ++i) {
+            uint64_t id = static_cast<uint64_t>(idBatch.data[i]);
+            std::string name = "name_" + std::to_string(id * 7919 % 100003) +
+                               std::string(id % 40, 'x');
+            EXPECT_EQ(name,
+                      std::string(nameBatch.data[i], static_cast<size_t>(nameBatch.length[i])));
+            EXPECT_EQ(id % 5 != 0, flagBatch.notNull[i] != 0);
+            if (flagBatch.notNull[i]) {
+              EXPECT_EQ(id % 3 == 0, flagBatch.data[i] != 0);
+            }
+            ids.push_back(idBatch.data[i]);
+          }
+        }
+        readBytes = countingPtr->getReadBytes();
+        return ids;
+      };
+
+      uint64_t allBytes = 0;
+      uint64_t selectedBytes = 0;
+      ReaderMetrics allMetrics;
+      ReaderMetrics selectedMetrics;
+      EXPECT_EQ(20000, readSelected(false, allBytes, allMetrics).size());
+      std::vector<int64_t> ids = readSelected(true, selectedBytes, selectedMetrics);
+      // only the row group of rows [12000, 13000) survives
+      ASSERT_EQ(1000, ids.size());
+      EXPECT_EQ(12000, ids.front());
+      EXPECT_EQ(12999, ids.back());
+      EXPECT_LT(selectedBytes * 4, allBytes);
+      // streams prefetched in parts are served from the cache without misses
+      EXPECT_LT(0, selectedMetrics.ReadRangeCacheHits.load());
+      EXPECT_EQ(0, selectedMetrics.ReadRangeCacheMisses.load());
+    }
+  }
+
+  TEST(TestAsyncPrefetch, testPrefetchWindow) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t totalRows = writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+    ASSERT_GT(reader->getNumberOfStripes(), 3UL);
+
+    for (uint64_t windowSize :
+         {uint64_t(1), uint64_t(4096), std::numeric_limits<uint64_t>::max()}) {
+      SCOPED_TRACE(windowSize);
+      for (bool usePredicate : {false, true}) {
+        RowReaderOptions options;
+        options.setEnableAsyncPrefetch(true).setPrefetchWindowSize(windowSize);
+        if (usePredicate) {
+          options.searchArgument(SearchArgumentFactory::newBuilder()
+                                     ->lessThan("id", PredicateDataType::LONG,
+                                                Literal(static_cast<int64_t>(100)))
+                                     .build());
+        }
+        auto rowReader = reader->createRowReader(options);
+        auto batch = rowReader->createRowBatch(128);
+        uint64_t row = 0;
+        while (rowReader->next(*batch)) {
+          auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+          auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+          auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+          for (uint64_t i = 0; i < batch->numElements; ++i, ++row) {
+            EXPECT_EQ(static_cast<int64_t>(row), idBatch.data[i]);
+            EXPECT_EQ("name_" + std::to_string(row),
+                      std::string(nameBatch.data[i], static_cast<size_t>(nameBatch.length[i])));
+          }
+        }
+        EXPECT_EQ(usePredicate ? 100 : totalRows, row);
+      }
+    }
+  }
+
+  TEST(TestParallelScan, testReadAllRows) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    uint64_t totalRows = writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+    ASSERT_GT(reader->getNumberOfStripes(), 3UL);
+
+    for (bool enableAsyncPrefetch : {false, true}) {
+      for (bool usePredicate : {false, true}) {
+        SCOPED_TRACE(std::to_string(enableAsyncPrefetch) + std::to_string(usePredicate));
+        RowReaderOptions options;
+        options.setEnableAsyncPrefetch(enableAsyncPrefetch);
+        if (usePredicate) {
+          options.searchArgument(SearchArgumentFactory::newBuilder()
+                                     ->lessThan("id", PredicateDataType::LONG,
+                                                Literal(static_cast<int64_t>(150)))
+                                     .build());
+        }
+        auto scan = reader->createParallelScan(options, 4);
+        EXPECT_EQ("struct<id:int,name:string,value:double>", scan->getSelectedType().toString());
+
+        std::mutex mutex;
+        std::vector<int> seen(totalRows, 0);
+        scan->run(64, [&](ColumnVectorBatch& batch, uint64_t rowNumber) {
+          auto& structBatch = dynamic_cast<StructVectorBatch&>(batch);
+          auto& idBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+          auto& nameBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+          std::lock_guard<std::mutex> lock(mutex);
+          for (uint64_t i = 0; i < batch.numElements; ++i) {
+            uint64_t row = rowNumber + i;
+            EXPECT_EQ(static_cast<int64_t>(row), idBatch.data[i]);
+            EXPECT_EQ("name_" + std::to_string(row),
+                      std::string(nameBatch.data[i], static_cast<size_t>(nameBatch.length[i])));
+            seen[row] += 1;
+          }
+        });
+        for (uint64_t row = 0; row < totalRows; ++row) {
+          EXPECT_LE(seen[row], 1) << row;
+          // the predicate only drops whole row groups past the matching rows
+          if (!usePredicate || row < 150) {
+            EXPECT_EQ(1, seen[row]) << row;
+          }
+        }
+      }
+    }
+  }
+
+  TEST(TestParallelScan, testConsumerException) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    std::ignore = writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+    auto scan = reader->createParallelScan(RowReaderOptions(), 2);
+    EXPECT_THROW(scan->run(64,
+                           [](ColumnVectorBatch&, uint64_t rowNumber) {
+                             if (rowNumber >= 256) {
+                               throw std::runtime_error("stop");
+                             }
+                           }),
+                 std::runtime_error);
+  }
+
+  TEST(TestParallelScan, testMetricsMatchRowReader) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    std::ignore = writeSampleData(memStream, /*stripeSize*/ 1024, /*rowsPerStripe*/ 200);
+    RowReaderOptions options;
+    options.searchArgument(SearchArgumentFactory::newBuilder()
+                               ->lessThan("id", PredicateDataType::LONG,
+                                          Literal(static_cast<int64_t>(350)))
+                               .build());
+    auto openReader = [&memStream](ReaderMetrics& metrics) {
+      ReaderOptions readerOptions;
+      readerOptions.setReaderMetrics(&metrics);
+      return createReader(
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()),
+          readerOptions);
+    };
+
+    ReaderMetrics rowReaderMetrics;
+    auto reader = openReader(rowReaderMetrics);
+    auto rowReader = reader->createRowReader(options);
+    auto batch = rowReader->createRowBatch(64);
+    while (rowReader->next(*batch)) {
+    }
+
+    // the file statistics are evaluated once, not once per thread or stripe
+    ReaderMetrics scanMetrics;
+    reader = openReader(scanMetrics);
+    reader->createParallelScan(options, 4)->run(64, [](ColumnVectorBatch&, uint64_t) {});
+    EXPECT_LT(0, scanMetrics.EvaluatedRowGroupCount.load());
+    EXPECT_EQ(rowReaderMetrics.EvaluatedRowGroupCount.load(),
+              scanMetrics.EvaluatedRowGroupCount.load());
+    EXPECT_EQ(rowReaderMetrics.SelectedRowGroupCount.load(),
+              scanMetrics.SelectedRowGroupCount.load());
+  }
+
+  TEST(TestColumnDecodePool, testPinnedThreads) {
+    ColumnDecodePool pool(3);
+    EXPECT_EQ(3, pool.getNumThreads());
+    std::vector<std::thread::id> firstRun(8);
+    pool.run(8, [&firstRun](size_t i) { firstRun[i] = std::this_thread::get_id(); });
+    std::vector<std::thread::id> secondRun(8);
+    pool.run(8, [&secondRun](size_t i) { secondRun[i] = std::this_thread::get_id(); });
+    EXPECT_EQ(firstRun, secondRun);
+    EXPECT_EQ(firstRun[0], firstRun[3]);
+    EXPECT_NE(firstRun[0], firstRun[1]);
+    EXPECT_NE(std::this_thread::get_id(), firstRun[0]);
+
+    EXPECT_THROW(pool.run(8,
+                          [](size_t i) {
+                            if (i == 5) {
+                              throw ParseError("bad column");
+                            }
+                          }),
+                 ParseError);
+    // the pool is still usable after a failed run
+    std::atomic<size_t> count(0);
+    pool.run(8, [&count](size_t) { count++; });
+    EXPECT_EQ(8, count.load());
+  }
+
+  TEST(TestParallelDecode, testMatchesSequentialDecode) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t numColumns = 12;
+    const uint64_t numRows = 10000;
+    {
+      std::string schema = "struct<";
+      for (uint64_t col = 0; col < numColumns; ++col) {
+        schema += (col > 0 ? ",c" : "c") + std::to_string(col) + (col % 2 ? ":string" : ":bigint");
+      }
+      auto type = Type::buildTypeFromString(schema + ">");
+      WriterOptions options;
+      options.setCompression(CompressionKind_ZLIB).setRowIndexStride(1000).setStripeSize(64 * 1024);
+      auto writer = createWriter(*type, &memStream, options);
+      auto batch = writer->createRowBatch(numRows);
+      auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+      std::vector<std::string> names(numRows);
+      for (uint64_t row = 0; row < numRows; ++row) {
+        names[row] = "value_" + std::to_string(row * 31 % 977);
+      }
+      for (uint64_t col = 0; col < numColumns; ++col) {
+        for (uint64_t row = 0; row < numRows; ++row) {
+          if (col % 2) {
+            auto& strings = dynamic_cast<StringVectorBatch&>(*structBatch.fields[col]);
+            strings.data[row] = const_cast<char*>(names[(row + col) % numRows].c_str());
+            strings.length[row] = static_cast<int64_t>(names[(row + col) % numRows].size());
+          } else {
+            auto& longs = dynamic_cast<LongVectorBatch&>(*structBatch.fields[col]);
+            longs.data[row] = static_cast<int64_t>(row * col);
+          }
+        }
+        structBatch.fields[col]->numElements = numRows;
+      }
+      structBatch.numElements = numRows;
+      writer->add(*batch);
+      writer->close();
+    }
+
+    auto readRows = [&memStream](uint32_t decodeThreads) {
+      auto reader = createReader(
+          std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+      auto rowReader = reader->createRowReader(RowReaderOptions().setDecodeThreads(decodeThreads));
+      auto batch = rowReader->createRowBatch(1024);
+      std::vector<std::string> rows;
+      // skip within the first stripe to cover the concurrent skip as well
+      rowReader->seekToRow(1500);
+      while (rowReader->next(*batch)) {
+        auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+        for (uint64_t row = 0; row < batch->numElements; ++row) {
+          std::string line;
+          for (uint64_t col = 0; col < structBatch.fields.size(); ++col) {
+            if (col % 2) {
+              auto& strings = dynamic_cast<StringVectorBatch&>(*structBatch.fields[col]);
+              line += std::string(strings.data[row], static_cast<size_t>(strings.length[row]));
+            } else {
+              line += std::to_string(
+                  dynamic_cast<LongVectorBatch&>(*structBatch.fields[col]).data[row]);
+            }
+            line += ",";
+          }
+          rows.push_back(line);
+        }
+      }
+      return rows;
+    };
+
+    std::vector<std::string> expected = readRows(1);
+    EXPECT_EQ(numRows - 1500, expected.size());
+    EXPECT_EQ(expected, readRows(4));
+  }
+
+  namespace {
+
+    // Write rows with nested and nullable columns; value i of each column is
+    // derived from the row number so readers can check it.
+    void writeRowFilterData(MemoryOutputStream& memStream, uint64_t numRows) {
+      auto type = Type::buildTypeFromString(
+          "struct<id:bigint,name:string,tags:array<int>,attrs:map<string,double>,"
+          "choice:uniontype<int,string>,ts:timestamp,price:decimal(10,2),"
+          "amount:decimal(25,5),flag:boolean>");
+      WriterOptions options;
+      options.setStripeSize(16 * 1024).setRowIndexStride(1000).setCompression(CompressionKind_ZLIB);
+      auto writer = createWriter(*type, &memStream, options);
+      const uint64_t batchSize = 1000;
+      auto batch = writer->createRowBatch(batchSize);
+      auto& root = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& ids = dynamic_cast<LongVectorBatch&>(*root.fields[0]);
+      auto& names = dynamic_cast<StringVectorBatch&>(*root.fields[1]);
+      auto& tags = dynamic_cast<ListVectorBatch&>(*root.fields[2]);
+      auto& tagValues = dynamic_cast<LongVectorBatch&>(*tags.elements);
+      auto& attrs = dynamic_cast<MapVectorBatch&>(*root.fields[3]);
+      auto& attrKeys = dynamic_cast<StringVectorBatch&>(*attrs.keys);
+      auto& attrValues = dynamic_cast<DoubleVectorBatch&>(*attrs.elements);
+      auto& choice = dynamic_cast<UnionVectorBatch&>(*root.fields[4]);
+      auto& choiceInts = dynamic_cast<LongVectorBatch&>(*choice.children[0]);
+      auto& choiceStrings = dynamic_cast<StringVectorBatch&>(*choice.children[1]);
+      auto& ts = dynamic_cast<TimestampVectorBatch&>(*root.fields[5]);
+      auto& prices = dynamic_cast<Decimal64VectorBatch&>(*root.fields[6]);
+      auto& amounts = dynamic_cast<Decimal128VectorBatch&>(*root.fields[7]);
+      auto& flags = dynamic_cast<LongVectorBatch&>(*root.fields[8]);
+
+      static const char* KEYS[] = {"a", "bb", "ccc"};
+      std::vector<std::string> strings(batchSize);
+      tagValues.resize(batchSize * 3);
+      attrKeys.resize(batchSize * 3);
+      attrValues.resize(batchSize * 3);
+      for (auto* children : std::vector<ColumnVectorBatch*>{&tagValues, &attrKeys, &attrValues}) {
+        memset(children->notNull.data(), 1, batchSize * 3);
+      }
+      for (uint64_t base = 0; base < numRows; base += batchSize) {
+        uint64_t count = std::min(batchSize, numRows - base);
+        uint64_t tagCount = 0;
+        uint64_t attrCount = 0;
+        uint64_t intCount = 0;
+        uint64_t stringCount = 0;
+        tags.offsets[0] = 0;
+        attrs.offsets[0] = 0;
+        for (uint64_t i = 0; i < count; ++i) {
+          uint64_t row = base + i;
+          ids.data[i] = static_cast<int64_t>(row);
+          strings[i] = "name_" + std::to_string(row * 13 % 101);
+          names.notNull[i] = row % 11 != 0;
+          names.data[i] = const_cast<char*>(strings[i].c_str());
+          names.length[i] = static_cast<int64_t>(strings[i].size());
+          for (uint64_t j = 0; j < row % 4; ++j) {
+            tagValues.data[tagCount++] = static_cast<int64_t>(row + j);
+          }
+          tags.offsets[i + 1] = static_cast<int64_t>(tagCount);
+          for (uint64_t j = 0; j < row % 3; ++j) {
+            attrKeys.data[attrCount] = const_cast<char*>(KEYS[j]);
+            attrKeys.length[attrCount] = static_cast<int64_t>(j + 1);
+            attrValues.data[attrCount++] = static_cast<double>(row) / 4;
+          }
+          attrs.offsets[i + 1] = static_cast<int64_t>(attrCount);
+          choice.tags[i] = row % 2;
+          if (row % 2 == 0) {
+            choice.offsets[i] = intCount;
+            choiceInts.data[intCount++] = static_cast<int64_t>(row * 3);
+          } else {
+            choice.offsets[i] = stringCount;
+            choiceStrings.data[stringCount] = const_cast<char*>(strings[i].c_str());
+            choiceStrings.length[stringCount++] = static_cast<int64_t>(strings[i].size());
+          }
+          ts.data[i] = static_cast<int64_t>(row * 1000);
+          ts.nanoseconds[i] = static_cast<int64_t>(row % 1000);
+          prices.values[i] = static_cast<int64_t>(row * 7);
+          amounts.values[i] = Int128(static_cast<int64_t>(row));
+          amounts.values[i] *= Int128(1000000007);
+          flags.notNull[i] = row % 5 != 0;
+          flags.data[i] = row % 3 == 0;
+        }
+        names.hasNulls = flags.hasNulls = true;
+        tags.elements->numElements = tagCount;
+        attrs.keys->numElements = attrs.elements->numElements = attrCount;
+        choiceInts.numElements = intCount;
+        choiceStrings.numElements = stringCount;
+        for (auto* field : root.fields) {
+          field->numElements = count;
+        }
+        root.numElements = count;
+        writer->add(*batch);
+      }
+      writer->close();
+    }
+
+    std::vector<std::string> printRows(RowReader& rowReader, uint64_t batchSize) {
+      std::vector<std::string> rows;
+      std::string line;
+      auto printer = createColumnPrinter(line, &rowReader.getSelectedType());
+      auto batch = rowReader.createRowBatch(batchSize);
+      while (rowReader.next(*batch)) {
+        printer->reset(*batch);
+        for (uint64_t row = 0; row < batch->numElements; ++row) {
+          line.clear();
+          printer->printRow(row);
+          rows.push_back(line);
+        }
+      }
+      return rows;
+    }
+
+  }  // namespace
+
+  TEST(TestRowFilter, testMatchesFullRead) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t numRows = 20000;
+    writeRowFilterData(memStream, numRows);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+    ASSERT_GT(reader->getNumberOfStripes(), 1UL);
+    std::vector<std::string> allRows = printRows(*reader->createRowReader(), 1024);
+    ASSERT_EQ(numRows, allRows.size());
+
+    struct TestCase {
+      std::string name;
+      std::function<bool(uint64_t)> keep;
+    };
+    std::vector<TestCase> testCases = {{"sparse", [](uint64_t id) { return id % 97 == 3; }},
+                                       {"runs", [](uint64_t id) { return id % 50 < 20; }},
+                                       {"dense", [](uint64_t id) { return id % 10 != 0; }},
+                                       {"all", [](uint64_t) { return true; }},
+                                       {"range", [](uint64_t id) { return id >= 15000; }}};
+    for (const auto& testCase : testCases) {
+      for (uint32_t decodeThreads : {1u, 3u}) {
+        SCOPED_TRACE(testCase.name + " decodeThreads=" + std::to_string(decodeThreads));
+        auto keep = testCase.keep;
+        RowReaderOptions options;
+        options.setDecodeThreads(decodeThreads)
+            .setRowFilter({"id"}, [keep](const ColumnVectorBatch& batch, char* selected) {
+              const auto& root = dynamic_cast<const StructVectorBatch&>(batch);
+              const auto& ids = dynamic_cast<const LongVectorBatch&>(*root.fields[0]);
+              for (uint64_t row = 0; row < batch.numElements; ++row) {
+                selected[row] = keep(static_cast<uint64_t>(ids.data[row]));
+              }
+            });
+        std::vector<std::string> expected;
+        for (uint64_t row = 0; row < numRows; ++row) {
+          if (keep(row)) {
+            expected.push_back(allRows[row]);
+          }
+        }
+        EXPECT_EQ(expected, printRows(*reader->createRowReader(options), 1024));
+      }
+    }
+  }
+
+  TEST(TestRowFilter, testFilterOnSeveralColumns) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    const uint64_t numRows = 5000;
+    writeRowFilterData(memStream, numRows);
+    auto reader = createReader(
+        std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength()), {});
+    std::vector<std::string> allRows = printRows(*reader->createRowReader(), 1000);
+
+    // select a subset of the columns and filter on a nullable string
+    RowReaderOptions options;
+    options.include(std::list<std::string>{"id", "name", "tags", "flag"})
+        .setRowFilter({"name", "flag"}, [](const ColumnVectorBatch& batch, char* selected) {
+          const auto& root = dynamic_cast<const StructVectorBatch&>(batch);
+          const auto& names = dynamic_cast<const StringVectorBatch&>(*root.fields[1]);
+          const auto& flags = dynamic_cast<const LongVectorBatch&>(*root.fields[3]);
+          for (uint64_t row = 0; row < batch.numElements; ++row) {
+            selected[row] = names.notNull[row] && flags.notNull[row] && flags.data[row] &&
+                            std::string(names.data[row], static_cast<size_t>(names.length[row])) <
+                                "name_5";
+          }
+        });
+    auto rowReader = reader->createRowReader(options);
+    auto batch = rowReader->createRowBatch(1000);
+    uint64_t numSelected = 0;
+    uint64_t expectedSelected = 0;
+    for (uint64_t row = 0; row < numRows; ++row) {
+      if (row % 11 != 0 && row % 5 != 0 && row % 3 == 0 &&
+          "name_" + std::to_string(row * 13 % 101) < "name_5") {
+        ++expectedSelected;
+      }
+    }
+    while (rowReader->next(*batch)) {
+      auto& root = dynamic_cast<StructVectorBatch&>(*batch);
+      auto& ids = dynamic_cast<LongVectorBatch&>(*root.fields[0]);
+      auto& tags = dynamic_cast<ListVectorBatch&>(*root.fields[2]);
+      auto& tagValues = dynamic_cast<LongVectorBatch&>(*tags.elements);
+      for (uint64_t row = 0; row < batch->numElements; ++row, ++numSelected) {
+        uint64_t id = static_cast<uint64_t>(ids.data[row]);
+        EXPECT_EQ(0, id % 3);
+        ASSERT_EQ(id % 4, tags.offsets[row + 1] - tags.offsets[row]);
+        for (int64_t i = tags.offsets[row]; i < tags.offsets[row + 1]; ++i) {
+          EXPECT_EQ(static_cast<int64_t>(id) + i - tags.offsets[row], tagValues.data[i]);
+        }
+      }
+    }
+    EXPECT_EQ(expectedSelected, numSelected);
+    EXPECT_GT(numSelected, 0);
+
+    RowReaderOptions badOptions;
+    badOptions.include(std::list<std::string>{"id"})
+        .setRowFilter({"name"}, [](const ColumnVectorBatch&, char*) {});
+    EXPECT_THROW(reader->createRowReader(badOptions), ParseError);
+  }
+
   /**
    * Test that reading a malformed ORC file with extremely large footer_length
    * throws ParseError instead of causing integer overflow or crash.
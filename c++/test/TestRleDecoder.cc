@@ -18,6 +18,8 @@
 
 #include "Adaptor.hh"
 #include "Compression.hh"
+#include "Dispatch.hh"
+#include "MemoryOutputStream.hh"
 #include "OrcTest.hh"
 #include "RLE.hh"
 #include "wrap/gtest-wrapper.h"
@@ -795,6 +797,52 @@ namespace orc {
     }
   };
 
+  TEST(RLEv2, bitUnpackAllDispatchLevels) {
+    const uint32_t bitWidths[] = {1,  2,  3,  4,  5,  6,  7,  8,  9,  10, 11, 12, 13, 14,
+                                  15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 26, 28, 30, 32};
+    const DispatchLevel levels[] = {DispatchLevel::NONE, DispatchLevel::AVX2,
+                                    DispatchLevel::AVX512};
+    const size_t count = 1000;
+    std::srand(11);
+
+    for (uint32_t bitWidth : bitWidths) {
+      MemoryOutputStream memStream(1024 * 1024);
+      std::unique_ptr<RleEncoder> encoder = createRleEncoder(
+          std::make_unique<BufferedOutputStream>(*getDefaultPool(), &memStream, 500 * 1024, 1024,
+                                                 nullptr),
+          false, RleVersion_2, *getDefaultPool(), true);
+      const int64_t maxValue = static_cast<int64_t>((1ULL << bitWidth) - 1);
+      std::vector<int64_t> values(count);
+      std::vector<char> notNull(count, 1);
+      for (size_t i = 0; i < count; ++i) {
+        values[i] = i % 3 == 0 ? maxValue : std::rand() & maxValue;
+        if (i % 11 == 5) {
+          notNull[i] = 0;
+        }
+      }
+      encoder->add(values.data(), count, notNull.data());
+      encoder->flush();
+
+      for (DispatchLevel level : levels) {
+        setMaxDispatchLevel(level);
+        // Read in odd chunks so that runs are unpacked from unaligned bits,
+        // and from small blocks so that values cross buffer boundaries.
+        for (uint64_t blockSize : {0, 5, 37}) {
+          const auto* bytes = reinterpret_cast<const unsigned char*>(memStream.getData());
+          checkResults(values,
+                       decodeRLEv2(bytes, memStream.getLength(), 7, count, notNull.data(), false,
+                                   blockSize),
+                       7, notNull.data());
+          checkResults(values,
+                       decodeRLEv2(bytes, memStream.getLength(), count, count, notNull.data(),
+                                   false, blockSize),
+                       count, notNull.data());
+        }
+      }
+    }
+    resetMaxDispatchLevel();
+  }
+
   TEST(RLEv1, simpleTest) {
     const unsigned char buffer[] = {0x61, 0xff, 0x64, 0xfb, 0x02, 0x03, 0x5, 0x7, 0xb};
     std::unique_ptr<RleDecoder> rle =
@@ -18,6 +18,7 @@
 
 #include <cstdlib>
 
+#include "Dispatch.hh"
 #include "MemoryOutputStream.hh"
 #include "RLEv1.hh"
 
@@ -323,5 +324,60 @@ namespace orc {
     decodeAndVerify(RleVersion_2, memStream, inputData.data(), numValues, nullptr, isSigned);
   }
 
+  TEST_P(RleTest, RleV2_same_output_at_all_dispatch_levels) {
+    // runs of varying widths, signs and shapes, so that every encoding and
+    // bit width is chosen at least once
+    std::srand(17);
+    std::vector<int64_t> data;
+    for (uint32_t bits = 1; bits < 64; bits += 3) {
+      int64_t mask = static_cast<int64_t>((1ULL << bits) - 1);
+      for (int i = 0; i < 300; ++i) {
+        int64_t value = (static_cast<int64_t>(std::rand()) << 32 | std::rand()) & mask;
+        data.push_back(i % 2 == 0 ? value : -value);
+      }
+      for (int i = 0; i < 300; ++i) {
+        // mostly small values with a few outliers for PATCHED_BASE
+        data.push_back(i % 50 == 7 ? mask : std::rand() % 16);
+      }
+      for (int i = 0; i < 300; ++i) {
+        data.push_back(mask - i * (std::rand() % 5));
+      }
+    }
+    data.push_back(std::numeric_limits<int64_t>::max());
+    data.push_back(std::numeric_limits<int64_t>::min());
+
+    for (bool isSigned : {true, false}) {
+      std::vector<int64_t> values = data;
+      if (!isSigned) {
+        for (int64_t& value : values) {
+          value = value & std::numeric_limits<int64_t>::max();
+        }
+      }
+      std::string expected;
+      for (DispatchLevel level :
+           {DispatchLevel::NONE, DispatchLevel::AVX2, DispatchLevel::AVX512}) {
+        setMaxDispatchLevel(level);
+        MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+        std::unique_ptr<RleEncoder> encoder = getEncoder(RleVersion_2, memStream, isSigned);
+        encoder->add(values.data(), values.size(), nullptr);
+        encoder->flush();
+        std::string output(memStream.getData(), memStream.getLength());
+        if (level == DispatchLevel::NONE) {
+          expected = output;
+          std::unique_ptr<RleDecoder> decoder = createRleDecoder(
+              std::make_unique<SeekableArrayInputStream>(memStream.getData(),
+                                                         memStream.getLength()),
+              isSigned, RleVersion_2, *getDefaultPool(), getDefaultReaderMetrics());
+          std::vector<int64_t> decoded(values.size());
+          decoder->next(decoded.data(), decoded.size(), nullptr);
+          EXPECT_EQ(values, decoded);
+        } else {
+          EXPECT_EQ(expected, output) << "level " << static_cast<int>(level);
+        }
+      }
+    }
+    resetMaxDispatchLevel();
+  }
+
   INSTANTIATE_TEST_SUITE_P(OrcTest, RleTest, Values(true, false));
 }  // namespace orc
@@ -73,14 +73,14 @@ namespace orc {
                     .build();
 
     // prepare row group column statistics
-    std::unordered_map<uint64_t, proto::RowIndex> rowIndexes;
+    std::unordered_map<uint64_t, std::shared_ptr<const proto::RowIndex>> rowIndexes;
     // col 1
     proto::RowIndex rowIndex1;
     *rowIndex1.mutable_entry()->Add()->mutable_statistics() = createIntStats(0L, 10L);
     *rowIndex1.mutable_entry()->Add()->mutable_statistics() = createIntStats(100L, 200L);
     *rowIndex1.mutable_entry()->Add()->mutable_statistics() = createIntStats(300L, 500L);
     *rowIndex1.mutable_entry()->Add()->mutable_statistics() = createIntStats(100L, 100L);
-    rowIndexes[1] = rowIndex1;
+    rowIndexes[1] = std::make_shared<proto::RowIndex>(rowIndex1);
 
     // col 2
     proto::RowIndex rowIndex2;
@@ -88,7 +88,7 @@ namespace orc {
     *rowIndex2.mutable_entry()->Add()->mutable_statistics() = createIntStats(11L, 20L);
     *rowIndex2.mutable_entry()->Add()->mutable_statistics() = createIntStats(10L, 10L);
     *rowIndex2.mutable_entry()->Add()->mutable_statistics() = createIntStats(0L, 100LL);
-    rowIndexes[2] = rowIndex2;
+    rowIndexes[2] = std::make_shared<proto::RowIndex>(rowIndex2);
 
     // evaluate row group index
     ReaderMetrics metrics;
@@ -105,6 +105,43 @@ namespace orc {
     EXPECT_EQ(metrics.EvaluatedRowGroupCount.load(), 4);
   }
 
+  TEST(TestSargsApplier, testPickRowGroupsAcrossStripes) {
+    auto type = std::unique_ptr<Type>(Type::buildTypeFromString("struct<x:int,y:int>"));
+    auto sarg = SearchArgumentFactory::newBuilder()
+                    ->startAnd()
+                    .in("x", PredicateDataType::LONG,
+                        {Literal(static_cast<int64_t>(100)), Literal(static_cast<int64_t>(400))})
+                    .lessThan("y", PredicateDataType::LONG, Literal(static_cast<int64_t>(10)))
+                    .end()
+                    .build();
+
+    proto::RowIndex rowIndex1;
+    *rowIndex1.mutable_entry()->Add()->mutable_statistics() = createIntStats(0L, 10L);
+    *rowIndex1.mutable_entry()->Add()->mutable_statistics() = createIntStats(300L, 500L);
+    proto::RowIndex rowIndex2;
+    *rowIndex2.mutable_entry()->Add()->mutable_statistics() = createIntStats(0L, 9L);
+    *rowIndex2.mutable_entry()->Add()->mutable_statistics() = createIntStats(10L, 20L);
+
+    // the same search argument drives the readers of two files
+    for (int file = 0; file < 2; ++file) {
+      SchemaEvolution se(nullptr, type.get());
+      SargsApplier applier(*type, sarg.get(), 1000, WriterVersion_ORC_135, 0, nullptr, &se);
+
+      std::unordered_map<uint64_t, std::shared_ptr<const proto::RowIndex>> rowIndexes;
+      rowIndexes[1] = std::make_shared<proto::RowIndex>(rowIndex1);
+      rowIndexes[2] = std::make_shared<proto::RowIndex>(rowIndex2);
+      EXPECT_FALSE(applier.pickRowGroups(2000, rowIndexes, {}));
+      EXPECT_EQ(0, applier.getNextSkippedRows()[0]);
+      EXPECT_EQ(0, applier.getNextSkippedRows()[1]);
+
+      // the next stripe has no index for y, so only x can skip row groups
+      rowIndexes.erase(2);
+      EXPECT_TRUE(applier.pickRowGroups(2000, rowIndexes, {}));
+      EXPECT_EQ(0, applier.getNextSkippedRows()[0]);
+      EXPECT_EQ(2000, applier.getNextSkippedRows()[1]);
+    }
+  }
+
   TEST(TestSargsApplier, testStripeAndFileStats) {
     auto type = std::unique_ptr<Type>(Type::buildTypeFromString("struct<x:int,y:int>"));
     auto sarg = SearchArgumentFactory::newBuilder()
@@ -184,4 +221,56 @@ namespace orc {
       EXPECT_EQ(metrics.EvaluatedRowGroupCount.load(), 1);
     }
   }
+
+  TEST(TestSargsApplier, testLazyStripeStats) {
+    auto type = std::unique_ptr<Type>(Type::buildTypeFromString("struct<x:int,y:int>"));
+    auto sarg = SearchArgumentFactory::newBuilder()
+                    ->equals("x", PredicateDataType::LONG, Literal(static_cast<int64_t>(20)))
+                    .build();
+    proto::ColumnStatistics structStatistics;
+    structStatistics.set_has_null(false);
+    proto::Metadata metadata;
+    // stripe 0: 0 <= x <= 10, stripe 1: 0 <= x <= 50
+    for (int64_t maxX : {10L, 50L}) {
+      proto::StripeStatistics* stripeStats = metadata.add_stripe_stats();
+      *stripeStats->add_col_stats() = structStatistics;
+      *stripeStats->add_col_stats() = createIntStats(0L, maxX);
+      *stripeStats->add_col_stats() = createIntStats(0L, 50L);
+    }
+    std::string serialized = metadata.SerializeAsString();
+    // stripe 2: 0 <= x <= 50 and corrupt statistics of y
+    std::string stripe2;
+    for (const auto& colStats : {structStatistics, createIntStats(0L, 50L)}) {
+      std::string bytes = colStats.SerializeAsString();
+      stripe2 += '\x0a' + std::string(1, static_cast<char>(bytes.size())) + bytes;
+    }
+    stripe2 += std::string("\x0a\x02\xff\xff", 4);
+    serialized += '\x0a' + std::string(1, static_cast<char>(stripe2.size())) + stripe2;
+
+    LazyMetadata lazyMetadata(serialized);
+    uint64_t memoryUsage = lazyMetadata.getMemoryUsage();
+    EXPECT_EQ(3, lazyMetadata.getNumberOfStripes());
+    EXPECT_EQ(3, lazyMetadata.getNumberOfColumns(1));
+    // the boundaries of the scanned stripes are counted
+    EXPECT_GT(lazyMetadata.getMemoryUsage(), memoryUsage);
+    memoryUsage = lazyMetadata.getMemoryUsage();
+    EXPECT_EQ(metadata.stripe_stats(1).SerializeAsString(),
+              lazyMetadata.getStripeStatistics(1).SerializeAsString());
+
+    ReaderMetrics metrics;
+    SargsApplier applier(*type, sarg.get(), 1000, WriterVersion_ORC_135, 0, &metrics, nullptr);
+    EXPECT_FALSE(applier.evaluateStripeStatistics(lazyMetadata, 0, 1));
+    EXPECT_TRUE(applier.evaluateStripeStatistics(lazyMetadata, 1, 1));
+    // and so are the decoded statistics
+    EXPECT_GT(lazyMetadata.getMemoryUsage(), memoryUsage);
+    EXPECT_FALSE(applier.mayMatchStripe(lazyMetadata, 0));
+    // only the statistics of x are decoded
+    EXPECT_TRUE(applier.evaluateStripeStatistics(lazyMetadata, 2, 1));
+    EXPECT_EQ(3, metrics.EvaluatedRowGroupCount.load());
+    EXPECT_THROW(lazyMetadata.getStripeStatistics(2), ParseError);
+    EXPECT_THROW(lazyMetadata.getColumnStatistics(2, 2), ParseError);
+
+    EXPECT_THROW(LazyMetadata(std::string("\x0a\x05", 2)), ParseError);
+  }
+
 }  // namespace orc
@@ -344,6 +344,49 @@ namespace orc {
     EXPECT_EQ("PDT", getVariantFromZone(*la, "2100-03-14 10:00:00"));
   }
 
+  TEST(TestTimezone, testVariantRange) {
+    std::unique_ptr<Timezone> la = getTimezone("America/Los_Angeles", decodeBase64(LA_VER2));
+    TimezoneVariantCache cache(*la);
+    // cover the transition table as well as the future rule after it
+    for (int64_t clk = -2000000000; clk < 4200000000; clk += 3989 * 60) {
+      int64_t start;
+      int64_t end;
+      const TimezoneVariant& variant = la->getVariantRange(clk, &start, &end);
+      EXPECT_EQ(&variant, &la->getVariant(clk));
+      ASSERT_LE(start, clk);
+      ASSERT_LT(clk, end);
+      EXPECT_EQ(&variant, &la->getVariant(start));
+      EXPECT_EQ(&variant, &la->getVariant(end - 1));
+      EXPECT_EQ(&variant, &cache.getVariant(clk));
+    }
+  }
+
+  TEST(TestTimezone, testBatchConversion) {
+    std::unique_ptr<Timezone> la = getTimezone("America/Los_Angeles", decodeBase64(LA_VER2));
+    std::vector<int64_t> times;
+    std::vector<char> notNull;
+    // runs of close times around DST changes, in the table and in the future rule
+    for (int64_t base : {INT64_C(1678586399), INT64_C(1699164000), INT64_C(4102444800)}) {
+      for (int64_t delta = -2 * 3600; delta <= 2 * 3600; delta += 599) {
+        times.push_back(base + delta);
+        notNull.push_back(times.size() % 7 != 0);
+      }
+    }
+    std::vector<int64_t> toUTC(times.size());
+    std::vector<int64_t> fromUTC = times;
+    la->convertToUTC(times.data(), toUTC.data(), times.size(), notNull.data());
+    la->convertFromUTC(fromUTC.data(), fromUTC.data(), fromUTC.size(), notNull.data());
+    for (size_t i = 0; i < times.size(); ++i) {
+      if (notNull[i]) {
+        EXPECT_EQ(la->convertToUTC(times[i]), toUTC[i]) << "at " << times[i];
+        EXPECT_EQ(la->convertFromUTC(times[i]), fromUTC[i]) << "at " << times[i];
+      } else {
+        EXPECT_EQ(times[i], toUTC[i]);
+        EXPECT_EQ(times[i], fromUTC[i]);
+      }
+    }
+  }
+
   // FIXME: Temporarily disable the test to make Windows CI happy
   // https://issues.apache.org/jira/projects/ORC/issues/ORC-1976
   TEST(TestTimezone, DISABLED_testZoneCache) {
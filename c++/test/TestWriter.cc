@@ -17,6 +17,7 @@
  */
 
 #include <gtest/gtest.h>
+#include "orc/ColumnPrinter.hh"
 #include "orc/OrcFile.hh"
 
 #include "MemoryInputStream.hh"
@@ -960,6 +961,61 @@ namespace orc {
     }
   }
 
+  TEST_P(WriterTest, writeTimestampWithNulls) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(
+        Type::buildTypeFromString("struct<col1:timestamp with local time zone>"));
+
+    uint64_t stripeSize = 16 * 1024;
+    uint64_t compressionBlockSize = 1024;
+    uint64_t rowCount = 10000;
+    uint64_t memoryBlockSize = 64;
+
+    std::unique_ptr<Writer> writer =
+        createWriter(stripeSize, memoryBlockSize, compressionBlockSize, CompressionKind_ZLIB, *type,
+                     pool, &memStream, fileVersion, enableAlignBlockBoundToRowGroup ? 1024 : 0);
+    std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(rowCount);
+    StructVectorBatch* structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+    TimestampVectorBatch* tsBatch = dynamic_cast<TimestampVectorBatch*>(structBatch->fields[0]);
+
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      tsBatch->notNull[i] = i % 3 != 0;
+      tsBatch->data[i] = static_cast<int64_t>(1000000000 + i * 3660);
+      tsBatch->nanoseconds[i] = static_cast<int64_t>((i * 123456789) % 1000000000);
+    }
+    structBatch->numElements = rowCount;
+    tsBatch->numElements = rowCount;
+    tsBatch->hasNulls = true;
+
+    writer->add(*batch);
+    writer->close();
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    std::unique_ptr<Reader> reader = createReader(pool, std::move(inStream));
+    std::unique_ptr<RowReader> rowReader = createRowReader(reader.get());
+    EXPECT_EQ(rowCount, reader->getNumberOfRows());
+
+    // small batches move the null slots over values decoded by earlier batches
+    const uint64_t batchSize = 10;
+    batch = rowReader->createRowBatch(batchSize);
+    uint64_t row = 0;
+    while (rowReader->next(*batch)) {
+      structBatch = dynamic_cast<StructVectorBatch*>(batch.get());
+      tsBatch = dynamic_cast<TimestampVectorBatch*>(structBatch->fields[0]);
+      for (uint64_t i = 0; i < batch->numElements; ++i, ++row) {
+        EXPECT_EQ(row % 3 != 0, tsBatch->notNull[i]);
+        EXPECT_LE(0, tsBatch->nanoseconds[i]);
+        EXPECT_GT(1000000000, tsBatch->nanoseconds[i]);
+        if (tsBatch->notNull[i]) {
+          EXPECT_EQ(1000000000 + row * 3660, tsBatch->data[i]);
+          EXPECT_EQ((row * 123456789) % 1000000000, tsBatch->nanoseconds[i]);
+        }
+      }
+    }
+    EXPECT_EQ(rowCount, row);
+  }
+
   TEST_P(WriterTest, writeCharAndVarcharColumn) {
     MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
     MemoryPool* pool = getDefaultPool();
@@ -1929,6 +1985,92 @@ namespace orc {
     }
   }
 
+  TEST(WriterTest, testSplitBlockBloomFilter) {
+    WriterOptions options;
+    options.setStripeSize(1024)
+        .setCompressionBlockSize(1024)
+        .setCompression(CompressionKind_ZSTD)
+        .setMemoryPool(getDefaultPool())
+        .setRowIndexStride(1000)
+        .setColumnsUseBloomFilter({1, 2})
+        .setMemoryBlockSize(64)
+        .setBloomFilterVersion(BloomFilterVersion::SPLIT_BLOCK);
+    EXPECT_THROW(WriterOptions().setBloomFilterVersion(BloomFilterVersion::ORIGINAL),
+                 std::invalid_argument);
+    std::stringstream warnings;
+    options.setErrorStream(warnings).setFileVersion(FileVersion::UNSTABLE_PRE_2_0());
+
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    MemoryPool* pool = getDefaultPool();
+    std::unique_ptr<Type> type(Type::buildTypeFromString("struct<c1:bigint,c2:string>"));
+    uint64_t rowCount = 5000;
+    std::vector<std::string> strs(rowCount);
+
+    std::unique_ptr<Writer> writer = createWriter(*type, &memStream, options);
+    std::unique_ptr<ColumnVectorBatch> batch = writer->createRowBatch(rowCount);
+    StructVectorBatch& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    LongVectorBatch& longBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    StringVectorBatch& strBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    for (uint64_t i = 0; i < rowCount; ++i) {
+      // each row group has a unique value, which c1 alternates with 0 so that
+      // the ranges of the row groups overlap
+      int64_t data = static_cast<int64_t>(i / options.getRowIndexStride());
+      longBatch.data[i] = i % 2 == 0 ? 0 : 100 + data;
+      strs[i] = std::to_string(data);
+      strBatch.data[i] = const_cast<char*>(strs[i].c_str());
+      strBatch.length[i] = static_cast<int64_t>(strs[i].size());
+    }
+    structBatch.numElements = longBatch.numElements = strBatch.numElements = rowCount;
+    writer->add(*batch);
+    writer->close();
+
+    // files that other readers open get UTF8 filters
+    MemoryOutputStream stableStream(DEFAULT_MEM_STREAM_SIZE);
+    WriterOptions stableOptions(options);
+    stableOptions.setFileVersion(FileVersion::v_0_12());
+    writer = createWriter(*type, &stableStream, stableOptions);
+    writer->add(*batch);
+    writer->close();
+    std::unique_ptr<Reader> stableReader =
+        createReader(pool, std::make_unique<MemoryInputStream>(stableStream.getData(),
+                                                               stableStream.getLength()));
+    for (auto& bf : stableReader->getBloomFilters(0, {1, 2})) {
+      EXPECT_EQ(BloomFilterVersion::UTF8,
+                dynamic_cast<BloomFilterImpl&>(*bf.second.entries[0]).getVersion());
+    }
+
+    auto inStream = std::make_unique<MemoryInputStream>(memStream.getData(), memStream.getLength());
+    std::unique_ptr<Reader> reader = createReader(pool, std::move(inStream));
+    std::map<uint32_t, BloomFilterIndex> bfs = reader->getBloomFilters(0, {1, 2});
+    EXPECT_EQ(5, bfs[1].entries.size());
+    EXPECT_EQ(5, bfs[2].entries.size());
+    EXPECT_EQ(BloomFilterVersion::SPLIT_BLOCK,
+              dynamic_cast<BloomFilterImpl&>(*bfs[1].entries[0]).getVersion());
+    for (int64_t rg = 0; rg < 5; ++rg) {
+      for (int64_t value = 0; value < 5; ++value) {
+        std::string str = std::to_string(value);
+        EXPECT_EQ(value == rg, bfs[1].entries[rg]->testLong(100 + value));
+        EXPECT_EQ(value == rg, bfs[2].entries[rg]->testBytes(str.c_str(), 1));
+      }
+    }
+
+    // the statistics select the last two row groups and the filters skip the last one
+    RowReaderOptions rowReaderOptions;
+    rowReaderOptions.searchArgument(SearchArgumentFactory::newBuilder()
+                                        ->in("c1", PredicateDataType::LONG,
+                                             {Literal(static_cast<int64_t>(103)),
+                                              Literal(static_cast<int64_t>(50))})
+                                        .build());
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader(rowReaderOptions);
+    batch = rowReader->createRowBatch(rowCount);
+    EXPECT_TRUE(rowReader->next(*batch));
+    EXPECT_EQ(1000, batch->numElements);
+    EXPECT_EQ(103, dynamic_cast<LongVectorBatch&>(
+                       *dynamic_cast<StructVectorBatch&>(*batch).fields[0])
+                       .data[1]);
+    EXPECT_FALSE(rowReader->next(*batch));
+  }
+
   TEST(WriterTest, testSuppressPresentStream) {
     MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
     MemoryPool* pool = getDefaultPool();
@@ -2128,6 +2270,190 @@ namespace orc {
     testSetOutputBufferCapacity(1024 * 1024);
   }
 
+  std::string writeWithWriterThreads(CompressionKind kind, uint32_t compressionThreads,
+                                     uint32_t maxPendingStripes,
+                                     const WriterOptions& baseOptions = WriterOptions()) {
+    MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
+    auto type = std::unique_ptr<Type>(
+        Type::buildTypeFromString("struct<a:bigint,b:string,c:double,d:array<int>>"));
+    WriterOptions options(baseOptions);
+    options.setStripeSize(64 * 1024)
+        .setCompressionBlockSize(1024)
+        .setMemoryBlockSize(256)
+        .setCompression(kind)
+        .setMemoryPool(getDefaultPool())
+        .setRowIndexStride(1000)
+        .setCompressionThreads(compressionThreads)
+        .setMaxPendingStripes(maxPendingStripes);
+    auto writer = createWriter(*type, &memStream, options);
+
+    const uint64_t rowCount = 1000;
+    auto batch = writer->createRowBatch(rowCount);
+    auto& structBatch = dynamic_cast<StructVectorBatch&>(*batch);
+    auto& longBatch = dynamic_cast<LongVectorBatch&>(*structBatch.fields[0]);
+    auto& stringBatch = dynamic_cast<StringVectorBatch&>(*structBatch.fields[1]);
+    auto& doubleBatch = dynamic_cast<DoubleVectorBatch&>(*structBatch.fields[2]);
+    auto& listBatch = dynamic_cast<ListVectorBatch&>(*structBatch.fields[3]);
+    auto& elementBatch = dynamic_cast<LongVectorBatch&>(*listBatch.elements);
+    elementBatch.resize(2 * rowCount);
+    // resize() leaves the null flags of the new elements uninitialized
+    memset(elementBatch.notNull.data(), 1, 2 * rowCount);
+    std::vector<std::string> strings(rowCount);
+    for (uint64_t round = 0; round < 50; ++round) {
+      for (uint64_t i = 0; i < rowCount; ++i) {
+        uint64_t row = round * rowCount + i;
+        longBatch.notNull[i] = row % 7 != 0;
+        longBatch.data[i] = static_cast<int64_t>(row * row);
+        // repetitive in the first row group only, which decides the encoding
+        strings[i] = round == 0 ? std::to_string(row % 97)
+                                : std::to_string(row % 997) + "-" + std::to_string(row);
+        stringBatch.data[i] = const_cast<char*>(strings[i].c_str());
+        stringBatch.length[i] = static_cast<int64_t>(strings[i].size());
+        doubleBatch.data[i] = static_cast<double>(row) / 3;
+        listBatch.offsets[i] = static_cast<int64_t>(2 * i);
+        elementBatch.data[2 * i] = static_cast<int64_t>(row);
+        elementBatch.data[2 * i + 1] = -static_cast<int64_t>(row);
+      }
+      listBatch.offsets[rowCount] = static_cast<int64_t>(2 * rowCount);
+      longBatch.hasNulls = true;
+      structBatch.numElements = longBatch.numElements = stringBatch.numElements =
+          doubleBatch.numElements = listBatch.numElements = rowCount;
+      elementBatch.numElements = 2 * rowCount;
+      writer->add(*batch);
+    }
+    writer->close();
+    return std::string(memStream.getData(), memStream.getLength());
+  }
+
+  TEST(WriterTest, compressionThreadsWriteSameFile) {
+    for (auto kind : {CompressionKind_ZLIB, CompressionKind_ZSTD, CompressionKind_LZ4,
+                      CompressionKind_SNAPPY}) {
+      std::string expected = writeWithWriterThreads(kind, 1, 0);
+      std::string actual = writeWithWriterThreads(kind, 4, 0);
+      EXPECT_EQ(expected, actual) << "compression kind " << kind;
+
+      ReaderOptions readerOptions;
+      std::unique_ptr<Reader> reader = createReader(
+          std::make_unique<MemoryInputStream>(actual.data(), actual.size()), readerOptions);
+      EXPECT_EQ(50000, reader->getNumberOfRows());
+      EXPECT_LT(1, reader->getNumberOfStripes());
+    }
+  }
+
+  TEST(WriterTest, pendingStripesWriteSameFile) {
+    WriterOptions dictionaryOptions;
+    dictionaryOptions.setDictionaryKeySizeThreshold(0.5);
+    for (const WriterOptions& baseOptions : {WriterOptions(), dictionaryOptions}) {
+      std::string expected = writeWithWriterThreads(CompressionKind_ZSTD, 1, 0, baseOptions);
+      for (uint32_t maxPendingStripes : {1, 3}) {
+        EXPECT_EQ(expected,
+                  writeWithWriterThreads(CompressionKind_ZSTD, 1, maxPendingStripes, baseOptions));
+        EXPECT_EQ(expected,
+                  writeWithWriterThreads(CompressionKind_ZSTD, 4, maxPendingStripes, baseOptions));
+      }
+
+      ReaderOptions readerOptions;
+      std::unique_ptr<Reader> reader = createReader(
+          std::make_unique<MemoryInputStream>(expected.data(), expected.size()), readerOptions);
+      // enough stripes for the column writers to be reused
+      EXPECT_LT(4, reader->getNumberOfStripes());
+      EXPECT_EQ(50000, reader->getStatistics()->getColumnStatistics(4)->getNumberOfValues());
+      EXPECT_EQ(100000, reader->getStatistics()->getColumnStatistics(5)->getNumberOfValues());
+      // all stripes keep the encoding picked on the first one
+      ColumnEncodingKind stringEncoding = baseOptions.getEnableDictionary()
+                                              ? ColumnEncodingKind_DICTIONARY_V2
+                                              : ColumnEncodingKind_DIRECT_V2;
+      for (uint64_t i = 0; i < reader->getNumberOfStripes(); ++i) {
+        EXPECT_EQ(stringEncoding, reader->getStripe(i)->getColumnEncoding(2));
+      }
+    }
+  }
+
+  // prints the rows of the file starting at the given row
+  std::string printRows(const std::string& file, uint64_t firstRow) {
+    ReaderOptions readerOptions;
+    std::unique_ptr<Reader> reader = createReader(
+        std::make_unique<MemoryInputStream>(file.data(), file.size()), readerOptions);
+    std::unique_ptr<RowReader> rowReader = reader->createRowReader();
+    rowReader->seekToRow(firstRow);
+    std::string rows;
+    std::string line;
+    std::unique_ptr<ColumnPrinter> printer =
+        createColumnPrinter(line, &rowReader->getSelectedType());
+    auto batch = rowReader->createRowBatch(1000);
+    while (rowReader->next(*batch)) {
+      printer->reset(*batch);
+      for (uint64_t i = 0; i < batch->numElements; ++i) {
+        line.clear();
+        printer->printRow(i);
+        rows += line;
+        rows += "\n";
+      }
+    }
+    return rows;
+  }
+
+  // whether all chunks of the stream in the first stripe are stored uncompressed
+  bool isStoredUncompressed(const std::string& file, uint64_t column, StreamKind kind) {
+    ReaderOptions readerOptions;
+    std::unique_ptr<Reader> reader = createReader(
+        std::make_unique<MemoryInputStream>(file.data(), file.size()), readerOptions);
+    std::unique_ptr<StripeInformation> stripe = reader->getStripe(0);
+    for (uint64_t i = 0; i < stripe->getNumberOfStreams(); ++i) {
+      std::unique_ptr<StreamInformation> stream = stripe->getStreamInformation(i);
+      if (stream->getColumnId() != column || stream->getKind() != kind) {
+        continue;
+      }
+      const auto* chunk = reinterpret_cast<const unsigned char*>(file.data()) + stream->getOffset();
+      const auto* end = chunk + stream->getLength();
+      while (chunk < end) {
+        uint64_t header = chunk[0] | (chunk[1] << 8) | (chunk[2] << 16);
+        if ((header & 1) == 0) {
+          return false;
+        }
+        chunk += 3 + (header >> 1);
+      }
+      return chunk == end;
+    }
+    return false;
+  }
+
+  TEST(WriterTest, columnCompression) {
+    ColumnCompression uncompressed;
+    uncompressed.uncompressed = true;
+    ColumnCompression highLevel;
+    highLevel.level = 9;
+    WriterOptions options;
+    options.setColumnCompression(1, uncompressed)
+        .setColumnCompression(2, highLevel)
+        .setColumnCompression(2, StreamKind_LENGTH, uncompressed);
+    EXPECT_TRUE(options.getColumnCompression(1, StreamKind_PRESENT).uncompressed);
+    EXPECT_TRUE(options.getColumnCompression(2, StreamKind_LENGTH).uncompressed);
+    EXPECT_EQ(9, options.getColumnCompression(2, StreamKind_DATA).level);
+    EXPECT_FALSE(options.getColumnCompression(3, StreamKind_DATA).uncompressed);
+    EXPECT_EQ(0, options.getColumnCompression(3, StreamKind_DATA).level);
+
+    for (auto kind : {CompressionKind_ZLIB, CompressionKind_ZSTD, CompressionKind_LZ4,
+                      CompressionKind_SNAPPY}) {
+      std::string expected = writeWithWriterThreads(kind, 1, 0);
+      std::string actual = writeWithWriterThreads(kind, 1, 0, options);
+      EXPECT_EQ(printRows(expected, 0), printRows(actual, 0)) << "compression kind " << kind;
+      EXPECT_EQ(printRows(expected, 12345), printRows(actual, 12345))
+          << "compression kind " << kind;
+      EXPECT_EQ(actual, writeWithWriterThreads(kind, 4, 1, options)) << "compression kind " << kind;
+      EXPECT_TRUE(isStoredUncompressed(actual, 1, StreamKind_DATA)) << "compression kind " << kind;
+      EXPECT_TRUE(isStoredUncompressed(actual, 2, StreamKind_LENGTH))
+          << "compression kind " << kind;
+      EXPECT_FALSE(isStoredUncompressed(actual, 2, StreamKind_DATA)) << "compression kind " << kind;
+    }
+
+    // out of range levels are rejected when the streams are created
+    highLevel.level = 10;
+    options.setColumnCompression(2, highLevel);
+    EXPECT_THROW(writeWithWriterThreads(CompressionKind_ZLIB, 1, 0, options),
+                 std::invalid_argument);
+  }
+
   TEST_P(WriterTest, testWriteFixedWidthNumericVectorBatch) {
     MemoryOutputStream memStream(DEFAULT_MEM_STREAM_SIZE);
     MemoryPool* pool = getDefaultPool();